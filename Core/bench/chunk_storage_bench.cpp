@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "dynamic_vector.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    struct Row{
+        float data[16];
+    };
+}
+
+// worst single emplace while growing to N rows (the hitch a frame would see)
+template<typename Storage>
+static void BM_DynamicVector_WorstInsert(benchmark::State& state){
+    using clock = std::chrono::steady_clock;
+
+    double worst = 0.0;
+    double total = 0.0;
+    for(auto _: state){
+        basic_dynamic_vector<Storage> vec(sizeof(Row));
+        std::chrono::nanoseconds iterWorst{0};
+        auto begin = clock::now();
+        for(int64_t i=0; i<state.range(0); ++i){
+            auto t0 = clock::now();
+            vec.emplace(Row{{float(i)}});
+            auto t1 = clock::now();
+            iterWorst = std::max(iterWorst, std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0));
+        }
+        total += std::chrono::duration<double, std::nano>(clock::now() - begin).count();
+        worst = std::max(worst, double(iterWorst.count()));
+        benchmark::DoNotOptimize(vec[0]);
+    }
+    state.counters["worst_ns"] = worst;
+    state.counters["avg_ns"] = total / (double(state.iterations()) * state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynamicVector_WorstInsert<contiguous_storage>)
+    ->Arg(1<<16)->Arg(1<<20)->Arg(1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DynamicVector_WorstInsert<paged_storage<>>)
+    ->Arg(1<<16)->Arg(1<<20)->Arg(1<<22)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DynamicVector_WorstInsert<virtual_storage<>>)
+    ->Arg(1<<16)->Arg(1<<20)->Arg(1<<22)->Unit(benchmark::kMillisecond);
+
+// 10M-row pass per storage backend. page-walk cost shows up most in the
+// random pass; with libpfm, add --benchmark_perf_counters=dTLB-load-misses
+namespace
+{
+    constexpr int64_t ROWS = 10'000'000;
+
+    struct Particle{
+        float position[4];
+        float velocity[4];
+    };
+
+    template<typename Storage>
+    void fillParticles(basic_dynamic_vector<Storage>& vec, int64_t count){
+        vec.reserve(count);
+        for(int64_t i=0; i<count; ++i)
+            vec.emplace(Particle{{float(i)}, {1.0f, 2.0f, 3.0f, 0.0f}});
+    }
+}
+
+template<typename Storage>
+static void BM_DynamicVector_Iterate(benchmark::State& state){
+    basic_dynamic_vector<Storage> vec(sizeof(Particle));
+    fillParticles(vec, state.range(0));
+
+    for(auto _: state){
+        for(Index i=0; i<vec.size(); ++i){
+            auto& p = *static_cast<Particle*>(vec[i]);
+            for(int k=0; k<4; ++k)
+                p.position[k] += p.velocity[k] * 0.016f;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Particle));
+}
+BENCHMARK(BM_DynamicVector_Iterate<contiguous_storage>)->Arg(ROWS)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DynamicVector_Iterate<aligned_storage>)->Arg(ROWS)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DynamicVector_Iterate<huge_page_storage>)->Arg(ROWS)->Unit(benchmark::kMillisecond);
+
+template<typename Storage>
+static void BM_DynamicVector_RandomRead(benchmark::State& state){
+    basic_dynamic_vector<Storage> vec(sizeof(Particle));
+    fillParticles(vec, state.range(0));
+    std::vector<uint32_t> order(state.range(0));
+    for(uint32_t i=0; i<order.size(); ++i)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    for(auto _: state){
+        float sum = 0.0f;
+        for(auto i: order)
+            sum += static_cast<const Particle*>(vec[i])->position[0];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DynamicVector_RandomRead<contiguous_storage>)->Arg(ROWS)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DynamicVector_RandomRead<aligned_storage>)->Arg(ROWS)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DynamicVector_RandomRead<huge_page_storage>)->Arg(ROWS)->Unit(benchmark::kMillisecond);
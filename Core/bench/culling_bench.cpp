@@ -0,0 +1,85 @@
+#include <numbers>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "culling.hpp"
+
+using namespace RenderToy;
+
+// a 200k-object scene, roughly a quarter of it on screen
+namespace
+{
+    constexpr size_t COUNT = 200'000;
+
+    Frustum sceneFrustum(){
+        auto proj = perspective(std::numbers::pi_v<float>/2, 16.0f/9.0f, 0.1f, 500.0f);
+        auto view = lookAt(zeros(), -unitZ(), unitY());
+        return extract_frustum(proj * view);
+    }
+    std::vector<AABB> sceneBoxes(){
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.5f, 4.0f);
+        std::vector<AABB> boxes(COUNT);
+        for(auto& box: boxes){
+            Vec3 c{pos(rng), pos(rng)*0.2f, pos(rng)};
+            Vec3 e{size(rng), size(rng), size(rng)};
+            box = AABB{c - e, c + e};
+        }
+        return boxes;
+    }
+}
+
+static void BM_CullAABB_Scalar(benchmark::State& state){
+    auto frustum = sceneFrustum();
+    auto boxes = sceneBoxes();
+    std::vector<uint32_t> visible(COUNT);
+    for(auto _: state){
+        size_t count = 0;
+        for(uint32_t i=0; i<COUNT; ++i)
+            if(intersects(frustum, boxes[i]))
+                visible[count++] = i;
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_CullAABB_Scalar);
+
+static void BM_CullAABB_Batch(benchmark::State& state){
+    auto frustum = sceneFrustum();
+    auto boxes = sceneBoxes();
+    std::vector<uint32_t> visible(COUNT);
+    for(auto _: state){
+        auto count = cull_aabbs(frustum, boxes, visible);
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_CullAABB_Batch);
+
+static void BM_CullSphere_Batch(benchmark::State& state){
+    auto frustum = sceneFrustum();
+    std::vector<BoundingSphere> spheres;
+    for(auto& box: sceneBoxes())
+        spheres.push_back({box.center(), norm(box.extents())});
+    std::vector<uint32_t> visible(COUNT);
+    for(auto _: state){
+        auto count = cull_spheres(frustum, spheres, visible);
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_CullSphere_Batch);
+
+static void BM_TransformAABB(benchmark::State& state){
+    auto boxes = sceneBoxes();
+    auto m = translateMat(Vec3{1, 2, 3}) * rotateYMat(0.5f);
+    std::vector<AABB> out(COUNT);
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = transform_aabb(boxes[i], m);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_TransformAABB);
@@ -0,0 +1,141 @@
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "flat_hash_map.hpp"
+
+using namespace RenderToy;
+
+// Key sets shaped like the engine's tables:
+//   sequential 32-bit entity ids, asset path strings, and archetype
+//   bitmasks (a few of 64 component bits set)
+namespace
+{
+    template<typename K>
+    std::vector<K> makeKeys(size_t count);
+
+    template<>
+    std::vector<uint32_t> makeKeys<uint32_t>(size_t count){
+        std::vector<uint32_t> keys(count);
+        for(size_t i=0; i<count; ++i)
+            keys[i] = uint32_t(i + 1);
+        return keys;
+    }
+    template<>
+    std::vector<std::string> makeKeys<std::string>(size_t count){
+        std::vector<std::string> keys(count);
+        for(size_t i=0; i<count; ++i)
+            keys[i] = "assets/models/props/prop_" + std::to_string(i) + "/mesh.gltf";
+        return keys;
+    }
+    template<>
+    std::vector<uint64_t> makeKeys<uint64_t>(size_t count){
+        std::mt19937_64 rng(1);
+        std::vector<uint64_t> keys;
+        std::unordered_map<uint64_t, int> seen;
+        while(keys.size() < count){
+            uint64_t bits = 1;  // every archetype has the EntityID bit
+            for(int i=0, n=2 + int(rng() % 5); i<n; ++i)
+                bits |= 1ull << (rng() % 64);
+            if(seen.emplace(bits, 0).second)
+                keys.push_back(bits);
+        }
+        return keys;
+    }
+
+    // visit order independent of insertion order
+    std::vector<size_t> shuffledOrder(size_t count){
+        std::vector<size_t> order(count);
+        for(size_t i=0; i<count; ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(2));
+        return order;
+    }
+}
+
+template<typename Map>
+static void BM_FindHit(benchmark::State& state){
+    using K = typename Map::key_type;
+    auto count = size_t(state.range(0));
+    auto keys = makeKeys<K>(count);
+    auto order = shuffledOrder(count);
+    Map map;
+    for(size_t i=0; i<count; ++i)
+        map[keys[i]] = uint32_t(i);
+
+    for(auto _: state)
+        for(auto i: order)
+            benchmark::DoNotOptimize(map.find(keys[i])->second);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<typename Map>
+static void BM_FindMiss(benchmark::State& state){
+    using K = typename Map::key_type;
+    auto count = size_t(state.range(0));
+    auto keys = makeKeys<K>(count*2);
+    Map map;
+    for(size_t i=0; i<count; ++i)
+        map[keys[i]] = uint32_t(i);
+
+    for(auto _: state)
+        for(size_t i=count; i<count*2; ++i)
+            benchmark::DoNotOptimize(map.find(keys[i]) == map.end());
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template<typename Map>
+static void BM_Insert(benchmark::State& state){
+    using K = typename Map::key_type;
+    auto count = size_t(state.range(0));
+    auto keys = makeKeys<K>(count);
+
+    for(auto _: state){
+        Map map;
+        for(size_t i=0; i<count; ++i)
+            map[keys[i]] = uint32_t(i);
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// spawn/despawn: erase the oldest id, insert a new one, steady size
+template<typename Map>
+static void BM_Churn(benchmark::State& state){
+    auto count = size_t(state.range(0));
+    Map map;
+    uint32_t oldest = 1, next = 1;
+    for(; next <= count; ++next)
+        map[next] = next;
+
+    for(auto _: state){
+        map.erase(oldest++);
+        map[next] = next;
+        ++next;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename K>
+using StdMap = std::unordered_map<K, uint32_t>;
+template<typename K>
+using FlatMap = flat_hash_map<K, uint32_t>;
+
+#define MAP_BENCHMARKS(K, RANGE) \
+    BENCHMARK_TEMPLATE(BM_FindHit, StdMap<K>)->RANGE; \
+    BENCHMARK_TEMPLATE(BM_FindHit, FlatMap<K>)->RANGE; \
+    BENCHMARK_TEMPLATE(BM_FindMiss, StdMap<K>)->RANGE; \
+    BENCHMARK_TEMPLATE(BM_FindMiss, FlatMap<K>)->RANGE; \
+    BENCHMARK_TEMPLATE(BM_Insert, StdMap<K>)->RANGE; \
+    BENCHMARK_TEMPLATE(BM_Insert, FlatMap<K>)->RANGE
+
+// EntityID
+MAP_BENCHMARKS(uint32_t, Arg(1'000)->Arg(100'000)->Arg(1'000'000));
+// asset paths
+MAP_BENCHMARKS(std::string, Arg(1'000)->Arg(100'000));
+// ArchetypeBit
+MAP_BENCHMARKS(uint64_t, Arg(64)->Arg(1'000));
+
+BENCHMARK_TEMPLATE(BM_Churn, StdMap<uint32_t>)->Arg(1'000)->Arg(100'000);
+BENCHMARK_TEMPLATE(BM_Churn, FlatMap<uint32_t>)->Arg(1'000)->Arg(100'000);
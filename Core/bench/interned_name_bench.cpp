@@ -0,0 +1,91 @@
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "interned_name.hpp"
+
+using namespace RenderToy;
+
+// 1024 resource paths, looked up in a shuffled order
+namespace
+{
+    constexpr size_t COUNT = 1024;
+
+    std::vector<std::string> paths(){
+        std::vector<std::string> result;
+        for(size_t i=0; i<COUNT; ++i)
+            result.push_back("C:/projects/render_toy/assets/textures/material_" + std::to_string(i) + "_albedo.png");
+        return result;
+    }
+    size_t shuffled(size_t i){
+        return (i*379) % COUNT;
+    }
+}
+
+static void BM_HashString_Std(benchmark::State& state){
+    auto keys = paths();
+    for(auto _: state)
+        for(auto& key: keys)
+            benchmark::DoNotOptimize(std::hash<std::string>{}(key));
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_HashString_Std);
+
+static void BM_HashString_Murmur(benchmark::State& state){
+    auto keys = paths();
+    for(auto _: state)
+        for(auto& key: keys)
+            benchmark::DoNotOptimize(hash_string(key));
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_HashString_Murmur);
+
+static void BM_Lookup_StringMap(benchmark::State& state){
+    auto keys = paths();
+    std::unordered_map<std::string, size_t> map;
+    for(size_t i=0; i<COUNT; ++i)
+        map.emplace(keys[i], i);
+    for(auto _: state)
+        for(size_t i=0; i<COUNT; ++i)
+            benchmark::DoNotOptimize(map.find(keys[shuffled(i)])->second);
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_Lookup_StringMap);
+
+static void BM_Lookup_NameMap_StringView(benchmark::State& state){
+    auto keys = paths();
+    name_map<size_t> map;
+    for(size_t i=0; i<COUNT; ++i)
+        map.emplace(interned_name(keys[i]), i);
+    for(auto _: state)
+        for(size_t i=0; i<COUNT; ++i)
+            benchmark::DoNotOptimize(map.find(std::string_view(keys[shuffled(i)]))->second);
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_Lookup_NameMap_StringView);
+
+static void BM_Lookup_NameMap_Interned(benchmark::State& state){
+    auto keys = paths();
+    name_map<size_t> map;
+    std::vector<interned_name> names;
+    for(size_t i=0; i<COUNT; ++i){
+        names.emplace_back(keys[i]);
+        map.emplace(names.back(), i);
+    }
+    for(auto _: state)
+        for(size_t i=0; i<COUNT; ++i)
+            benchmark::DoNotOptimize(map.find(names[shuffled(i)])->second);
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_Lookup_NameMap_Interned);
+
+static void BM_Intern_Existing(benchmark::State& state){
+    auto keys = paths();
+    for(auto& key: keys)
+        interned_name{key};
+    for(auto _: state)
+        for(size_t i=0; i<COUNT; ++i)
+            benchmark::DoNotOptimize(interned_name(keys[shuffled(i)]));
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_Intern_Existing);
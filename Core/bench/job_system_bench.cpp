@@ -0,0 +1,67 @@
+#include <atomic>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "job_system.hpp"
+
+using namespace RenderToy;
+
+// a million jobs doing next to nothing: measures the scheduler, not the work.
+// range(0) is the pool size: range(0) - 1 workers plus the waiting thread
+namespace
+{
+    constexpr size_t JOB_COUNT = 1'000'000;
+}
+
+static void BM_SubmitTinyJobs(benchmark::State& state){
+    job_system jobs(size_t(state.range(0)) - 1);
+    std::atomic<size_t> sum = 0;
+
+    for(auto _: state){
+        job_counter counter;
+        for(size_t i=0; i<JOB_COUNT; ++i)
+            jobs.submit([&sum, i]{ sum.fetch_add(i, std::memory_order_relaxed); }, &counter);
+        jobs.wait(counter);
+    }
+    benchmark::DoNotOptimize(sum.load());
+    state.SetItemsProcessed(state.iterations() * JOB_COUNT);
+}
+
+// one job per index
+static void BM_ParallelForGrain1(benchmark::State& state){
+    job_system jobs(size_t(state.range(0)) - 1);
+    std::atomic<size_t> sum = 0;
+
+    for(auto _: state){
+        jobs.parallel_for(JOB_COUNT, 1, [&](Index begin, Index){
+            sum.fetch_add(begin, std::memory_order_relaxed);
+        });
+    }
+    benchmark::DoNotOptimize(sum.load());
+    state.SetItemsProcessed(state.iterations() * JOB_COUNT);
+}
+
+// 1000 stages of 1000 jobs, each stage held until the previous one is done
+static void BM_DependentStages(benchmark::State& state){
+    constexpr size_t STAGES = 1000;
+    constexpr size_t WIDTH = JOB_COUNT / STAGES;
+    job_system jobs(size_t(state.range(0)) - 1);
+    std::atomic<size_t> sum = 0;
+
+    for(auto _: state){
+        std::vector<job_counter> stages(STAGES);
+        for(size_t i=0; i<WIDTH; ++i)
+            jobs.submit([&sum]{ sum.fetch_add(1, std::memory_order_relaxed); }, &stages[0]);
+        for(size_t s=1; s<STAGES; ++s)
+            for(size_t i=0; i<WIDTH; ++i)
+                jobs.submit_after(stages[s - 1], [&sum]{ sum.fetch_add(1, std::memory_order_relaxed); }, &stages[s]);
+        jobs.wait(stages.back());
+        for(auto& stage: stages)
+            jobs.wait(stage);
+    }
+    benchmark::DoNotOptimize(sum.load());
+    state.SetItemsProcessed(state.iterations() * JOB_COUNT);
+}
+
+BENCHMARK(BM_SubmitTinyJobs)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelForGrain1)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DependentStages)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,135 @@
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "math_batch.hpp"
+
+using namespace RenderToy;
+
+// batched kernels vs the per-element loop they replace, over a mesh-sized array
+namespace
+{
+    constexpr size_t COUNT = 1 << 20;
+
+    Vec4 randomVec4(std::mt19937& rng){
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        return Vec4{dist(rng), dist(rng), dist(rng), dist(rng)};
+    }
+    std::vector<Vec3> randomPoints(){
+        std::mt19937 rng(1);
+        std::vector<Vec3> points(COUNT);
+        for(auto& p: points)
+            p = asVec3(randomVec4(rng));
+        return points;
+    }
+    std::vector<Vec4> randomQuats(){
+        std::mt19937 rng(2);
+        std::vector<Vec4> quats(COUNT);
+        for(auto& q: quats)
+            q = normalize(randomVec4(rng));
+        return quats;
+    }
+
+    template<typename Fn>
+    void run(benchmark::State& state, Fn&& fn){
+        for(auto _: state){
+            fn();
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * COUNT);
+    }
+}
+
+static void BM_TransformPoints_Loop(benchmark::State& state){
+    auto points = randomPoints();
+    std::vector<Vec3> out(COUNT);
+    auto m = translateMat(Vec3{1, 2, 3}) * rotateYMat(0.5f);
+    run(state, [&]{
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = asVec3(m * asVec4(points[i], 1.0f));
+    });
+}
+BENCHMARK(BM_TransformPoints_Loop);
+
+static void BM_TransformPoints_Batch(benchmark::State& state){
+    auto points = randomPoints();
+    std::vector<Vec3> out(COUNT);
+    auto m = translateMat(Vec3{1, 2, 3}) * rotateYMat(0.5f);
+    run(state, [&]{ transform_points(points, m, out); });
+}
+BENCHMARK(BM_TransformPoints_Batch);
+
+static void BM_QuatToMat_Loop(benchmark::State& state){
+    auto quats = randomQuats();
+    std::vector<Mat4> out(COUNT);
+    run(state, [&]{
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = rotateMat(quats[i]);
+    });
+}
+BENCHMARK(BM_QuatToMat_Loop);
+
+static void BM_QuatToMat_Batch(benchmark::State& state){
+    auto quats = randomQuats();
+    std::vector<Mat4> out(COUNT);
+    run(state, [&]{ quat_to_mat_batch(quats, out); });
+}
+BENCHMARK(BM_QuatToMat_Batch);
+
+static void BM_MulMatrices_Loop(benchmark::State& state){
+    std::vector<Mat4> lhs(COUNT, rotateXMat(0.1f)), rhs(COUNT, translateMat(ones())), out(COUNT);
+    run(state, [&]{
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = detail::mat_mul_scalar(lhs[i], rhs[i]);
+    });
+}
+BENCHMARK(BM_MulMatrices_Loop);
+
+static void BM_MulMatrices_Batch(benchmark::State& state){
+    std::vector<Mat4> lhs(COUNT, rotateXMat(0.1f)), rhs(COUNT, translateMat(ones())), out(COUNT);
+    run(state, [&]{ mul_matrices(lhs, rhs, out); });
+}
+BENCHMARK(BM_MulMatrices_Batch);
+
+static void BM_NormalizeVec3_Loop(benchmark::State& state){
+    auto points = randomPoints();
+    std::vector<Vec3> out(COUNT);
+    run(state, [&]{
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = normalize(points[i]);
+    });
+}
+BENCHMARK(BM_NormalizeVec3_Loop);
+
+static void BM_NormalizeVec3_Batch(benchmark::State& state){
+    auto points = randomPoints();
+    std::vector<Vec3> out(COUNT);
+    run(state, [&]{ normalize_batch(points, out); });
+}
+BENCHMARK(BM_NormalizeVec3_Batch);
+
+static void BM_Bounds_Loop(benchmark::State& state){
+    auto points = randomPoints();
+    run(state, [&]{
+        Vec3 min = points[0], max = points[0];
+        for(auto p: points){
+            for(int axis=0; axis<3; ++axis){
+                min[axis] = std::min(min[axis], p[axis]);
+                max[axis] = std::max(max[axis], p[axis]);
+            }
+        }
+        benchmark::DoNotOptimize(min);
+        benchmark::DoNotOptimize(max);
+    });
+}
+BENCHMARK(BM_Bounds_Loop);
+
+static void BM_Bounds_Batch(benchmark::State& state){
+    auto points = randomPoints();
+    run(state, [&]{
+        Vec3 min = points[0], max = points[0];
+        bounds_batch(points, min, max);
+        benchmark::DoNotOptimize(min);
+        benchmark::DoNotOptimize(max);
+    });
+}
+BENCHMARK(BM_Bounds_Batch);
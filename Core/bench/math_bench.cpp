@@ -0,0 +1,104 @@
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "math.hpp"
+
+using namespace RenderToy;
+
+// a transform-hierarchy sized batch, scalar reference vs runtime (simd) path
+namespace
+{
+    constexpr size_t COUNT = 4096;
+
+    Vec4 randomVec4(std::mt19937& rng){
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        return Vec4{dist(rng), dist(rng), dist(rng), dist(rng)};
+    }
+
+    std::vector<Mat4> randomMatrices(){
+        std::mt19937 rng(1);
+        std::vector<Mat4> mats(COUNT);
+        for(auto& m: mats)
+            m = Mat4{randomVec4(rng), randomVec4(rng), randomVec4(rng), randomVec4(rng)};
+        return mats;
+    }
+    std::vector<Vec4> randomVectors(uint32_t seed){
+        std::mt19937 rng(seed);
+        std::vector<Vec4> vecs(COUNT);
+        for(auto& v: vecs)
+            v = randomVec4(rng);
+        return vecs;
+    }
+
+    Vec4 scalarNormalize(Vec4 v){
+        return v / std::sqrt(norm_squared(v));
+    }
+    Vec3 scalarRotate(Vec3 v, Vec4 q){
+        return asVec3(detail::quat_mul_scalar(
+            detail::quat_mul_scalar(q, asVec4(v)), conjugate(q)));
+    }
+}
+
+template<bool SIMD>
+static void BM_Mat4Multiply(benchmark::State& state){
+    auto parents = randomMatrices();
+    auto locals = randomMatrices();
+    std::vector<Mat4> worlds(COUNT);
+
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i){
+            if constexpr(SIMD)
+                worlds[i] = parents[i] * locals[i];
+            else
+                worlds[i] = detail::mat_mul_scalar(parents[i], locals[i]);
+        }
+        benchmark::DoNotOptimize(worlds.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_Mat4Multiply<false>)->Name("BM_Mat4Multiply/scalar");
+BENCHMARK(BM_Mat4Multiply<true>)->Name("BM_Mat4Multiply/simd");
+
+template<bool SIMD>
+static void BM_QuatRotate(benchmark::State& state){
+    auto quats = randomVectors(2);
+    for(auto& q: quats)
+        q = scalarNormalize(q);
+    auto points = randomVectors(3);
+    std::vector<Vec3> out(COUNT);
+
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i){
+            if constexpr(SIMD)
+                out[i] = rotate(asVec3(points[i]), quats[i]);
+            else
+                out[i] = scalarRotate(asVec3(points[i]), quats[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_QuatRotate<false>)->Name("BM_QuatRotate/scalar");
+BENCHMARK(BM_QuatRotate<true>)->Name("BM_QuatRotate/simd");
+
+template<bool SIMD>
+static void BM_Normalize(benchmark::State& state){
+    auto vecs = randomVectors(4);
+    std::vector<Vec4> out(COUNT);
+
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i){
+            if constexpr(SIMD)
+                out[i] = normalize(vecs[i]);
+            else
+                out[i] = scalarNormalize(vecs[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_Normalize<false>)->Name("BM_Normalize/scalar");
+BENCHMARK(BM_Normalize<true>)->Name("BM_Normalize/simd");
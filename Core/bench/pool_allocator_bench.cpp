@@ -0,0 +1,57 @@
+#include <cstdlib>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "pool_allocator.hpp"
+
+using namespace RenderToy;
+
+// every thread keeps a window of live objects and churns through it,
+// so alloc/free interleave like per-frame pass / system objects do
+namespace
+{
+    constexpr size_t OBJECT_SIZE = 96;
+    constexpr size_t WINDOW = 256;
+    constexpr size_t ROUNDS = 64;
+
+    struct Object{
+        std::byte data[OBJECT_SIZE];
+    };
+
+    template<typename Alloc, typename Free>
+    void churn(benchmark::State& state, Alloc&& alloc, Free&& free){
+        std::vector<void*> window(WINDOW, nullptr);
+        for(auto _: state){
+            for(size_t round=0; round<ROUNDS; ++round){
+                for(auto& ptr: window){
+                    ptr = alloc();
+                    benchmark::DoNotOptimize(ptr);
+                }
+                for(auto ptr: window)
+                    free(ptr);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * WINDOW * ROUNDS);
+    }
+}
+
+static void BM_Alloc_NewDelete(benchmark::State& state){
+    churn(state,
+        []{ return static_cast<void*>(new Object); },
+        [](void* ptr){ delete static_cast<Object*>(ptr); });
+}
+BENCHMARK(BM_Alloc_NewDelete)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_Alloc_Malloc(benchmark::State& state){
+    churn(state,
+        []{ return std::malloc(OBJECT_SIZE); },
+        [](void* ptr){ std::free(ptr); });
+}
+BENCHMARK(BM_Alloc_Malloc)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_Alloc_PoolAllocator(benchmark::State& state){
+    pool_allocator<Object> alloc;
+    churn(state,
+        [&]{ return static_cast<void*>(alloc.allocate(1)); },
+        [&](void* ptr){ alloc.deallocate(static_cast<Object*>(ptr), 1); });
+}
+BENCHMARK(BM_Alloc_PoolAllocator)->ThreadRange(1, 8)->UseRealTime();
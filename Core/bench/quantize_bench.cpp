@@ -0,0 +1,184 @@
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "quantize.hpp"
+
+using namespace RenderToy;
+
+// a 64k-vertex stream, small enough to stay in L2
+namespace
+{
+    constexpr size_t COUNT = 65'536;
+
+    std::vector<float> randomFloats(){
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> floats(COUNT);
+        for(auto& f: floats)
+            f = dist(rng);
+        return floats;
+    }
+    std::vector<Vec3> randomNormals(){
+        std::mt19937 rng(2);
+        std::normal_distribution<float> dist;
+        std::vector<Vec3> normals(COUNT);
+        for(auto& n: normals)
+            n = normalize(Vec3{dist(rng), dist(rng), dist(rng)});
+        return normals;
+    }
+}
+
+static void BM_ToHalf_Scalar(benchmark::State& state){
+    auto in = randomFloats();
+    std::vector<half> out(COUNT);
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = half(in[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_ToHalf_Scalar);
+
+static void BM_ToHalf_Batch(benchmark::State& state){
+    auto in = randomFloats();
+    std::vector<half> out(COUNT);
+    for(auto _: state){
+        to_half_batch(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_ToHalf_Batch);
+
+static void BM_FromHalf_Scalar(benchmark::State& state){
+    auto floats = randomFloats();
+    std::vector<half> in(COUNT);
+    to_half_batch(floats, in);
+    std::vector<float> out(COUNT);
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = float(in[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_FromHalf_Scalar);
+
+static void BM_FromHalf_Batch(benchmark::State& state){
+    auto floats = randomFloats();
+    std::vector<half> in(COUNT);
+    to_half_batch(floats, in);
+    std::vector<float> out(COUNT);
+    for(auto _: state){
+        from_half_batch(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_FromHalf_Batch);
+
+static void BM_ToSnorm16_Scalar(benchmark::State& state){
+    auto in = randomFloats();
+    std::vector<int16_t> out(COUNT);
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = to_snorm<int16_t>(in[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_ToSnorm16_Scalar);
+
+static void BM_ToSnorm16_Batch(benchmark::State& state){
+    auto in = randomFloats();
+    std::vector<int16_t> out(COUNT);
+    for(auto _: state){
+        to_snorm_batch<int16_t>(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_ToSnorm16_Batch);
+
+static void BM_EncodeOctahedral_Scalar(benchmark::State& state){
+    auto in = randomNormals();
+    std::vector<OctNormal> out(COUNT);
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = encode_octahedral(in[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_EncodeOctahedral_Scalar);
+
+static void BM_EncodeOctahedral_Batch(benchmark::State& state){
+    auto in = randomNormals();
+    std::vector<OctNormal> out(COUNT);
+    for(auto _: state){
+        encode_octahedral_batch(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_EncodeOctahedral_Batch);
+
+static void BM_DecodeOctahedral_Scalar(benchmark::State& state){
+    auto normals = randomNormals();
+    std::vector<OctNormal> in(COUNT);
+    encode_octahedral_batch(normals, in);
+    std::vector<Vec3> out(COUNT);
+    for(auto _: state){
+        for(size_t i=0; i<COUNT; ++i)
+            out[i] = decode_octahedral(in[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_DecodeOctahedral_Scalar);
+
+static void BM_DecodeOctahedral_Batch(benchmark::State& state){
+    auto normals = randomNormals();
+    std::vector<OctNormal> in(COUNT);
+    encode_octahedral_batch(normals, in);
+    std::vector<Vec3> out(COUNT);
+    for(auto _: state){
+        decode_octahedral_batch(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_DecodeOctahedral_Batch);
+
+static void BM_PackQuat(benchmark::State& state){
+    std::mt19937 rng(3);
+    std::normal_distribution<float> dist;
+    std::vector<Vec4> in(COUNT);
+    for(auto& q: in)
+        q = normalize(Vec4{dist(rng), dist(rng), dist(rng), dist(rng)});
+    std::vector<PackedQuat> out(COUNT);
+    for(auto _: state){
+        pack_quat_batch(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_PackQuat);
+
+static void BM_UnpackQuat(benchmark::State& state){
+    std::mt19937 rng(3);
+    std::normal_distribution<float> dist;
+    std::vector<Vec4> quats(COUNT);
+    for(auto& q: quats)
+        q = normalize(Vec4{dist(rng), dist(rng), dist(rng), dist(rng)});
+    std::vector<PackedQuat> in(COUNT);
+    pack_quat_batch(quats, in);
+    std::vector<Vec4> out(COUNT);
+    for(auto _: state){
+        unpack_quat_batch(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_UnpackQuat);
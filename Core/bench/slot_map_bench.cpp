@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "dense_slot_map.hpp"
+#include "slot_map.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    struct Payload{
+        float data[8];
+    };
+
+    template<typename Map>
+    auto fill(Map& map, size_t count){
+        std::vector<generic_handle<Payload>> handles;
+        handles.reserve(count);
+        for(size_t i=0; i<count; ++i)
+            handles.push_back(map.push(Payload{{float(i)}}));
+        return handles;
+    }
+
+    // remove every other handle in random order, so sparse layout gets holes
+    template<typename Map>
+    void punchHoles(Map& map, std::vector<generic_handle<Payload>>& handles){
+        std::mt19937 rng(42);
+        std::shuffle(handles.begin(), handles.end(), rng);
+        auto half = handles.size() / 2;
+        for(size_t i=0; i<half; ++i)
+            map.remove(handles[i]);
+        handles.erase(handles.begin(), handles.begin() + half);
+        std::sort(handles.begin(), handles.end(),
+            [](auto lhs, auto rhs){ return lhs.index < rhs.index; });
+    }
+}
+
+static void BM_SlotMap_Iterate(benchmark::State& state){
+    slot_map<Payload> map;
+    auto handles = fill(map, state.range(0));
+    punchHoles(map, handles);
+
+    for(auto _: state){
+        float sum = 0.0f;
+        for(auto handle: handles)
+            sum += map[handle].data[0];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * handles.size());
+}
+BENCHMARK(BM_SlotMap_Iterate)->Range(1<<10, 1<<17);
+
+static void BM_DenseSlotMap_Iterate(benchmark::State& state){
+    dense_slot_map<Payload> map;
+    auto handles = fill(map, state.range(0));
+    punchHoles(map, handles);
+
+    for(auto _: state){
+        float sum = 0.0f;
+        for(const auto& value: map)
+            sum += value.data[0];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * map.size());
+}
+BENCHMARK(BM_DenseSlotMap_Iterate)->Range(1<<10, 1<<17);
+
+static void BM_SlotMap_Insert(benchmark::State& state){
+    for(auto _: state){
+        slot_map<Payload> map;
+        benchmark::DoNotOptimize(fill(map, state.range(0)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SlotMap_Insert)->Range(1<<10, 1<<17);
+
+static void BM_DenseSlotMap_Insert(benchmark::State& state){
+    for(auto _: state){
+        dense_slot_map<Payload> map;
+        benchmark::DoNotOptimize(fill(map, state.range(0)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DenseSlotMap_Insert)->Range(1<<10, 1<<17);
+
+static void BM_SlotMap_Erase(benchmark::State& state){
+    for(auto _: state){
+        state.PauseTiming();
+        slot_map<Payload> map;
+        auto handles = fill(map, state.range(0));
+        std::shuffle(handles.begin(), handles.end(), std::mt19937(42));
+        state.ResumeTiming();
+
+        for(auto handle: handles)
+            map.remove(handle);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SlotMap_Erase)->Range(1<<10, 1<<17);
+
+static void BM_DenseSlotMap_Erase(benchmark::State& state){
+    for(auto _: state){
+        state.PauseTiming();
+        dense_slot_map<Payload> map;
+        auto handles = fill(map, state.range(0));
+        std::shuffle(handles.begin(), handles.end(), std::mt19937(42));
+        state.ResumeTiming();
+
+        for(auto handle: handles)
+            map.remove(handle);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DenseSlotMap_Erase)->Range(1<<10, 1<<17);
+
+// handle resolution: checked operator[] vs try_get vs get_unchecked
+namespace
+{
+    template<typename Map>
+    auto shuffledHandles(Map& map, size_t count){
+        auto handles = fill(map, count);
+        std::shuffle(handles.begin(), handles.end(), std::mt19937(7));
+        return handles;
+    }
+}
+
+static void BM_SlotMap_ResolveChecked(benchmark::State& state){
+    slot_map<Payload> map;
+    auto handles = shuffledHandles(map, state.range(0));
+
+    for(auto _: state){
+        float sum = 0.0f;
+        for(auto handle: handles)
+            sum += map[handle].data[0];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * handles.size());
+}
+BENCHMARK(BM_SlotMap_ResolveChecked)->Arg(1<<10)->Arg(1<<16);
+
+static void BM_SlotMap_ResolveTryGet(benchmark::State& state){
+    slot_map<Payload> map;
+    auto handles = shuffledHandles(map, state.range(0));
+
+    for(auto _: state){
+        float sum = 0.0f;
+        for(auto handle: handles)
+            if(auto ptr = map.try_get(handle))
+                sum += ptr->data[0];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * handles.size());
+}
+BENCHMARK(BM_SlotMap_ResolveTryGet)->Arg(1<<10)->Arg(1<<16);
+
+static void BM_SlotMap_ResolveUnchecked(benchmark::State& state){
+    slot_map<Payload> map;
+    auto handles = shuffledHandles(map, state.range(0));
+
+    for(auto _: state){
+        float sum = 0.0f;
+        for(auto handle: handles)
+            sum += map.get_unchecked(handle).data[0];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * handles.size());
+}
+BENCHMARK(BM_SlotMap_ResolveUnchecked)->Arg(1<<10)->Arg(1<<16);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace RenderToy
+{
+    inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // malloc with power-of-2 alignment, release with aligned_free()
+    inline void* aligned_malloc(size_t size, size_t alignment){
+        // aligned_alloc wants size to be a multiple of alignment
+        auto rounded = (size + alignment - 1) / alignment * alignment;
+        if(rounded == 0)
+            rounded = alignment;
+#if defined(_MSC_VER)
+        return _aligned_malloc(rounded, alignment);
+#else
+        return std::aligned_alloc(alignment, rounded);
+#endif
+    }
+    inline void aligned_free(void* ptr){
+#if defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include "core_types.hpp"
+#include "ptr_util.hpp"
+#include "storage_backend.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #define RENDERTOY_HAS_VIRTUAL_STORAGE 1
+#else
+    #define RENDERTOY_HAS_VIRTUAL_STORAGE 0
+#endif
+
+namespace RenderToy
+{
+    // Byte storage policies, handing out CHUNK_SIZE-byte chunks by index.
+    // stable == true means growth never moves existing chunks.
+
+    // single block, grows by Backend::reallocate (relocates every chunk)
+    template<storage_backend Backend = malloc_backend>
+    class basic_contiguous_storage{
+    private:
+        void* mem = nullptr;
+        const size_t CHUNK_SIZE;
+        size_t cap_ = 0;
+        [[no_unique_address]] Backend backend;
+
+    public:
+        static constexpr bool stable = false;
+        static constexpr size_t alignment = Backend::alignment;
+
+        explicit basic_contiguous_storage(size_t CHUNK_SIZE, Backend backend = {})
+        :CHUNK_SIZE(CHUNK_SIZE), backend(backend){}
+        ~basic_contiguous_storage(){
+            if(mem != nullptr)
+                backend.deallocate(mem, CHUNK_SIZE*cap_);
+        }
+        basic_contiguous_storage(const basic_contiguous_storage&) = delete;
+        basic_contiguous_storage& operator=(const basic_contiguous_storage&) = delete;
+
+        void* at(Index index) const{ return ptrAdd(mem, CHUNK_SIZE*index); }
+        void* data() const{ return mem; }
+        size_t capacity() const{ return cap_; }
+
+        void reserve(size_t new_cap){
+            if(new_cap <= cap_)
+                return;
+
+            if(CHUNK_SIZE != 0){
+                auto new_mem = mem == nullptr ?
+                    backend.allocate(CHUNK_SIZE*new_cap) :
+                    backend.reallocate(mem, CHUNK_SIZE*cap_, CHUNK_SIZE*new_cap);
+                if(new_mem == nullptr)
+                    throw std::runtime_error("realloc failed!");
+                mem = new_mem;
+            }
+            cap_ = new_cap;
+        }
+    };
+
+    using contiguous_storage = basic_contiguous_storage<>;
+    // cache-line aligned block. Rows start every CHUNK_SIZE bytes, so each
+    // row is aligned only if CHUNK_SIZE is a multiple of the alignment
+    using aligned_storage = basic_contiguous_storage<aligned_backend<>>;
+    using huge_page_storage = basic_contiguous_storage<huge_page_backend<>>;
+
+    // fixed-size pages, growth appends a page and never copies
+    template<size_t PAGE_BYTES = 64*1024, storage_backend Backend = malloc_backend>
+    class paged_storage{
+    private:
+        std::vector<void*> pages;
+        const size_t CHUNK_SIZE;
+        // chunks per page is power of 2, so at() is shift + mask
+        const size_t SHIFT;
+        size_t cap_ = 0;
+        [[no_unique_address]] Backend backend;
+
+    public:
+        static constexpr bool stable = true;
+        static constexpr size_t alignment = Backend::alignment;
+
+        explicit paged_storage(size_t CHUNK_SIZE, Backend backend = {})
+        :CHUNK_SIZE(CHUNK_SIZE),
+        SHIFT(std::countr_zero(std::bit_floor(
+            std::max<size_t>(1, PAGE_BYTES / std::max<size_t>(CHUNK_SIZE, 1))
+        ))), backend(backend){}
+        ~paged_storage(){
+            for(auto page: pages)
+                backend.deallocate(page, CHUNK_SIZE << SHIFT);
+        }
+        paged_storage(const paged_storage&) = delete;
+        paged_storage& operator=(const paged_storage&) = delete;
+
+        void* at(Index index) const{
+            return ptrAdd(pages[index >> SHIFT],
+                CHUNK_SIZE*(index & ((size_t(1) << SHIFT) - 1)));
+        }
+        size_t capacity() const{ return cap_; }
+        size_t chunks_per_page() const{ return size_t(1) << SHIFT; }
+
+        void reserve(size_t new_cap){
+            if(CHUNK_SIZE == 0){
+                cap_ = std::max(cap_, new_cap);
+                return;
+            }
+            while(cap_ < new_cap){
+                auto page = backend.allocate(CHUNK_SIZE << SHIFT);
+                if(page == nullptr)
+                    throw std::runtime_error("malloc failed!");
+                pages.push_back(page);
+                cap_ += chunks_per_page();
+            }
+        }
+    };
+
+#if RENDERTOY_HAS_VIRTUAL_STORAGE
+    // reserves RESERVE_BYTES of address space up front and commits
+    // OS pages on demand. contiguous and stable.
+    template<size_t RESERVE_BYTES = size_t(4) << 30>
+    class virtual_storage{
+    private:
+        void* base = nullptr;
+        const size_t CHUNK_SIZE;
+        size_t committed = 0;
+        size_t cap_ = 0;
+
+    public:
+        static constexpr bool stable = true;
+        static constexpr size_t alignment = CACHE_LINE_SIZE;
+
+        explicit virtual_storage(size_t CHUNK_SIZE)
+        :CHUNK_SIZE(CHUNK_SIZE){}
+        ~virtual_storage(){
+            if(base != nullptr)
+                munmap(base, RESERVE_BYTES);
+        }
+        virtual_storage(const virtual_storage&) = delete;
+        virtual_storage& operator=(const virtual_storage&) = delete;
+
+        void* at(Index index) const{ return ptrAdd(base, CHUNK_SIZE*index); }
+        void* data() const{ return base; }
+        size_t capacity() const{ return cap_; }
+
+        void reserve(size_t new_cap){
+            if(new_cap <= cap_)
+                return;
+            if(CHUNK_SIZE == 0){
+                cap_ = new_cap;
+                return;
+            }
+
+            const size_t pageSize = sysconf(_SC_PAGESIZE);
+            auto bytes = (CHUNK_SIZE*new_cap + pageSize - 1) / pageSize * pageSize;
+            if(bytes > RESERVE_BYTES)
+                throw std::length_error("virtual_storage reserve exhausted");
+
+            if(base == nullptr){
+                base = mmap(nullptr, RESERVE_BYTES, PROT_NONE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+                if(base == MAP_FAILED){
+                    base = nullptr;
+                    throw std::runtime_error("mmap reserve failed!");
+                }
+    #if defined(__linux__) && defined(MADV_HUGEPAGE)
+                madvise(base, RESERVE_BYTES, MADV_HUGEPAGE);
+    #endif
+            }
+            if(bytes > committed){
+                if(mprotect(ptrAdd(base, committed), bytes - committed,
+                    PROT_READ | PROT_WRITE) != 0)
+                    throw std::runtime_error("mprotect commit failed!");
+                committed = bytes;
+            }
+            cap_ = committed / CHUNK_SIZE;
+        }
+    };
+#else
+    template<size_t RESERVE_BYTES = size_t(4) << 30>
+    using virtual_storage = paged_storage<>;
+#endif
+
+    // minimal typed vector over a stable byte storage.
+    // elements are constructed in place and never relocated.
+    template<typename U, typename Storage>
+    class stable_vector{
+        static_assert(Storage::stable, "stable_vector requires stable storage");
+
+    private:
+        Storage storage{sizeof(U)};
+        size_t size_ = 0;
+
+    public:
+        stable_vector() = default;
+        ~stable_vector(){
+            for(Index i=0; i<size_; ++i)
+                std::destroy_at(&(*this)[i]);
+        }
+        stable_vector(const stable_vector&) = delete;
+        stable_vector& operator=(const stable_vector&) = delete;
+
+        U& operator[](Index index){ return *std::launder(static_cast<U*>(storage.at(index))); }
+        const U& operator[](Index index) const{ return *std::launder(static_cast<const U*>(storage.at(index))); }
+
+        size_t     size() const{ return size_; }
+        size_t capacity() const{ return storage.capacity(); }
+
+        void reserve(size_t new_cap){ storage.reserve(new_cap); }
+        void resize(size_t new_size){
+            if(new_size > storage.capacity())
+                storage.reserve(std::bit_ceil(new_size));
+            for(Index i=size_; i<new_size; ++i)
+                std::construct_at(static_cast<U*>(storage.at(i)));
+            for(Index i=new_size; i<size_; ++i)
+                std::destroy_at(&(*this)[i]);
+            size_ = new_size;
+        }
+    };
+}
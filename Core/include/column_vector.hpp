@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "aligned_alloc.hpp"
+#include "concepts.hpp"
+#include "core_types.hpp"
+#include "ptr_util.hpp"
+
+namespace RenderToy
+{
+    // Columnar (SoA) counterpart of dynamic_vector.
+    // Each column holds one fixed-size element per row in its own
+    // cache-line aligned block, so a pass over one column streams only that column.
+    // emplace / swap_remove keep every column in sync.
+    class column_vector{
+    private:
+        std::vector<size_t> COLUMN_SIZES;
+        std::vector<void*> columns;
+        size_t size_ = 0;
+        size_t cap_ = 0;
+
+    public:
+        column_vector() = delete;
+        explicit column_vector(std::span<const size_t> columnSizes)
+        :COLUMN_SIZES(columnSizes.begin(), columnSizes.end()),
+        columns(columnSizes.size(), nullptr){}
+        column_vector(std::span<const size_t> columnSizes, size_t initial_cap)
+        :column_vector(columnSizes){
+            reserve(initial_cap);
+        }
+        ~column_vector(){
+            for(auto column: columns)
+                aligned_free(column);
+        }
+
+        column_vector(const column_vector&) = delete;
+        column_vector(column_vector&&) = delete;
+        column_vector& operator=(const column_vector&) = delete;
+        column_vector& operator=(column_vector&&) = delete;
+
+        size_t column_count() const{ return columns.size(); }
+        size_t column_size(Index column) const{ return COLUMN_SIZES[column]; }
+
+        void* column(Index column){ return columns[column]; }
+        const void* column(Index column) const{ return columns[column]; }
+
+        template<typename T>
+        std::span<T> column(Index column){
+            assert(sizeof(T) == COLUMN_SIZES[column] && "column type mismatch");
+            return {static_cast<T*>(columns[column]), size_};
+        }
+        template<typename T>
+        std::span<const T> column(Index column) const{
+            assert(sizeof(T) == COLUMN_SIZES[column] && "column type mismatch");
+            return {static_cast<const T*>(columns[column]), size_};
+        }
+
+        void* at(Index column, Index row){
+            assert(row < size_);
+            return ptrAdd(columns[column], COLUMN_SIZES[column]*row);
+        }
+        const void* at(Index column, Index row) const{
+            assert(row < size_);
+            return ptrAdd(columns[column], COLUMN_SIZES[column]*row);
+        }
+
+        size_t     size() const{ return size_; }
+        size_t capacity() const{ return cap_; }
+        void resize(size_t new_size){
+            if(new_size > capacity()){
+                reserve(std::bit_ceil(new_size));
+            }
+            size_ = new_size;
+        }
+        void reserve(size_t new_cap){
+            if(new_cap <= cap_)
+                return;
+
+            // allocate everything first, so a failure leaves old columns intact
+            std::vector<void*> new_columns(columns.size(), nullptr);
+            for(Index i=0; i<columns.size(); ++i){
+                new_columns[i] = aligned_malloc(COLUMN_SIZES[i]*new_cap, CACHE_LINE_SIZE);
+                if(new_columns[i] == nullptr){
+                    for(auto column: new_columns)
+                        aligned_free(column);
+                    throw std::runtime_error("aligned_malloc failed!");
+                }
+            }
+            for(Index i=0; i<columns.size(); ++i){
+                if(size_ > 0)
+                    std::memcpy(new_columns[i], columns[i], COLUMN_SIZES[i]*size_);
+                aligned_free(columns[i]);
+            }
+            columns = std::move(new_columns);
+            cap_ = new_cap;
+        }
+        void clear(){ size_ = 0; }
+
+        // appends an uninitialized row, returns its index
+        Index emplace_back(){
+            resize(size_ + 1);
+            return size_ - 1;
+        }
+
+        // one value per column, in column order
+        template<all_value... T>
+        Index emplace(T&&... t){
+            static_assert(
+                (std::is_trivially_copyable_v<std::remove_cvref_t<T>> && ...),
+                "Component must be trivially copyable!"
+            );
+            assert(sizeof...(T) == column_count());
+            auto row = emplace_back();
+
+            Index column = 0;
+            ((assert(sizeof(T) == COLUMN_SIZES[column]),
+              ptrCast<std::remove_cvref_t<T>>(at(column++, row)) = std::forward<T>(t)), ...);
+            return row;
+        }
+
+        void swap_remove(Index row){
+            assert(row < size_ && "swap_remove out of range");
+            if(row < size_ - 1){
+                for(Index i=0; i<columns.size(); ++i)
+                    std::memcpy(at(i, row), at(i, size_-1), COLUMN_SIZES[i]);
+            }
+            --size_;
+        }
+    };
+}
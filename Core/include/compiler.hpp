@@ -0,0 +1,12 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #define RENDERTOY_NOINLINE __declspec(noinline)
+    #define RENDERTOY_COLD
+#else
+    #define RENDERTOY_NOINLINE __attribute__((noinline))
+    #define RENDERTOY_COLD __attribute__((cold))
+#endif
+
+// error paths that should stay out of the inlined hot path
+#define RENDERTOY_COLD_PATH RENDERTOY_NOINLINE RENDERTOY_COLD
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "generic_handle.hpp"
+#include "core_types.hpp"
+
+namespace RenderToy
+{
+    // slot_map which can be pushed/removed from many threads.
+    // - storage is paged, so growth never relocates live slots
+    // - free slots form a Treiber stack, head is tagged against ABA
+    // - odd generation means live (same numbering as slot_map)
+    // lookup is wait-free. caller must not remove a handle while
+    // another thread still reads through it.
+    template<typename T, size_t PAGE_SIZE = 1024, size_t MAX_PAGES = 4096>
+    class concurrent_slot_map{
+        static_assert(std::has_single_bit(PAGE_SIZE), "PAGE_SIZE must be power of 2");
+
+    private:
+        using Handle = generic_handle<T>;
+
+        static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t PAGE_SHIFT = std::countr_zero(PAGE_SIZE);
+
+        struct Slot{
+            alignas(T) std::byte storage[sizeof(T)];
+            std::atomic<uint32_t> generation = 0;
+            std::atomic<uint32_t> nextFree = NIL;
+
+            T* get(){ return std::launder(reinterpret_cast<T*>(&storage)); }
+            const T* get() const{ return std::launder(reinterpret_cast<const T*>(&storage)); }
+        };
+        struct Page{
+            Slot slots[PAGE_SIZE];
+        };
+
+        std::array<std::atomic<Page*>, MAX_PAGES> pages{};
+        // [tag:32 | index:32], index NIL means empty
+        std::atomic<uint64_t> freeHead = pack(NIL, 0);
+        std::atomic<uint32_t> nextIndex = 0;
+        std::atomic<size_t> count = 0;
+
+    public:
+        concurrent_slot_map() = default;
+        ~concurrent_slot_map(){
+            auto used = std::min<size_t>(nextIndex.load(), PAGE_SIZE*MAX_PAGES);
+            for(size_t i=0; i<used; ++i){
+                auto& slot = slotAt(i);
+                if(slot.generation.load(std::memory_order_relaxed) & 1)
+                    std::destroy_at(slot.get());
+            }
+            for(auto& page: pages)
+                delete page.load(std::memory_order_relaxed);
+        }
+
+        concurrent_slot_map(const concurrent_slot_map&) = delete;
+        concurrent_slot_map(concurrent_slot_map&&) = delete;
+        concurrent_slot_map& operator=(const concurrent_slot_map&) = delete;
+        concurrent_slot_map& operator=(concurrent_slot_map&&) = delete;
+
+        Handle push(T&& t){
+            auto index = popFree();
+            if(index == NIL)
+                index = grow();
+
+            auto& slot = slotAt(index);
+            std::construct_at(slot.get(), std::move(t));
+            // publish value before generation becomes live
+            auto generation = slot.generation.load(std::memory_order_relaxed) + 1;
+            slot.generation.store(generation, std::memory_order_release);
+            count.fetch_add(1, std::memory_order_relaxed);
+
+            return {
+                .index = index,
+                .generation = generation
+            };
+        }
+
+        template<typename... Args>
+        Handle emplace(Args&&... args){
+            return push(T(std::forward<Args>(args)...));
+        }
+
+        void remove(Handle handle){
+            auto slot = slotOf(handle.index);
+            auto expected = static_cast<uint32_t>(handle.generation);
+
+            // only one remover may retire the slot
+            if( slot == nullptr || !(expected & 1) ||
+                !slot->generation.compare_exchange_strong(expected, expected + 1,
+                    std::memory_order_acq_rel)
+            )
+                throw std::out_of_range(std::format(
+                    "Handle(Index={}) generation {} is mismatched. (valid generation={})",
+                    handle.index, handle.generation,
+                    slot != nullptr ? slot->generation.load() : 0
+                ));
+
+            std::destroy_at(slot->get());
+            count.fetch_sub(1, std::memory_order_relaxed);
+            pushFree(static_cast<uint32_t>(handle.index));
+        }
+
+        // wait-free, nullptr on stale handle
+        T* get(Handle handle){
+            auto slot = slotOf(handle.index);
+            if( slot == nullptr ||
+                slot->generation.load(std::memory_order_acquire) != handle.generation
+            )
+                return nullptr;
+            return slot->get();
+        }
+        const T* get(Handle handle) const{
+            return const_cast<concurrent_slot_map*>(this)->get(handle);
+        }
+        bool contains(Handle handle) const{
+            return get(handle) != nullptr;
+        }
+
+        T& operator[](Handle handle){
+            if(auto ptr = get(handle))
+                return *ptr;
+            throw std::out_of_range(std::format(
+                "Handle(Index={}) generation {} is mismatched.",
+                handle.index, handle.generation
+            ));
+        }
+        const T& operator[](Handle handle) const{
+            return const_cast<concurrent_slot_map&>(*this)[handle];
+        }
+
+        size_t size() const{
+            return count.load(std::memory_order_relaxed);
+        }
+        size_t capacity() const{
+            return std::min<size_t>(nextIndex.load(std::memory_order_relaxed),
+                PAGE_SIZE*MAX_PAGES);
+        }
+
+    private:
+        static constexpr uint64_t pack(uint32_t index, uint32_t tag){
+            return (uint64_t(tag) << 32) | index;
+        }
+        static constexpr uint32_t indexOf(uint64_t head){ return uint32_t(head); }
+        static constexpr uint32_t tagOf(uint64_t head){ return uint32_t(head >> 32); }
+
+        Slot& slotAt(size_t index){
+            auto page = pages[index >> PAGE_SHIFT].load(std::memory_order_acquire);
+            return page->slots[index & (PAGE_SIZE - 1)];
+        }
+        Slot* slotOf(size_t index){
+            if(index >= PAGE_SIZE*MAX_PAGES)
+                return nullptr;
+            auto page = pages[index >> PAGE_SHIFT].load(std::memory_order_acquire);
+            if(page == nullptr)
+                return nullptr;
+            return &page->slots[index & (PAGE_SIZE - 1)];
+        }
+
+        uint32_t grow(){
+            auto index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+            if(index >= PAGE_SIZE*MAX_PAGES)
+                throw std::length_error("concurrent_slot_map capacity exhausted");
+
+            auto& page = pages[index >> PAGE_SHIFT];
+            if(page.load(std::memory_order_acquire) == nullptr){
+                auto fresh = new Page();
+                Page* expected = nullptr;
+                if(!page.compare_exchange_strong(expected, fresh,
+                    std::memory_order_acq_rel))
+                    delete fresh;
+            }
+            return index;
+        }
+
+        uint32_t popFree(){
+            auto head = freeHead.load(std::memory_order_acquire);
+            while(indexOf(head) != NIL){
+                // pages are never freed, so reading nextFree of a stale head is safe
+                auto next = slotAt(indexOf(head)).nextFree.load(std::memory_order_relaxed);
+                if(freeHead.compare_exchange_weak(head, pack(next, tagOf(head) + 1),
+                    std::memory_order_acq_rel, std::memory_order_acquire))
+                    return indexOf(head);
+            }
+            return NIL;
+        }
+        void pushFree(uint32_t index){
+            auto& slot = slotAt(index);
+            auto head = freeHead.load(std::memory_order_relaxed);
+            do{
+                slot.nextFree.store(indexOf(head), std::memory_order_relaxed);
+            } while(!freeHead.compare_exchange_weak(head, pack(index, tagOf(head) + 1),
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+    };
+}
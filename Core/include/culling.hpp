@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include "math.hpp"
+#include "simd.hpp"
+
+namespace RenderToy
+{
+    /// Axis-Aligned Bounding Box
+    struct AABB{
+        Vec3 min = zeros();
+        Vec3 max = zeros();
+
+        constexpr Vec3 center() const{ return (min + max) * 0.5f; }
+        constexpr Vec3 extents() const{ return (max - min) * 0.5f; }
+        constexpr bool isValid() const{ return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+    }; static_assert(std::is_trivially_copyable_v<AABB>);
+
+    struct BoundingSphere{
+        Vec3 center = zeros();
+        float radius = 0.0f;
+    }; static_assert(sizeof(BoundingSphere) == sizeof(Vec4));
+
+    // bounds of the box after m; m is assumed affine.
+    // Arvo's method in center/extents form: c' = M*c, e' = |M|*e
+    inline constexpr AABB transform_aabb(const AABB& box, const Mat4& m){
+        auto c = box.center();
+        auto e = box.extents();
+        Vec3 center, extents;
+        for(int row=0; row<3; ++row){
+            center[row] = m[row][0]*c.x + m[row][1]*c.y + m[row][2]*c.z + m[row][3];
+            extents[row] = std::abs(m[row][0])*e.x + std::abs(m[row][1])*e.y + std::abs(m[row][2])*e.z;
+        }
+        return AABB{center - extents, center + extents};
+    }
+
+    // Planes are (normal, d) with dot(normal, p) + d >= 0 inside,
+    // normalized so plane distances are in world units.
+    struct Frustum{
+        enum Side{ Left, Right, Bottom, Top, Near, Far };
+        static constexpr int PLANE_COUNT = 6;
+        std::array<Vec4, PLANE_COUNT> planes;
+    };
+
+    // Gribb-Hartmann plane extraction from a view-projection matrix.
+    // clip z is expected in [0, w], as produced by perspective().
+    inline Frustum extract_frustum(const Mat4& viewProj){
+        auto r0 = viewProj[0], r1 = viewProj[1], r2 = viewProj[2], r3 = viewProj[3];
+        auto add = [](Vec4 a, Vec4 b){ return Vec4{a.x+b.x, a.y+b.y, a.z+b.z, a.w+b.w}; };
+        auto sub = [](Vec4 a, Vec4 b){ return Vec4{a.x-b.x, a.y-b.y, a.z-b.z, a.w-b.w}; };
+
+        Frustum frustum{{
+            add(r3, r0), sub(r3, r0),
+            add(r3, r1), sub(r3, r1),
+            r2,          sub(r3, r2)
+        }};
+        for(auto& plane: frustum.planes)
+            plane = plane / norm(asVec3(plane));
+        return frustum;
+    }
+
+    inline float plane_distance(Vec4 plane, Vec3 p){
+        return dot(asVec3(plane), p) + plane.w;
+    }
+
+    // conservative: boxes straddling a corner outside two planes count as visible
+    inline bool intersects(const Frustum& frustum, const AABB& box){
+        auto c = box.center();
+        auto e = box.extents();
+        for(auto plane: frustum.planes){
+            auto radius = std::abs(plane.x)*e.x + std::abs(plane.y)*e.y + std::abs(plane.z)*e.z;
+            if(plane_distance(plane, c) + radius < 0.0f)
+                return false;
+        }
+        return true;
+    }
+    inline bool intersects(const Frustum& frustum, const BoundingSphere& sphere){
+        for(auto plane: frustum.planes)
+            if(plane_distance(plane, sphere.center) < -sphere.radius)
+                return false;
+        return true;
+    }
+
+    namespace detail
+    {
+        // per-plane constants, splatted once per cull call
+        struct FrustumLanes{
+            simd::f32x4 nx[Frustum::PLANE_COUNT], ny[Frustum::PLANE_COUNT], nz[Frustum::PLANE_COUNT];
+            simd::f32x4 ax[Frustum::PLANE_COUNT], ay[Frustum::PLANE_COUNT], az[Frustum::PLANE_COUNT];
+            simd::f32x4 d[Frustum::PLANE_COUNT];
+
+            explicit FrustumLanes(const Frustum& frustum){
+                for(int i=0; i<Frustum::PLANE_COUNT; ++i){
+                    auto plane = frustum.planes[i];
+                    nx[i] = simd::splat(plane.x);
+                    ny[i] = simd::splat(plane.y);
+                    nz[i] = simd::splat(plane.z);
+                    ax[i] = simd::splat(std::abs(plane.x));
+                    ay[i] = simd::splat(std::abs(plane.y));
+                    az[i] = simd::splat(std::abs(plane.z));
+                    d[i]  = simd::splat(plane.w);
+                }
+            }
+
+            // smallest signed margin over all planes; negative means culled
+            simd::f32x4 margin(simd::f32x4 cx, simd::f32x4 cy, simd::f32x4 cz,
+                simd::f32x4 ex, simd::f32x4 ey, simd::f32x4 ez) const{
+                using namespace simd;
+                auto plane = [&](int i){
+                    auto dist = madd(nz[i], cz, madd(ny[i], cy, madd(nx[i], cx, d[i])));
+                    auto radius = madd(az[i], ez, madd(ay[i], ey, ax[i]*ex));
+                    return dist + radius;
+                };
+                auto result = plane(0);
+                for(int i=1; i<Frustum::PLANE_COUNT; ++i)
+                    result = simd::min(result, plane(i));
+                return result;
+            }
+        };
+
+        // appends base+k for every lane with a non-negative margin, branch-free
+        inline size_t compact(simd::f32x4 margin, uint32_t base, uint32_t* visible, size_t count){
+            float lanes[4];
+            simd::store(lanes, margin);
+            for(uint32_t k=0; k<4; ++k){
+                visible[count] = base + k;
+                count += lanes[k] >= 0.0f;
+            }
+            return count;
+        }
+    }
+
+    // Writes the indices of boxes touching the frustum to visible, in order,
+    // and returns how many there are. Works on 8 boxes per iteration.
+    // visible must hold at least boxes.size() entries.
+    inline size_t cull_aabbs(const Frustum& frustum, std::span<const AABB> boxes, std::span<uint32_t> visible){
+        assert(visible.size() >= boxes.size());
+        using namespace simd;
+        static_assert(sizeof(AABB) == 2*sizeof(Vec3));
+
+        detail::FrustumLanes lanes(frustum);
+        auto half = splat(0.5f);
+        // boxes as min0 max0 min1 max1 ... packed float3
+        auto src = reinterpret_cast<const float*>(boxes.data());
+        auto block = [&](size_t i, uint32_t* out, size_t count){
+            f32x4 ax, ay, az, bx, by, bz;
+            load3x4(src + 6*i,      ax, ay, az); // min0 max0 min1 max1
+            load3x4(src + 6*i + 12, bx, by, bz); // min2 max2 min3 max3
+            auto minX = shuffle<0, 2, 0, 2>(ax, bx), maxX = shuffle<1, 3, 1, 3>(ax, bx);
+            auto minY = shuffle<0, 2, 0, 2>(ay, by), maxY = shuffle<1, 3, 1, 3>(ay, by);
+            auto minZ = shuffle<0, 2, 0, 2>(az, bz), maxZ = shuffle<1, 3, 1, 3>(az, bz);
+
+            auto margin = lanes.margin(
+                (minX + maxX)*half, (minY + maxY)*half, (minZ + maxZ)*half,
+                (maxX - minX)*half, (maxY - minY)*half, (maxZ - minZ)*half);
+            return detail::compact(margin, uint32_t(i), out, count);
+        };
+
+        size_t count = 0;
+        size_t i = 0;
+        for(; i+8 <= boxes.size(); i += 8){
+            count = block(i, visible.data(), count);
+            count = block(i+4, visible.data(), count);
+        }
+        for(; i+4 <= boxes.size(); i += 4)
+            count = block(i, visible.data(), count);
+        for(; i < boxes.size(); ++i)
+            if(intersects(frustum, boxes[i]))
+                visible[count++] = uint32_t(i);
+        return count;
+    }
+
+    // sphere counterpart of cull_aabbs
+    inline size_t cull_spheres(const Frustum& frustum, std::span<const BoundingSphere> spheres, std::span<uint32_t> visible){
+        assert(visible.size() >= spheres.size());
+        using namespace simd;
+
+        detail::FrustumLanes lanes(frustum);
+        auto zero = splat(0.0f);
+        auto block = [&](size_t i, uint32_t* out, size_t count){
+            auto x = load(&spheres[i].center.x);
+            auto y = load(&spheres[i+1].center.x);
+            auto z = load(&spheres[i+2].center.x);
+            auto r = load(&spheres[i+3].center.x);
+            transpose4(x, y, z, r);
+            // radius in place of the box extents: |n|·0 + r per plane
+            auto margin = lanes.margin(x, y, z, zero, zero, zero) + r;
+            return detail::compact(margin, uint32_t(i), out, count);
+        };
+
+        size_t count = 0;
+        size_t i = 0;
+        for(; i+8 <= spheres.size(); i += 8){
+            count = block(i, visible.data(), count);
+            count = block(i+4, visible.data(), count);
+        }
+        for(; i+4 <= spheres.size(); i += 4)
+            count = block(i, visible.data(), count);
+        for(; i < spheres.size(); ++i)
+            if(intersects(frustum, spheres[i]))
+                visible[count++] = uint32_t(i);
+        return count;
+    }
+}
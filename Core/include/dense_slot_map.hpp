@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cassert>
+#include <format>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "compiler.hpp"
+#include "generic_handle.hpp"
+#include "core_types.hpp"
+
+namespace RenderToy
+{
+    // slot_map variant which keeps live values packed.
+    // handle -> slots[index] -> values[denseIndex], owners[denseIndex] -> slot index
+    // remove() swaps the last value into the hole, so iteration never sees dead slots.
+    template<typename T>
+    class dense_slot_map{
+    private:
+        using Handle = generic_handle<T>;
+
+        struct Slot{
+            Index denseIndex = std::numeric_limits<Index>::max();
+            uint32_t generation = 0;
+        };
+        std::vector<Slot> slots;
+        std::vector<T> values;
+        // owners[i] is slot index of values[i]
+        std::vector<Index> owners;
+        using Indexes = std::vector<Index>;
+        Indexes freeIndexes;
+
+    public:
+        using iterator       = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        dense_slot_map() = default;
+
+        Handle push(T&& t){
+            Index freeIndex = std::numeric_limits<Index>::max();
+
+            if(freeIndexes.size() > 0){
+                freeIndex = freeIndexes.back();
+                freeIndexes.pop_back();
+            }
+            else{
+                slots.emplace_back();
+                freeIndex = slots.size() - 1;
+            }
+
+            auto& slot = slots[freeIndex];
+            slot.denseIndex = values.size();
+            ++slot.generation;
+
+            values.push_back(std::move(t));
+            owners.push_back(freeIndex);
+
+            return {
+                .index = freeIndex,
+                .generation = slot.generation
+            };
+        }
+
+        template<typename... Args>
+        Handle emplace(Args&&... args){
+            return push(T(std::forward<Args>(args)...));
+        }
+
+        void remove(Handle handle){
+            validate(handle);
+
+            auto& slot = slots[handle.index];
+            auto hole = slot.denseIndex;
+            auto last = values.size() - 1;
+
+            if(hole != last){
+                values[hole] = std::move(values[last]);
+                owners[hole] = owners[last];
+                slots[owners[hole]].denseIndex = hole;
+            }
+            values.pop_back();
+            owners.pop_back();
+
+            ++slot.generation;
+            slot.denseIndex = std::numeric_limits<Index>::max();
+            freeIndexes.push_back(handle.index);
+        }
+
+        void clear(){
+            values.clear();
+            owners.clear();
+
+            freeIndexes.clear();
+            for(Index i=0; i<slots.size(); ++i){
+                if(slots[i].denseIndex != std::numeric_limits<Index>::max()){
+                    ++slots[i].generation;
+                    slots[i].denseIndex = std::numeric_limits<Index>::max();
+                }
+                freeIndexes.push_back(i);
+            }
+        }
+
+        bool contains(Handle handle) const{
+            return handle.index < slots.size() &&
+                slots[handle.index].generation == handle.generation &&
+                slots[handle.index].denseIndex != std::numeric_limits<Index>::max();
+        }
+
+        // checked: throws std::out_of_range on stale handle
+        T& operator[](Handle handle){
+            validate(handle);
+            return values[slots[handle.index].denseIndex];
+        }
+        const T& operator[](Handle handle) const{
+            validate(handle);
+            return values[slots[handle.index].denseIndex];
+        }
+
+        // nullptr on stale handle, never throws
+        T* try_get(Handle handle) noexcept{
+            return contains(handle) ? &values[slots[handle.index].denseIndex] : nullptr;
+        }
+        const T* try_get(Handle handle) const noexcept{
+            return contains(handle) ? &values[slots[handle.index].denseIndex] : nullptr;
+        }
+
+        // validated by assert only
+        T& get_unchecked(Handle handle) noexcept{
+            assert(contains(handle) && "stale handle");
+            return values[slots[handle.index].denseIndex];
+        }
+        const T& get_unchecked(Handle handle) const noexcept{
+            assert(contains(handle) && "stale handle");
+            return values[slots[handle.index].denseIndex];
+        }
+
+        // handle of packed value at dense position
+        Handle handle_at(Index denseIndex) const{
+            auto slotIndex = owners[denseIndex];
+            return {
+                .index = slotIndex,
+                .generation = slots[slotIndex].generation
+            };
+        }
+
+        auto  begin()      { return values.begin(); }
+        auto    end()      { return values.end(); }
+        auto  begin() const{ return values.begin(); }
+        auto    end() const{ return values.end(); }
+        auto cbegin() const{ return values.cbegin(); }
+        auto   cend() const{ return values.cend(); }
+
+        std::span<T>             data()      { return values; }
+        std::span<const T>       data() const{ return values; }
+        std::span<const Index> owner() const{ return owners; }
+
+        void reserve(size_t size){
+            values.reserve(size);
+            owners.reserve(size);
+            slots.reserve(size);
+        }
+
+        size_t size() const{
+            return values.size();
+        }
+        size_t capacity() const{
+            return slots.size();
+        }
+
+    private:
+        void validate(Handle handle) const{
+            if(!contains(handle)) [[unlikely]]
+                throwMismatch(handle);
+        }
+        [[noreturn]] RENDERTOY_COLD_PATH
+        void throwMismatch(Handle handle) const{
+            throw std::out_of_range(std::format(
+                "Handle(Index={}) generation {} is mismatched. (valid generation={})",
+                handle.index, handle.generation,
+                handle.index < slots.size() ? slots[handle.index].generation : 0
+            ));
+        }
+    };
+}
@@ -9,6 +9,7 @@
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include "chunk_storage.hpp"
 #include "concepts.hpp"
 #include "core_types.hpp"
 #include "ptr_util.hpp"
@@ -64,118 +65,124 @@ namespace RenderToy
         return (size_t{0} + ... + sizeof(T));
     }
 
-    class dynamic_vector{
+    // Storage decides growth: contiguous_storage (realloc),
+    // paged_storage / virtual_storage (stable chunk address).
+    // Storage::alignment is the alignment of chunk 0; aligned_storage gives cache lines.
+    template<typename Storage = contiguous_storage>
+    class basic_dynamic_vector{
     private:
-        void* mem = nullptr;
+        Storage storage;
         const size_t CHUNK_SIZE;
         size_t size_ = 0;
-        size_t cap_ = 0;
 
     public:
-        dynamic_vector() = delete;
-        ~dynamic_vector(){
-            if(mem != nullptr)
-                free(mem);
+        basic_dynamic_vector() = delete;
+        ~basic_dynamic_vector() = default;
+        basic_dynamic_vector(size_t CHUNK_SIZE)
+        :storage(CHUNK_SIZE), CHUNK_SIZE(CHUNK_SIZE){}
+        basic_dynamic_vector(size_t CHUNK_SIZE, size_t initial_cap)
+        :storage(CHUNK_SIZE), CHUNK_SIZE(CHUNK_SIZE){
+            storage.reserve(initial_cap);
         }
-        dynamic_vector(size_t CHUNK_SIZE)
-        :CHUNK_SIZE(CHUNK_SIZE){}
-        dynamic_vector(size_t CHUNK_SIZE, size_t initial_cap)
-        :CHUNK_SIZE(CHUNK_SIZE), cap_(initial_cap){
-            if(CHUNK_SIZE != 0 && initial_cap != 0)
-                mem = malloc(CHUNK_SIZE*initial_cap);
+        // extra args go to the Storage constructor, e.g. a pmr_backend
+        template<typename Arg, typename... Args>
+        basic_dynamic_vector(size_t CHUNK_SIZE, size_t initial_cap, Arg&& arg, Args&&... args)
+        :storage(CHUNK_SIZE, std::forward<Arg>(arg), std::forward<Args>(args)...), CHUNK_SIZE(CHUNK_SIZE){
+            storage.reserve(initial_cap);
         }
 
-        dynamic_vector(const dynamic_vector&) = delete;
-        dynamic_vector(dynamic_vector&&) = delete;
-        dynamic_vector& operator=(const dynamic_vector&) = delete;
-        dynamic_vector& operator=(dynamic_vector&&) = delete;
+        basic_dynamic_vector(const basic_dynamic_vector&) = delete;
+        basic_dynamic_vector(basic_dynamic_vector&&) = delete;
+        basic_dynamic_vector& operator=(const basic_dynamic_vector&) = delete;
+        basic_dynamic_vector& operator=(basic_dynamic_vector&&) = delete;
 
         class const_iterator;
 
         class iterator{
         private:
-            void* const mem;
+            const Storage* const storage;
             const size_t CHUNK_SIZE;
             Index pos;
 
             friend const_iterator;
 
         public:
-            iterator(void* mem, size_t CHUNK_SIZE, Index pos)
-            :mem(mem), CHUNK_SIZE(CHUNK_SIZE), pos(pos){}
+            iterator(const Storage* storage, size_t CHUNK_SIZE, Index pos)
+            :storage(storage), CHUNK_SIZE(CHUNK_SIZE), pos(pos){}
             iterator(const iterator&) = default;
             iterator(iterator&&) = default;
             iterator& operator=(const iterator&) = delete;
             iterator& operator=(iterator&&) = delete;
 
             void* operator*(){
-                return ptrAdd(mem, CHUNK_SIZE*pos);
+                return storage->at(pos);
             }
             const void* operator*() const{
-                assert((CHUNK_SIZE!=0 || mem != nullptr) && "CHUNK_SIZE==0, intentional crash");
-                return ptrAdd(mem, CHUNK_SIZE*pos);
+                assert(CHUNK_SIZE!=0 && "CHUNK_SIZE==0, intentional crash");
+                return storage->at(pos);
             }
             iterator& operator++(){
                 ++pos;
                 return *this;
             }
             bool operator!=(const iterator& other) const{
-                assert(mem == other.mem);
+                assert(storage == other.storage);
                 return pos != other.pos;
             }
             bool operator==(const iterator& other) const{
-                assert(mem == other.mem);
+                assert(storage == other.storage);
                 return pos == other.pos;
             }
             bool operator!=(const const_iterator& other) const{
-                assert(mem == other.mem);
+                assert(storage == other.storage);
                 return pos != other.pos;
             }
             bool operator==(const const_iterator& other) const{
-                assert(mem == other.mem);
+                assert(storage == other.storage);
                 return pos == other.pos;
             }
         };
         class const_iterator{
         private:
-            void* mem;
+            const Storage* storage;
             size_t CHUNK_SIZE;
             Index pos;
 
             friend iterator;
 
         public:
-            const_iterator(void* mem, size_t CHUNK_SIZE, Index pos){}
+            const_iterator(const Storage* storage, size_t CHUNK_SIZE, Index pos)
+            :storage(storage), CHUNK_SIZE(CHUNK_SIZE), pos(pos){}
             const_iterator(const const_iterator&) = default;
             const_iterator(const_iterator&&) = default;
             const_iterator& operator=(const const_iterator&) = default;
             const_iterator& operator=(const_iterator&&) = default;
 
             const void* operator*(){
-                return ptrAdd(mem, CHUNK_SIZE*pos);
+                return storage->at(pos);
             }
             const void* operator*() const{
-                assert((CHUNK_SIZE!=0 || mem != nullptr) && "CHUNK_SIZE==0, intentional crash");
-                return ptrAdd(mem, CHUNK_SIZE*pos);
+                assert(CHUNK_SIZE!=0 && "CHUNK_SIZE==0, intentional crash");
+                return storage->at(pos);
             }
             const_iterator& operator++(){
                 ++pos;
                 return *this;
             }
             bool operator!=(const const_iterator& other) const{
-                assert(mem == other.mem);
+                assert(storage == other.storage);
                 return pos != other.pos;
             }
             bool operator==(const const_iterator& other) const{
-                assert(mem == other.mem);
+                assert(storage == other.storage);
                 return pos == other.pos;
             }
             bool operator!=(const iterator& other) const{
-                assert(mem == other.mem);
+                assert(storage == other.storage);
                 return pos != other.pos;
             }
             bool operator==(const iterator& other) const{
-                assert(mem == other.mem);
+                assert(storage == other.storage);
                 return pos == other.pos;
             }
         };
@@ -183,40 +190,31 @@ namespace RenderToy
         void* operator[](Index index){
             assert(index < size_);
             assert(!(CHUNK_SIZE==0 && "CHUNK_SIZE==0, intentional crash"));
-            return ptrAdd(mem, CHUNK_SIZE*index);
+            return storage.at(index);
         }
         const void* operator[](Index index) const{
             assert(index < size_);
             assert(!(CHUNK_SIZE==0 && "CHUNK_SIZE==0, intentional crash"));
-            return ptrAdd(mem, CHUNK_SIZE*index);
+            return storage.at(index);
         }
-        auto  begin()      { return       iterator(mem, CHUNK_SIZE,     0); }
-        auto    end()      { return       iterator(mem, CHUNK_SIZE, size_); }
-        auto  begin() const{ return const_iterator(mem, CHUNK_SIZE,     0); }
-        auto    end() const{ return const_iterator(mem, CHUNK_SIZE, size_); }
-        auto cbegin() const{ return const_iterator(mem, CHUNK_SIZE,     0); }
-        auto   cend() const{ return const_iterator(mem, CHUNK_SIZE, size_); }
+        auto  begin()      { return       iterator(&storage, CHUNK_SIZE,     0); }
+        auto    end()      { return       iterator(&storage, CHUNK_SIZE, size_); }
+        auto  begin() const{ return const_iterator(&storage, CHUNK_SIZE,     0); }
+        auto    end() const{ return const_iterator(&storage, CHUNK_SIZE, size_); }
+        auto cbegin() const{ return const_iterator(&storage, CHUNK_SIZE,     0); }
+        auto   cend() const{ return const_iterator(&storage, CHUNK_SIZE, size_); }
 
         size_t     size() const{ return size_; }
-        size_t capacity() const{ return  cap_; }
+        size_t capacity() const{ return storage.capacity(); }
         void resize(size_t new_size){
-            if(new_size > cap_){
+            if(new_size > capacity()){
                 reserve(std::bit_ceil(new_size));
             }
             size_ = new_size;
         }
         void reserve(size_t new_cap){
-            if(new_cap <= cap_)
-                return;
-
-            if(CHUNK_SIZE != 0){
-                auto new_mem = realloc(mem, CHUNK_SIZE*new_cap);
-                if(new_mem == nullptr)
-                    throw std::runtime_error("realloc failed!");
-                mem = new_mem;
-            }
-            cap_ = new_cap;
-            assert(cap_ >= size_);
+            storage.reserve(new_cap);
+            assert(capacity() >= size_);
         }
         void clear(){ size_ = 0; }
 
@@ -230,7 +228,7 @@ namespace RenderToy
             assert(totalSize == CHUNK_SIZE);
             resize(size_ + 1);
 
-            auto dst = ptrAdd(mem, (size_-1)*CHUNK_SIZE);
+            auto dst = storage.at(size_-1);
             RenderToy::emplace(dst, std::forward<T>(t)...);
         }
         template<all_pointer... T>
@@ -244,7 +242,7 @@ namespace RenderToy
             assert(totalSize == CHUNK_SIZE);
             resize(size_ + 1);
 
-            auto dst = ptrAdd(mem, (size_-1)*CHUNK_SIZE);
+            auto dst = storage.at(size_-1);
             RenderToy::emplace(dst, t...);
         }
         template<all_optional... T>
@@ -258,7 +256,7 @@ namespace RenderToy
             assert(totalSize == CHUNK_SIZE);
             resize(size_ + 1);
 
-            auto dst = ptrAdd(mem, (size_-1)*CHUNK_SIZE);
+            auto dst = storage.at(size_-1);
             RenderToy::emplace(dst, std::forward<T>(t)...);
         }
 
@@ -269,4 +267,9 @@ namespace RenderToy
             --size_;
         }
     };
+
+    using dynamic_vector = basic_dynamic_vector<>;
+    using paged_dynamic_vector = basic_dynamic_vector<paged_storage<>>;
+    using aligned_dynamic_vector = basic_dynamic_vector<aligned_storage>;
+    using huge_page_dynamic_vector = basic_dynamic_vector<huge_page_storage>;
 }
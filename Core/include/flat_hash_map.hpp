@@ -0,0 +1,433 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "aligned_alloc.hpp"
+#include "simd.hpp"
+
+namespace RenderToy
+{
+    namespace detail
+    {
+        // 16 control bytes matched at once; bit i of a mask is byte i
+        struct ctrl_group{
+            static constexpr size_t SIZE = 16;
+            static constexpr int8_t EMPTY = -128;
+
+            const int8_t* ctrl;
+
+            uint32_t match(int8_t h2) const{
+#if defined(RENDERTOY_SIMD_SSE)
+                auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+                return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h2))));
+#elif defined(RENDERTOY_SIMD_NEON)
+                auto eq = vceqq_s8(vld1q_s8(ctrl), vdupq_n_s8(h2));
+                return movemask(eq);
+#else
+                uint32_t mask = 0;
+                for(size_t i=0; i<SIZE; ++i)
+                    mask |= uint32_t(ctrl[i] == h2) << i;
+                return mask;
+#endif
+            }
+            // only EMPTY has the sign bit set
+            uint32_t match_empty() const{
+#if defined(RENDERTOY_SIMD_SSE)
+                auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+                return uint32_t(_mm_movemask_epi8(bytes));
+#elif defined(RENDERTOY_SIMD_NEON)
+                return movemask(vcltzq_s8(vld1q_s8(ctrl)));
+#else
+                uint32_t mask = 0;
+                for(size_t i=0; i<SIZE; ++i)
+                    mask |= uint32_t(ctrl[i] < 0) << i;
+                return mask;
+#endif
+            }
+
+#if defined(RENDERTOY_SIMD_NEON)
+        private:
+            static uint32_t movemask(uint8x16_t eq){
+                static constexpr uint8_t WEIGHTS[16] = {1,2,4,8,16,32,64,128, 1,2,4,8,16,32,64,128};
+                auto bits = vandq_u8(eq, vld1q_u8(WEIGHTS));
+                return uint32_t(vaddv_u8(vget_low_u8(bits))) | (uint32_t(vaddv_u8(vget_high_u8(bits))) << 8);
+            }
+#endif
+        };
+    }
+
+    // Open-addressing hash map, std::unordered_map interface subset.
+    // - one control byte per slot: EMPTY or the low 7 bits of the hash,
+    //   probed 16 slots per SIMD compare (the first 15 bytes are mirrored
+    //   past the end, so any slot can start a group)
+    // - linear probing, erase shifts the cluster back: no tombstones, so
+    //   erase-heavy tables never degrade or need a cleanup rehash
+    // - values live inline; insert and erase may move them, which
+    //   invalidates iterators and references (unlike unordered_map)
+    template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class flat_hash_map{
+    public:
+        using key_type        = K;
+        using mapped_type     = V;
+        using value_type      = std::pair<const K, V>;
+        using size_type       = size_t;
+        using hasher          = Hash;
+        using key_equal       = KeyEqual;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+
+    private:
+        using Group = detail::ctrl_group;
+        static constexpr int8_t EMPTY = Group::EMPTY;
+        static constexpr size_t MIN_CAPACITY = Group::SIZE;
+        static constexpr size_t NPOS = size_t(-1);
+
+        template<bool CONST>
+        class basic_iterator{
+        private:
+            using Map = std::conditional_t<CONST, const flat_hash_map, flat_hash_map>;
+            Map* map = nullptr;
+            size_t index = 0;
+
+            friend class flat_hash_map;
+            template<bool>
+            friend class basic_iterator;
+
+            basic_iterator(Map* map, size_t index):map(map), index(index){}
+            void skip_empty(){
+                while(index < map->capacity_ && map->ctrl[index] == EMPTY)
+                    ++index;
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = flat_hash_map::value_type;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::conditional_t<CONST, const value_type&, value_type&>;
+            using pointer           = std::conditional_t<CONST, const value_type*, value_type*>;
+
+            basic_iterator() = default;
+            // iterator -> const_iterator
+            template<bool OTHER> requires (CONST && !OTHER)
+            basic_iterator(const basic_iterator<OTHER>& other):map(other.map), index(other.index){}
+
+            reference operator*() const{ return map->slots[index]; }
+            pointer operator->() const{ return &map->slots[index]; }
+
+            basic_iterator& operator++(){
+                ++index;
+                skip_empty();
+                return *this;
+            }
+            basic_iterator operator++(int){
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            template<bool OTHER>
+            bool operator==(const basic_iterator<OTHER>& other) const{ return index == other.index; }
+        };
+
+    public:
+        using iterator       = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+    private:
+        value_type* slots = nullptr;
+        int8_t* ctrl = nullptr;
+        size_t capacity_ = 0;
+        size_t size_ = 0;
+        [[no_unique_address]] Hash hash_;
+        [[no_unique_address]] KeyEqual equal_;
+
+    public:
+        flat_hash_map() = default;
+        explicit flat_hash_map(size_t count){ reserve(count); }
+        flat_hash_map(std::initializer_list<value_type> init){
+            reserve(init.size());
+            for(auto& value: init)
+                insert(value);
+        }
+        ~flat_hash_map(){
+            destroy_all();
+            release(slots);
+        }
+
+        flat_hash_map(const flat_hash_map& other)
+        :hash_(other.hash_), equal_(other.equal_){
+            reserve(other.size_);
+            for(auto& value: other)
+                insert(value);
+        }
+        flat_hash_map(flat_hash_map&& other) noexcept
+        :slots(std::exchange(other.slots, nullptr)), ctrl(std::exchange(other.ctrl, nullptr)),
+         capacity_(std::exchange(other.capacity_, 0)), size_(std::exchange(other.size_, 0)),
+         hash_(std::move(other.hash_)), equal_(std::move(other.equal_)){}
+        flat_hash_map& operator=(const flat_hash_map& other){
+            if(this != &other){
+                flat_hash_map copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+        flat_hash_map& operator=(flat_hash_map&& other) noexcept{
+            flat_hash_map moved(std::move(other));
+            swap(moved);
+            return *this;
+        }
+
+        void swap(flat_hash_map& other) noexcept{
+            std::swap(slots, other.slots);
+            std::swap(ctrl, other.ctrl);
+            std::swap(capacity_, other.capacity_);
+            std::swap(size_, other.size_);
+            std::swap(hash_, other.hash_);
+            std::swap(equal_, other.equal_);
+        }
+
+        iterator begin(){ return first_from(0); }
+        iterator end(){ return iterator(this, capacity_); }
+        const_iterator begin() const{ return first_from(0); }
+        const_iterator end() const{ return const_iterator(this, capacity_); }
+        const_iterator cbegin() const{ return begin(); }
+        const_iterator cend() const{ return end(); }
+
+        size_t size() const{ return size_; }
+        bool empty() const{ return size_ == 0; }
+        size_t capacity() const{ return capacity_; }
+
+        void clear(){
+            destroy_all();
+            if(ctrl)
+                std::memset(ctrl, EMPTY, capacity_ + Group::SIZE - 1);
+            size_ = 0;
+        }
+        // room for count elements without rehashing
+        void reserve(size_t count){
+            auto needed = std::bit_ceil(std::max(MIN_CAPACITY, count + count/7 + 1));
+            if(needed > capacity_)
+                rehash(needed);
+        }
+
+        // K-typed lookups; Q-typed ones need transparent Hash and KeyEqual
+        iterator find(const K& key){ return iterator(this, index_or_end(key)); }
+        const_iterator find(const K& key) const{ return const_iterator(this, index_or_end(key)); }
+        template<typename Q> requires requires{ typename Hash::is_transparent; typename KeyEqual::is_transparent; }
+        iterator find(const Q& key){ return iterator(this, index_or_end(key)); }
+        template<typename Q> requires requires{ typename Hash::is_transparent; typename KeyEqual::is_transparent; }
+        const_iterator find(const Q& key) const{ return const_iterator(this, index_or_end(key)); }
+
+        bool contains(const K& key) const{ return find_index(key, hash_of(key)) != NPOS; }
+        size_t count(const K& key) const{ return contains(key) ? 1 : 0; }
+
+        V& at(const K& key){
+            auto index = find_index(key, hash_of(key));
+            if(index == NPOS)
+                throw std::out_of_range("flat_hash_map::at: key not found");
+            return slots[index].second;
+        }
+        const V& at(const K& key) const{
+            auto index = find_index(key, hash_of(key));
+            if(index == NPOS)
+                throw std::out_of_range("flat_hash_map::at: key not found");
+            return slots[index].second;
+        }
+        V& operator[](const K& key){ return try_emplace(key).first->second; }
+        V& operator[](K&& key){ return try_emplace(std::move(key)).first->second; }
+
+        template<typename Key, typename... Args>
+        std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args){
+            auto hash = hash_of(key);
+            if(auto index = find_index(key, hash); index != NPOS)
+                return {iterator(this, index), false};
+
+            auto index = prepare_insert(hash);
+            std::construct_at(&slots[index], std::piecewise_construct,
+                std::forward_as_tuple(std::forward<Key>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+            commit_insert(index, hash);
+            return {iterator(this, index), true};
+        }
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... args){
+            value_type value(std::forward<Args>(args)...);
+            return insert(std::move(value));
+        }
+        std::pair<iterator, bool> insert(const value_type& value){
+            return try_emplace(value.first, value.second);
+        }
+        std::pair<iterator, bool> insert(value_type&& value){
+            return try_emplace(value.first, std::move(value.second));
+        }
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const K& key, M&& mapped){
+            auto [it, inserted] = try_emplace(key, std::forward<M>(mapped));
+            if(!inserted)
+                it->second = std::forward<M>(mapped);
+            return {it, inserted};
+        }
+
+        size_t erase(const K& key){
+            auto index = find_index(key, hash_of(key));
+            if(index == NPOS)
+                return 0;
+            erase_at(index);
+            return 1;
+        }
+        // the slot is refilled by the shifted cluster, so iteration resumes
+        // there. an element wrapped from the table front may be visited twice.
+        iterator erase(const_iterator pos){
+            auto index = pos.index;
+            erase_at(index);
+            return first_from(index);
+        }
+        iterator erase(iterator pos){ return erase(const_iterator(pos)); }
+
+    private:
+        // spread the user hash: H1 picks the start slot, H2 is the control byte
+        uint64_t hash_of(const auto& key) const{
+            auto x = uint64_t(hash_(key)) * 0x9E3779B97F4A7C15ull;
+            return x ^ (x >> 32);
+        }
+        static size_t H1(uint64_t hash){ return size_t(hash >> 7); }
+        static int8_t H2(uint64_t hash){ return int8_t(hash & 0x7F); }
+        size_t mask() const{ return capacity_ - 1; }
+
+        // max load 7/8
+        static size_t max_size_for(size_t capacity){ return capacity - capacity/8; }
+
+        template<typename Q>
+        size_t find_index(const Q& key, uint64_t hash) const{
+            if(capacity_ == 0)
+                return NPOS;
+            auto h2 = H2(hash);
+            auto pos = H1(hash) & mask();
+            while(true){
+                Group group{ctrl + pos};
+                for(auto bits = group.match(h2); bits != 0; bits &= bits - 1){
+                    auto index = (pos + std::countr_zero(bits)) & mask();
+                    if(equal_(slots[index].first, key)) [[likely]]
+                        return index;
+                }
+                // a cluster never spans an empty slot
+                if(group.match_empty() != 0)
+                    return NPOS;
+                pos = (pos + Group::SIZE) & mask();
+            }
+        }
+        template<typename Q>
+        size_t index_or_end(const Q& key) const{
+            auto index = find_index(key, hash_of(key));
+            return index == NPOS ? capacity_ : index;
+        }
+
+        size_t find_empty(uint64_t hash) const{
+            auto pos = H1(hash) & mask();
+            while(true){
+                if(auto bits = Group{ctrl + pos}.match_empty(); bits != 0)
+                    return (pos + std::countr_zero(bits)) & mask();
+                pos = (pos + Group::SIZE) & mask();
+            }
+        }
+        size_t prepare_insert(uint64_t hash){
+            if(size_ + 1 > max_size_for(capacity_))
+                rehash(capacity_ == 0 ? MIN_CAPACITY : capacity_*2);
+            return find_empty(hash);
+        }
+        void commit_insert(size_t index, uint64_t hash){
+            set_ctrl(index, H2(hash));
+            ++size_;
+        }
+
+        void set_ctrl(size_t index, int8_t value){
+            ctrl[index] = value;
+            if(index < Group::SIZE - 1)
+                ctrl[capacity_ + index] = value;
+        }
+
+        void erase_at(size_t index){
+            std::destroy_at(&slots[index]);
+            // backward shift (Knuth 6.4 algorithm R): pull every later member
+            // of the cluster whose home is not after the hole into the hole
+            auto hole = index;
+            for(auto next = (index + 1) & mask(); ctrl[next] != EMPTY; next = (next + 1) & mask()){
+                auto home = H1(hash_of(slots[next].first)) & mask();
+                if(((next - home) & mask()) >= ((next - hole) & mask())){
+                    relocate(next, hole);
+                    set_ctrl(hole, ctrl[next]);
+                    hole = next;
+                }
+            }
+            set_ctrl(hole, EMPTY);
+            --size_;
+        }
+        void relocate(size_t from, size_t to){
+            std::construct_at(&slots[to], std::move(slots[from]));
+            std::destroy_at(&slots[from]);
+        }
+
+        void rehash(size_t newCapacity){
+            auto oldSlots = slots;
+            auto oldCtrl = ctrl;
+            auto oldCapacity = capacity_;
+
+            allocate(newCapacity);
+            for(size_t i=0; i<oldCapacity; ++i){
+                if(oldCtrl[i] == EMPTY)
+                    continue;
+                auto hash = hash_of(oldSlots[i].first);
+                auto index = find_empty(hash);
+                std::construct_at(&slots[index], std::move(oldSlots[i]));
+                std::destroy_at(&oldSlots[i]);
+                set_ctrl(index, H2(hash));
+            }
+            release(oldSlots);
+        }
+
+        // one block: slots, then capacity + 15 control bytes
+        void allocate(size_t capacity){
+            auto slotBytes = capacity * sizeof(value_type);
+            auto mem = static_cast<std::byte*>(aligned_malloc(
+                slotBytes + capacity + Group::SIZE - 1, std::max(alignof(value_type), Group::SIZE)));
+            if(mem == nullptr)
+                throw std::bad_alloc();
+            slots = reinterpret_cast<value_type*>(mem);
+            ctrl = reinterpret_cast<int8_t*>(mem + slotBytes);
+            capacity_ = capacity;
+            std::memset(ctrl, EMPTY, capacity + Group::SIZE - 1);
+        }
+        static void release(value_type* mem){
+            if(mem)
+                aligned_free(mem);
+        }
+        void destroy_all(){
+            if constexpr(!std::is_trivially_destructible_v<value_type>){
+                for(size_t i=0; i<capacity_; ++i)
+                    if(ctrl[i] != EMPTY)
+                        std::destroy_at(&slots[i]);
+            }
+        }
+
+        iterator first_from(size_t index){
+            iterator it(this, index);
+            it.skip_empty();
+            return it;
+        }
+        const_iterator first_from(size_t index) const{
+            const_iterator it(this, index);
+            it.skip_empty();
+            return it;
+        }
+    };
+}
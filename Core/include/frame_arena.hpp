@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "aligned_alloc.hpp"
+#include "core_types.hpp"
+
+namespace RenderToy
+{
+    // Bump allocator for per-frame scratch memory.
+    // allocate() moves a cursor, reset() rewinds it; nothing is freed one by one
+    // and destructors never run. If a frame overflows the block, extra blocks are
+    // chained and merged into one on reset(), so steady-state frames never hit the heap.
+    class frame_arena{
+    private:
+        class arena_resource final: public std::pmr::memory_resource{
+        private:
+            frame_arena* arena;
+
+        public:
+            explicit arena_resource(frame_arena* arena):arena(arena){}
+
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override{
+                return arena->allocate(bytes, alignment);
+            }
+            void do_deallocate(void*, size_t, size_t) override{}
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+                return this == &other;
+            }
+        };
+
+        struct Block{
+            void* mem;
+            size_t size;
+        };
+        std::vector<Block> blocks;
+        uintptr_t cursor = 0;
+        uintptr_t limit = 0;
+        // bytes handed out by blocks before the last one
+        size_t retired = 0;
+        const size_t BLOCK_SIZE;
+        arena_resource adapter{this};
+
+    public:
+        explicit frame_arena(size_t BLOCK_SIZE = 64*1024)
+        :BLOCK_SIZE(BLOCK_SIZE){}
+        ~frame_arena(){
+            for(auto block: blocks)
+                aligned_free(block.mem);
+        }
+        frame_arena(const frame_arena&) = delete;
+        frame_arena(frame_arena&&) = delete;
+        frame_arena& operator=(const frame_arena&) = delete;
+        frame_arena& operator=(frame_arena&&) = delete;
+
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)){
+            assert(std::has_single_bit(alignment));
+            auto ptr = (cursor + alignment - 1) & ~(uintptr_t(alignment) - 1);
+            if(ptr + bytes > limit || blocks.empty()) [[unlikely]]
+                return grow(bytes, alignment);
+
+            cursor = ptr + bytes;
+            return reinterpret_cast<void*>(ptr);
+        }
+
+        template<typename T, typename... Args>
+        T* make(Args&&... args){
+            static_assert(std::is_trivially_destructible_v<T>, "frame_arena never runs destructors");
+            return std::construct_at(static_cast<T*>(allocate(sizeof(T), alignof(T))),
+                std::forward<Args>(args)...);
+        }
+        // value-initialized array
+        template<typename T>
+        std::span<T> make_array(size_t count){
+            static_assert(std::is_trivially_destructible_v<T>, "frame_arena never runs destructors");
+            auto ptr = static_cast<T*>(allocate(sizeof(T)*count, alignof(T)));
+            std::uninitialized_value_construct_n(ptr, count);
+            return {ptr, count};
+        }
+
+        // invalidates everything allocated since the last reset
+        void reset(){
+            if(blocks.size() > 1){
+                size_t total = 0;
+                for(auto block: blocks){
+                    total += block.size;
+                    aligned_free(block.mem);
+                }
+                blocks.clear();
+                pushBlock(total);
+            }
+            else if(!blocks.empty()){
+                cursor = reinterpret_cast<uintptr_t>(blocks.front().mem);
+            }
+            retired = 0;
+        }
+
+        size_t used() const{
+            return blocks.empty() ? 0 :
+                retired + (cursor - reinterpret_cast<uintptr_t>(blocks.back().mem));
+        }
+        size_t capacity() const{
+            size_t total = 0;
+            for(auto block: blocks)
+                total += block.size;
+            return total;
+        }
+
+        // deallocate() is a no-op; memory comes back on reset()
+        std::pmr::memory_resource* resource(){ return &adapter; }
+
+    private:
+        void* grow(size_t bytes, size_t alignment){
+            if(!blocks.empty())
+                retired += cursor - reinterpret_cast<uintptr_t>(blocks.back().mem);
+
+            auto last = blocks.empty() ? size_t(0) : blocks.back().size;
+            pushBlock(std::max({BLOCK_SIZE, last*2, bytes + alignment}));
+            return allocate(bytes, alignment);
+        }
+        void pushBlock(size_t size){
+            auto mem = aligned_malloc(size, CACHE_LINE_SIZE);
+            if(mem == nullptr)
+                throw std::bad_alloc();
+            blocks.push_back({mem, size});
+            cursor = reinterpret_cast<uintptr_t>(mem);
+            limit = cursor + size;
+        }
+    };
+
+    // one frame_arena per thread which touches it.
+    // local() is safe from any thread; reset() only while no thread allocates.
+    class threaded_frame_arena{
+    private:
+        std::vector<std::unique_ptr<frame_arena>> arenas;
+        std::mutex mtx;
+        const size_t BLOCK_SIZE;
+        // never reused, so stale thread caches can't alias a new arena
+        const uint64_t id = nextId();
+
+    public:
+        explicit threaded_frame_arena(size_t BLOCK_SIZE = 64*1024)
+        :BLOCK_SIZE(BLOCK_SIZE){}
+        threaded_frame_arena(const threaded_frame_arena&) = delete;
+        threaded_frame_arena& operator=(const threaded_frame_arena&) = delete;
+
+        frame_arena& local(){
+            thread_local std::vector<std::pair<uint64_t, frame_arena*>> cache;
+            for(auto [owner, arena]: cache)
+                if(owner == id)
+                    return *arena;
+
+            std::lock_guard lock(mtx);
+            auto& arena = arenas.emplace_back(std::make_unique<frame_arena>(BLOCK_SIZE));
+            cache.emplace_back(id, arena.get());
+            return *arena;
+        }
+
+        void reset(){
+            std::lock_guard lock(mtx);
+            for(auto& arena: arenas)
+                arena->reset();
+        }
+
+        size_t used(){
+            std::lock_guard lock(mtx);
+            size_t total = 0;
+            for(auto& arena: arenas)
+                total += arena->used();
+            return total;
+        }
+
+    private:
+        static uint64_t nextId(){
+            static std::atomic<uint64_t> counter{0};
+            return counter.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // FRAMES arenas used round-robin, so data written in frame N stays valid
+    // until frame N+FRAMES begins (i.e. until the GPU has consumed it).
+    // begin_frame(i) must only be called after the fence of slot i was waited.
+    template<size_t FRAMES, typename Arena = frame_arena>
+    class buffered_frame_arena{
+        static_assert(FRAMES > 0);
+
+    private:
+        std::array<Arena, FRAMES> arenas;
+        Index index = 0;
+
+    public:
+        buffered_frame_arena() = default;
+
+        void begin_frame(Index frameIndex){
+            index = frameIndex % FRAMES;
+            arenas[index].reset();
+        }
+
+        Arena& current(){ return arenas[index]; }
+        const Arena& current() const{ return arenas[index]; }
+        Index frame_index() const{ return index; }
+        static constexpr size_t frame_count(){ return FRAMES; }
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace RenderToy
+{
+    namespace detail
+    {
+        // little-endian on every host, so constexpr and runtime hashes agree
+        inline constexpr uint64_t read_u64(const char* p){
+            if consteval{
+                uint64_t v = 0;
+                for(int i=0; i<8; ++i)
+                    v |= uint64_t(uint8_t(p[i])) << (8*i);
+                return v;
+            }
+            else{
+                uint64_t v;
+                std::memcpy(&v, p, sizeof(v));
+                if constexpr(std::endian::native == std::endian::big)
+                    v = std::byteswap(v);
+                return v;
+            }
+        }
+    }
+
+    // MurmurHash64A: 8 bytes per step, usable on literals at compile time.
+    // Not for anything adversarial.
+    inline constexpr uint64_t hash_string(std::string_view text, uint64_t seed = 0){
+        constexpr uint64_t M = 0xC6A4A7935BD1E995ull;
+        constexpr int R = 47;
+
+        uint64_t h = seed ^ (text.size() * M);
+        size_t i = 0;
+        for(; i+8 <= text.size(); i += 8){
+            auto k = detail::read_u64(text.data() + i);
+            k *= M;
+            k ^= k >> R;
+            k *= M;
+            h ^= k;
+            h *= M;
+        }
+        if(auto rest = text.size() - i; rest > 0){
+            uint64_t k = 0;
+            for(size_t j=0; j<rest; ++j)
+                k |= uint64_t(uint8_t(text[i+j])) << (8*j);
+            h ^= k;
+            h *= M;
+        }
+
+        h ^= h >> R;
+        h *= M;
+        h ^= h >> R;
+        return h;
+    }
+
+    // order-dependent mix of a second hash into seed
+    inline constexpr uint64_t hash_combine(uint64_t seed, uint64_t value){
+        return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+    }
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "hash.hpp"
+
+namespace RenderToy
+{
+    // string_view with its hash computed up front; constexpr, so literals
+    // written as "GBuffer"_hs are hashed at compile time.
+    struct hashed_string{
+        std::string_view str;
+        uint64_t hash;
+
+        constexpr hashed_string(std::string_view str):str(str), hash(hash_string(str)){}
+    };
+
+    namespace literals
+    {
+        consteval hashed_string operator""_hs(const char* text, size_t length){
+            return hashed_string(std::string_view(text, length));
+        }
+    }
+
+    namespace detail
+    {
+        struct name_entry{
+            uint64_t hash;
+            size_t length;
+            const name_entry* next;
+            // NUL-terminated text follows the header
+
+            const char* text() const{ return reinterpret_cast<const char*>(this + 1); }
+            std::string_view str() const{ return {text(), length}; }
+        };
+
+        // Process-wide intern table: fixed buckets of lock-free prepend-only
+        // lists. Entries are never freed, so a name stays valid until exit.
+        class name_table{
+        public:
+            static constexpr size_t BUCKET_COUNT = 1 << 14;
+
+        private:
+            std::array<std::atomic<const name_entry*>, BUCKET_COUNT> buckets{};
+            std::atomic<size_t> count = 0;
+
+        public:
+            const name_entry* find(std::string_view text, uint64_t hash) const{
+                auto& bucket = buckets[hash & (BUCKET_COUNT - 1)];
+                return search(bucket.load(std::memory_order_acquire), nullptr, text, hash);
+            }
+
+            const name_entry* intern(std::string_view text, uint64_t hash){
+                auto& bucket = buckets[hash & (BUCKET_COUNT - 1)];
+                auto head = bucket.load(std::memory_order_acquire);
+                if(auto found = search(head, nullptr, text, hash))
+                    return found;
+
+                auto entry = create(text, hash);
+                while(true){
+                    entry->next = head;
+                    if(bucket.compare_exchange_weak(head, entry,
+                        std::memory_order_release, std::memory_order_acquire)){
+                        count.fetch_add(1, std::memory_order_relaxed);
+                        return entry;
+                    }
+                    // only the newly prepended part can hold a racing insert
+                    if(auto found = search(head, entry->next, text, hash)){
+                        ::operator delete(entry);
+                        return found;
+                    }
+                }
+            }
+
+            size_t size() const{ return count.load(std::memory_order_relaxed); }
+
+        private:
+            static const name_entry* search(const name_entry* node, const name_entry* stop,
+                std::string_view text, uint64_t hash){
+                for(; node != stop; node = node->next)
+                    if(node->hash == hash && node->str() == text)
+                        return node;
+                return nullptr;
+            }
+
+            static name_entry* create(std::string_view text, uint64_t hash){
+                auto mem = ::operator new(sizeof(name_entry) + text.size() + 1);
+                auto entry = ::new(mem) name_entry{hash, text.size(), nullptr};
+                auto chars = reinterpret_cast<char*>(entry + 1);
+                std::memcpy(chars, text.data(), text.size());
+                chars[text.size()] = '\0';
+                return entry;
+            }
+        };
+
+        // leaked on purpose: names may outlive any static destructor order
+        inline name_table& names(){
+            static name_table& table = *new name_table;
+            return table;
+        }
+    }
+
+    // Interned string: one pointer, compared by identity, hash precomputed.
+    // Interning takes one hash and a bucket walk; after that equality and
+    // hashing are single integer ops. Safe to create from any thread.
+    class interned_name{
+    private:
+        // nullptr is the empty name
+        const detail::name_entry* entry = nullptr;
+
+        static constexpr uint64_t EMPTY_HASH = hash_string({});
+
+        explicit interned_name(const detail::name_entry* entry):entry(entry){}
+
+    public:
+        interned_name() = default;
+        explicit interned_name(hashed_string text)
+        :entry(text.str.empty() ? nullptr : detail::names().intern(text.str, text.hash)){}
+        explicit interned_name(std::string_view text)
+        :interned_name(hashed_string(text)){}
+        explicit interned_name(const char* text)
+        :interned_name(hashed_string(text)){}
+        explicit interned_name(const std::string& text)
+        :interned_name(hashed_string(text)){}
+
+        // the name if it was interned before, without interning it
+        static std::optional<interned_name> find(hashed_string text){
+            if(text.str.empty())
+                return interned_name();
+            if(auto found = detail::names().find(text.str, text.hash))
+                return interned_name(found);
+            return std::nullopt;
+        }
+        static std::optional<interned_name> find(std::string_view text){
+            return find(hashed_string(text));
+        }
+        static size_t interned_count(){ return detail::names().size(); }
+
+        std::string_view str() const{ return entry ? entry->str() : std::string_view(); }
+        const char* c_str() const{ return entry ? entry->text() : ""; }
+        uint64_t hash() const{ return entry ? entry->hash : EMPTY_HASH; }
+        size_t size() const{ return entry ? entry->length : 0; }
+        bool empty() const{ return entry == nullptr; }
+
+        bool operator==(const interned_name& other) const{ return entry == other.entry; }
+        bool operator==(std::string_view text) const{ return str() == text; }
+        // lexicographic, so ordered containers don't depend on allocation order
+        std::strong_ordering operator<=>(const interned_name& other) const{
+            if(entry == other.entry)
+                return std::strong_ordering::equal;
+            return str() <=> other.str();
+        }
+    };
+
+    // transparent hash/equality: maps keyed by interned_name also accept
+    // string_view / std::string / hashed_string lookups without interning
+    struct name_hash{
+        using is_transparent = void;
+
+        size_t operator()(const interned_name& name) const{ return size_t(name.hash()); }
+        size_t operator()(hashed_string text) const{ return size_t(text.hash); }
+        size_t operator()(std::string_view text) const{ return size_t(hash_string(text)); }
+        size_t operator()(const std::string& text) const{ return size_t(hash_string(text)); }
+        size_t operator()(const char* text) const{ return size_t(hash_string(text)); }
+    };
+
+    struct name_equal{
+        using is_transparent = void;
+
+        bool operator()(const interned_name& lhs, const interned_name& rhs) const{ return lhs == rhs; }
+        bool operator()(const interned_name& lhs, hashed_string rhs) const{
+            return lhs.hash() == rhs.hash && lhs.str() == rhs.str;
+        }
+        bool operator()(hashed_string lhs, const interned_name& rhs) const{ return (*this)(rhs, lhs); }
+        bool operator()(const interned_name& lhs, std::string_view rhs) const{ return lhs.str() == rhs; }
+        bool operator()(std::string_view lhs, const interned_name& rhs) const{ return rhs.str() == lhs; }
+    };
+
+    template<typename V>
+    using name_map = std::unordered_map<interned_name, V, name_hash, name_equal>;
+}
+
+template<>
+struct std::hash<RenderToy::interned_name>{
+    size_t operator()(const RenderToy::interned_name& name) const noexcept{
+        return size_t(name.hash());
+    }
+};
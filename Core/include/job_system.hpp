@@ -0,0 +1,371 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "core_types.hpp"
+#include "pool_allocator.hpp"
+#include "work_stealing_deque.hpp"
+
+namespace RenderToy
+{
+    class job_system;
+    class job_counter;
+
+    namespace detail
+    {
+        // header of every queued job; the callable follows it
+        struct job{
+            void (*run)(job*, job_system&);
+            job_counter* signal;
+        };
+    }
+
+    // Counts unfinished jobs: submit(f, &counter) adds one and the job
+    // takes it away when it finishes, even by throwing. Jobs submitted with
+    // submit_after(counter, ...) are held until it drops to zero.
+    // Wait on it with job_system::wait() before destroying it; wait()
+    // rethrows the first exception one of its jobs threw.
+    class job_counter{
+    private:
+        friend class job_system;
+
+        std::atomic<uint32_t> pending = 0;
+        // guards continuations, error, and the drop to zero
+        std::mutex mutex;
+        std::vector<detail::job*> continuations;
+        std::exception_ptr error;
+
+    public:
+        job_counter() = default;
+        job_counter(const job_counter&) = delete;
+        job_counter& operator=(const job_counter&) = delete;
+        ~job_counter(){
+            assert(pending.load() == 0 && "job_counter destroyed with jobs in flight");
+        }
+
+        uint32_t value() const{ return pending.load(std::memory_order_acquire); }
+        bool done() const{ return value() == 0; }
+    };
+
+    // Fixed pool of worker threads, one Chase-Lev deque each.
+    // A thread pushes to and takes from the bottom of its own deque; idle
+    // threads steal from the top of the others'. Threads outside the pool
+    // push to a shared injection queue instead.
+    // The constructing thread is the main thread: it owns a deque too, and
+    // only it runs submit_main() jobs, from run_main_jobs() or wait().
+    // wait() runs jobs while it waits, so a pool of zero workers still makes
+    // progress on the calling thread.
+    class job_system{
+    private:
+        using deque = work_stealing_deque<detail::job*>;
+
+        template<typename F>
+        struct job_of: detail::job{
+            F f;
+
+            static void invoke(detail::job* j, job_system& system){
+                auto self = static_cast<job_of*>(j);
+                try{
+                    self->f();
+                }
+                catch(...){
+                    // nobody waits on a job without a counter to hear of it
+                    if(self->signal == nullptr)
+                        std::terminate();
+                    system.fail(*self->signal, std::current_exception());
+                }
+                self->~job_of();
+                system.pool.deallocate(self, sizeof(job_of), alignof(job_of));
+            }
+        };
+
+        // small and short-lived, freed by whichever thread ran them
+        pool_resource pool;
+        // one per worker, then the main thread's
+        std::vector<std::unique_ptr<deque>> deques;
+        std::vector<std::thread> threads;
+        const std::thread::id main_thread;
+
+        std::mutex injected_mutex;
+        std::deque<detail::job*> injected;
+        std::mutex main_mutex;
+        std::deque<detail::job*> main_jobs;
+
+        // jobs pushed and not yet popped, for sleeping workers
+        std::atomic<int64_t> queued = 0;
+        std::atomic<uint32_t> sleepers = 0;
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        std::atomic<bool> stopping = false;
+
+        // which pool the calling thread works for, and its deque there
+        static inline thread_local const job_system* current_owner = nullptr;
+        static inline thread_local Index current_index = 0;
+
+    public:
+        explicit job_system(size_t worker_count = default_worker_count())
+        :deques(worker_count + 1), main_thread(std::this_thread::get_id()){
+            for(auto& d: deques)
+                d = std::make_unique<deque>();
+            threads.reserve(worker_count);
+            for(Index i=0; i<worker_count; ++i)
+                threads.emplace_back([this, i]{ worker_main(i); });
+        }
+        ~job_system(){
+            {
+                std::lock_guard lock(sleep_mutex);
+                stopping.store(true);
+            }
+            wake.notify_all();
+            for(auto& thread: threads)
+                thread.join();
+            // what the workers left, and main-thread jobs nobody pumped
+            while(run_one() || run_main_jobs() > 0){}
+        }
+        job_system(const job_system&) = delete;
+        job_system& operator=(const job_system&) = delete;
+
+        // one thread is left for the caller, which helps while it waits
+        static size_t default_worker_count(){
+            auto hardware = std::thread::hardware_concurrency();
+            return hardware > 1 ? hardware - 1 : 0;
+        }
+        // the pool every engine subsystem shares; its first user is its main thread
+        static job_system& shared(){
+            static job_system system;
+            return system;
+        }
+
+        size_t worker_count() const{ return threads.size(); }
+        bool is_main_thread() const{ return std::this_thread::get_id() == main_thread; }
+
+        // A job that throws still finishes `signal`, and wait(*signal)
+        // rethrows; without a signal it must not throw.
+        template<typename F>
+        void submit(F&& f, job_counter* signal = nullptr){
+            push(make_job(std::forward<F>(f), signal));
+        }
+        // queued like submit() once `dependency` drops to zero, even if
+        // one of its jobs threw
+        template<typename F>
+        void submit_after(job_counter& dependency, F&& f, job_counter* signal = nullptr){
+            auto j = make_job(std::forward<F>(f), signal);
+            {
+                std::lock_guard lock(dependency.mutex);
+                if(dependency.pending.load(std::memory_order_acquire) != 0){
+                    dependency.continuations.push_back(j);
+                    return;
+                }
+            }
+            push(j);
+        }
+        // runs on the main thread only, e.g. for window or GPU calls
+        template<typename F>
+        void submit_main(F&& f, job_counter* signal = nullptr){
+            auto j = make_job(std::forward<F>(f), signal);
+            std::lock_guard lock(main_mutex);
+            main_jobs.push_back(j);
+        }
+
+        // main thread: runs the submit_main() jobs queued so far
+        size_t run_main_jobs(){
+            assert((is_main_thread() || stopping.load()) && "main-thread jobs run on the main thread");
+            std::deque<detail::job*> batch;
+            {
+                std::lock_guard lock(main_mutex);
+                batch.swap(main_jobs);
+            }
+            for(auto j: batch)
+                execute(j);
+            return batch.size();
+        }
+
+        // runs jobs until `counter` drops to zero, then rethrows the first
+        // exception they threw
+        void wait(job_counter& counter){
+            auto main = is_main_thread();
+            while(!counter.done()){
+                if(run_one())
+                    continue;
+                if(main && run_main_jobs() > 0)
+                    continue;
+                std::this_thread::yield();
+            }
+            std::exception_ptr error;
+            {
+                // the job that finished it may still be releasing continuations
+                std::lock_guard lock(counter.mutex);
+                error = std::exchange(counter.error, nullptr);
+            }
+            if(error)
+                std::rethrow_exception(error);
+        }
+
+        // runs one queued job on the calling thread; false if none was found
+        bool run_one(){
+            auto j = pop();
+            if(j == nullptr)
+                return false;
+            execute(j);
+            return true;
+        }
+
+        // f(begin, end) over [0, count) in ranges of `grain`.
+        // The ranges depend only on count and grain, never on the number
+        // of threads. Returns once every range ran; rethrows the first
+        // exception a range threw.
+        template<typename F>
+        void parallel_for(size_t count, size_t grain, F&& f){
+            if(count == 0)
+                return;
+            grain = std::max<size_t>(grain, 1);
+            auto ranges = (count + grain - 1) / grain;
+            if(ranges == 1 || worker_count() == 0){
+                for(Index begin=0; begin<count; begin+=grain)
+                    f(begin, std::min(begin + grain, count));
+                return;
+            }
+
+            job_counter counter;
+            for(Index r=0; r<ranges; ++r){
+                submit([&, r]{
+                    auto begin = r * grain;
+                    f(begin, std::min(begin + grain, count));
+                }, &counter);
+            }
+            wait(counter);
+        }
+
+    private:
+        template<typename F>
+        detail::job* make_job(F&& f, job_counter* signal){
+            using J = job_of<std::decay_t<F>>;
+            if(signal)
+                signal->pending.fetch_add(1, std::memory_order_relaxed);
+            auto mem = pool.allocate(sizeof(J), alignof(J));
+            return ::new(mem) J{{&J::invoke, signal}, std::forward<F>(f)};
+        }
+
+        // the deque the calling thread owns here, nullptr for outside threads
+        deque* own_deque() const{
+            if(current_owner == this)
+                return deques[current_index].get();
+            if(is_main_thread())
+                return deques.back().get();
+            return nullptr;
+        }
+
+        void push(detail::job* j){
+            if(auto d = own_deque())
+                d->push(j);
+            else{
+                std::lock_guard lock(injected_mutex);
+                injected.push_back(j);
+            }
+            // either a worker about to sleep sees `queued`, or we see it in
+            // `sleepers`: both sides use seq_cst. Only the push that makes
+            // work appear wakes anyone; woken workers wake the next one
+            // while work is left, so a burst of pushes costs one syscall.
+            if(queued.fetch_add(1, std::memory_order_seq_cst) <= 0)
+                wake_one();
+        }
+        void wake_one(){
+            if(sleepers.load(std::memory_order_seq_cst) != 0){
+                { std::lock_guard lock(sleep_mutex); }
+                wake.notify_one();
+            }
+        }
+
+        detail::job* pop(){
+            if(queued.load(std::memory_order_acquire) <= 0)
+                return nullptr;
+
+            auto self = own_deque();
+            auto j = self ? self->take() : nullptr;
+            if(j == nullptr)
+                j = pop_injected();
+            // steal from the next deque on, so thieves spread out
+            auto start = current_owner == this ? current_index + 1 : 0;
+            for(Index i=0; j == nullptr && i<deques.size(); ++i){
+                auto& victim = *deques[(start + i) % deques.size()];
+                if(&victim != self)
+                    j = victim.steal();
+            }
+            if(j != nullptr)
+                queued.fetch_sub(1, std::memory_order_relaxed);
+            return j;
+        }
+        detail::job* pop_injected(){
+            std::lock_guard lock(injected_mutex);
+            if(injected.empty())
+                return nullptr;
+            auto j = injected.front();
+            injected.pop_front();
+            return j;
+        }
+
+        void execute(detail::job* j){
+            auto signal = j->signal;
+            j->run(j, *this);
+            if(signal)
+                finish(*signal);
+        }
+        // keeps the first exception for wait(); finish() still runs
+        void fail(job_counter& counter, std::exception_ptr error){
+            std::lock_guard lock(counter.mutex);
+            if(!counter.error)
+                counter.error = std::move(error);
+        }
+        // the last job drops the counter to zero under its lock, so
+        // submit_after() and wait() can't miss it
+        void finish(job_counter& counter){
+            auto pending = counter.pending.load(std::memory_order_relaxed);
+            while(pending > 1){
+                if(counter.pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel))
+                    return;
+            }
+
+            std::vector<detail::job*> ready;
+            {
+                std::lock_guard lock(counter.mutex);
+                if(counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    ready.swap(counter.continuations);
+            }
+            for(auto j: ready)
+                push(j);
+        }
+
+        void worker_main(Index index){
+            current_owner = this;
+            current_index = index;
+            while(true){
+                if(run_one())
+                    continue;
+
+                std::unique_lock lock(sleep_mutex);
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                wake.wait(lock, [this]{
+                    return stopping.load() || queued.load(std::memory_order_seq_cst) > 0;
+                });
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+                // drain what is left before leaving
+                if(stopping.load() && queued.load(std::memory_order_acquire) <= 0)
+                    return;
+                lock.unlock();
+                if(queued.load(std::memory_order_seq_cst) > 1)
+                    wake_one();
+            }
+        }
+    };
+}
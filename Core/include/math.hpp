@@ -3,6 +3,7 @@
 #include <array>
 #include <cmath>
 #include <type_traits>
+#include "simd.hpp"
 
 namespace RenderToy
 {
@@ -64,6 +65,8 @@ namespace RenderToy
     // row major
     using Mat4 = std::array<Vec4, 4>;
     static_assert(std::is_trivially_copyable_v<Mat4>);
+    // simd kernels read a Mat4 as 16 packed floats
+    static_assert(sizeof(Mat4) == 16*sizeof(float));
 
     inline constexpr auto asVec3(Vec2 v2, float z=0.0f){
         return Vec3{v2.x, v2.y, z};
@@ -226,13 +229,34 @@ namespace RenderToy
         return Vec4{-quat.x, -quat.y, -quat.z, quat.w};
     }
 
+    namespace detail
+    {
+        // constexpr reference kernels; the operators use them during
+        // constant evaluation and the simd:: ones at runtime
+        inline constexpr auto quat_mul_scalar(Vec4 lhs, Vec4 rhs){
+            return Vec4{
+                lhs.w*rhs.x + lhs.x*rhs.w + lhs.y*rhs.z - lhs.z*rhs.y,
+                lhs.w*rhs.y - lhs.x*rhs.z + lhs.y*rhs.w + lhs.z*rhs.x,
+                lhs.w*rhs.z + lhs.x*rhs.y - lhs.y*rhs.x + lhs.z*rhs.w,
+                lhs.w*rhs.w - lhs.x*rhs.x - lhs.y*rhs.y - lhs.z*rhs.z
+            };
+        }
+
+        inline simd::f32x4 load(const Vec4& v){ return simd::load(&v.x); }
+        inline Vec4 store(simd::f32x4 v){
+            Vec4 out;
+            simd::store(&out.x, v);
+            return out;
+        }
+    }
+
     inline constexpr auto operator*(Vec4 lhs, Vec4 rhs){
-        return Vec4{
-            lhs.w*rhs.x + lhs.x*rhs.w + lhs.y*rhs.z - lhs.z*rhs.y,
-            lhs.w*rhs.y - lhs.x*rhs.z + lhs.y*rhs.w + lhs.z*rhs.x,
-            lhs.w*rhs.z + lhs.x*rhs.y - lhs.y*rhs.x + lhs.z*rhs.w,
-            lhs.w*rhs.w - lhs.x*rhs.x - lhs.y*rhs.y - lhs.z*rhs.z
-        };
+        if consteval{
+            return detail::quat_mul_scalar(lhs, rhs);
+        }
+        else{
+            return detail::store(simd::quat_mul(detail::load(lhs), detail::load(rhs)));
+        }
     }
     inline constexpr auto operator/(Vec4 lhs, float rhs){
         return Vec4{
@@ -252,7 +276,8 @@ namespace RenderToy
         return std::sqrt(norm_squared(v));
     }
     inline auto normalize(Vec4 v){
-        return v / norm(v);
+        auto x = detail::load(v);
+        return detail::store(x / simd::sqrt(simd::dot4(x, x)));
     }
         inline auto quat(Vec3 r, Vec3 u, Vec3 f){
         float m00 = r.x, m01 = u.x, m02 = f.x;
@@ -334,8 +359,16 @@ namespace RenderToy
             std::cos(half)
         };
     }
-    inline auto rotate(Vec3 v, Vec4 quat){
-        return asVec3(quat * asVec4(v) * conjugate(quat));
+    inline constexpr auto rotate(Vec3 v, Vec4 quat){
+        if consteval{
+            return asVec3(quat * asVec4(v) * conjugate(quat));
+        }
+        else{
+            auto q = detail::load(quat);
+            auto conj = q * simd::set(-1.0f, -1.0f, -1.0f, 1.0f);
+            auto p = simd::set(v.x, v.y, v.z, 0.0f);
+            return asVec3(detail::store(simd::quat_mul(simd::quat_mul(q, p), conj)));
+        }
     }
 
     inline constexpr auto right(Vec4 quat){
@@ -367,15 +400,29 @@ namespace RenderToy
                lhs.z==rhs.z && lhs.w==rhs.w;
     }
 
-    inline constexpr auto operator*(const Mat4& lhs, const Mat4& rhs){
-        auto rhs_t = transpose(rhs);
+    namespace detail
+    {
+        inline constexpr auto mat_mul_scalar(const Mat4& lhs, const Mat4& rhs){
+            auto rhs_t = transpose(rhs);
 
-        return Mat4{
-            Vec4{dot(lhs[0], rhs_t[0]), dot(lhs[0], rhs_t[1]), dot(lhs[0], rhs_t[2]), dot(lhs[0], rhs_t[3])},
-            Vec4{dot(lhs[1], rhs_t[0]), dot(lhs[1], rhs_t[1]), dot(lhs[1], rhs_t[2]), dot(lhs[1], rhs_t[3])},
-            Vec4{dot(lhs[2], rhs_t[0]), dot(lhs[2], rhs_t[1]), dot(lhs[2], rhs_t[2]), dot(lhs[2], rhs_t[3])},
-            Vec4{dot(lhs[3], rhs_t[0]), dot(lhs[3], rhs_t[1]), dot(lhs[3], rhs_t[2]), dot(lhs[3], rhs_t[3])},
-        };
+            return Mat4{
+                Vec4{dot(lhs[0], rhs_t[0]), dot(lhs[0], rhs_t[1]), dot(lhs[0], rhs_t[2]), dot(lhs[0], rhs_t[3])},
+                Vec4{dot(lhs[1], rhs_t[0]), dot(lhs[1], rhs_t[1]), dot(lhs[1], rhs_t[2]), dot(lhs[1], rhs_t[3])},
+                Vec4{dot(lhs[2], rhs_t[0]), dot(lhs[2], rhs_t[1]), dot(lhs[2], rhs_t[2]), dot(lhs[2], rhs_t[3])},
+                Vec4{dot(lhs[3], rhs_t[0]), dot(lhs[3], rhs_t[1]), dot(lhs[3], rhs_t[2]), dot(lhs[3], rhs_t[3])},
+            };
+        }
+    }
+
+    inline constexpr auto operator*(const Mat4& lhs, const Mat4& rhs){
+        if consteval{
+            return detail::mat_mul_scalar(lhs, rhs);
+        }
+        else{
+            Mat4 out;
+            simd::mat4_mul(&lhs[0].x, &rhs[0].x, &out[0].x);
+            return out;
+        }
     }
 
     // expected multiplication form
@@ -453,6 +500,17 @@ namespace RenderToy
         };
     }
 
+    // rotation matrix of a unit quaternion, rotateMat(q) * v == rotate(v, q)
+    inline constexpr auto rotateMat(Vec4 quat){
+        auto [x, y, z, w] = quat;
+        return Mat4{
+            Vec4{1.0f - 2.0f*(y*y + z*z),        2.0f*(x*y - w*z),        2.0f*(x*z + w*y), 0.0f},
+            Vec4{       2.0f*(x*y + w*z), 1.0f - 2.0f*(x*x + z*z),        2.0f*(y*z - w*x), 0.0f},
+            Vec4{       2.0f*(x*z - w*y),        2.0f*(y*z + w*x), 1.0f - 2.0f*(x*x + y*y), 0.0f},
+            Vec4{                   0.0f,                    0.0f,                    0.0f, 1.0f}
+        };
+    }
+
     inline constexpr auto translateMat(Vec3 t){
         return Mat4{
             Vec4{1.0f, 0.0f, 0.0f, t.x},
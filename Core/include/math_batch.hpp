@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <span>
+#include "math.hpp"
+#include "simd.hpp"
+
+namespace RenderToy
+{
+    // Batched counterparts of math.hpp for large arrays (vertices, transforms).
+    // Inputs are transposed into SoA blocks of 4 lanes, so each lane is one element;
+    // the remainder runs through the per-element functions.
+    // out must be at least as large as the input and may alias it.
+
+    static_assert(sizeof(Vec3) == 3*sizeof(float));
+    static_assert(sizeof(Vec4) == 4*sizeof(float));
+
+    // out[i] = (m * (in[i], 1)).xyz, m is assumed affine
+    inline void transform_points(std::span<const Vec3> in, const Mat4& m, std::span<Vec3> out){
+        assert(out.size() >= in.size());
+        using namespace simd;
+
+        auto src = reinterpret_cast<const float*>(in.data());
+        auto dst = reinterpret_cast<float*>(out.data());
+        f32x4 e[3][4];
+        for(int row=0; row<3; ++row)
+            for(int col=0; col<4; ++col)
+                e[row][col] = splat(m[row][col]);
+
+        size_t i = 0;
+        for(; i+4 <= in.size(); i += 4){
+            f32x4 x, y, z;
+            load3x4(src + 3*i, x, y, z);
+            f32x4 o[3];
+            for(int row=0; row<3; ++row)
+                o[row] = madd(e[row][2], z, madd(e[row][1], y, e[row][0]*x)) + e[row][3];
+            store3x4(dst + 3*i, o[0], o[1], o[2]);
+        }
+        for(; i < in.size(); ++i)
+            out[i] = asVec3(m * asVec4(in[i], 1.0f));
+    }
+
+    // out[i] = lhs[i] * rhs[i]
+    inline void mul_matrices(std::span<const Mat4> lhs, std::span<const Mat4> rhs, std::span<Mat4> out){
+        assert(rhs.size() == lhs.size() && out.size() >= lhs.size());
+        for(size_t i=0; i<lhs.size(); ++i)
+            simd::mat4_mul(&lhs[i][0].x, &rhs[i][0].x, &out[i][0].x);
+    }
+
+    // out[i] = rotateMat(quats[i]), quats must be unit length
+    inline void quat_to_mat_batch(std::span<const Vec4> quats, std::span<Mat4> out){
+        assert(out.size() >= quats.size());
+        using namespace simd;
+
+        auto one = splat(1.0f);
+        auto two = splat(2.0f);
+        auto lastRow = set(0.0f, 0.0f, 0.0f, 1.0f);
+
+        size_t i = 0;
+        for(; i+4 <= quats.size(); i += 4){
+            auto x = load(&quats[i].x);
+            auto y = load(&quats[i+1].x);
+            auto z = load(&quats[i+2].x);
+            auto w = load(&quats[i+3].x);
+            transpose4(x, y, z, w);
+
+            auto xx = x*x, yy = y*y, zz = z*z;
+            auto xy = x*y, xz = x*z, yz = y*z;
+            auto wx = w*x, wy = w*y, wz = w*z;
+
+            // rows[r][c] holds element (r, c) of 4 matrices; the 4th column is 0
+            f32x4 rows[3][4] = {
+                {one - two*(yy + zz),       two*(xy - wz),       two*(xz + wy), splat(0.0f)},
+                {      two*(xy + wz), one - two*(xx + zz),       two*(yz - wx), splat(0.0f)},
+                {      two*(xz - wy),       two*(yz + wx), one - two*(xx + yy), splat(0.0f)},
+            };
+            for(auto& row: rows)
+                transpose4(row[0], row[1], row[2], row[3]);
+
+            for(int k=0; k<4; ++k){
+                auto dst = &out[i+k][0].x;
+                store(dst,      rows[0][k]);
+                store(dst + 4,  rows[1][k]);
+                store(dst + 8,  rows[2][k]);
+                store(dst + 12, lastRow);
+            }
+        }
+        for(; i < quats.size(); ++i)
+            out[i] = rotateMat(quats[i]);
+    }
+
+    inline void normalize_batch(std::span<const Vec3> in, std::span<Vec3> out){
+        assert(out.size() >= in.size());
+        using namespace simd;
+
+        auto src = reinterpret_cast<const float*>(in.data());
+        auto dst = reinterpret_cast<float*>(out.data());
+
+        size_t i = 0;
+        for(; i+4 <= in.size(); i += 4){
+            f32x4 x, y, z;
+            load3x4(src + 3*i, x, y, z);
+            auto inv = splat(1.0f) / sqrt(madd(z, z, madd(y, y, x*x)));
+            store3x4(dst + 3*i, x*inv, y*inv, z*inv);
+        }
+        for(; i < in.size(); ++i)
+            out[i] = normalize(in[i]);
+    }
+    inline void normalize_batch(std::span<const Vec4> in, std::span<Vec4> out){
+        assert(out.size() >= in.size());
+        using namespace simd;
+
+        size_t i = 0;
+        for(; i+4 <= in.size(); i += 4){
+            auto x = load(&in[i].x);
+            auto y = load(&in[i+1].x);
+            auto z = load(&in[i+2].x);
+            auto w = load(&in[i+3].x);
+            transpose4(x, y, z, w);
+
+            auto inv = splat(1.0f) / sqrt(madd(w, w, madd(z, z, madd(y, y, x*x))));
+            x = x*inv; y = y*inv; z = z*inv; w = w*inv;
+
+            transpose4(x, y, z, w);
+            store(&out[i].x, x);
+            store(&out[i+1].x, y);
+            store(&out[i+2].x, z);
+            store(&out[i+3].x, w);
+        }
+        for(; i < in.size(); ++i)
+            out[i] = normalize(in[i]);
+    }
+
+    // grows [min, max] to contain every point
+    inline void bounds_batch(std::span<const Vec3> points, Vec3& min, Vec3& max){
+        using namespace simd;
+
+        auto src = reinterpret_cast<const float*>(points.data());
+        f32x4 lo[3] = {splat(min.x), splat(min.y), splat(min.z)};
+        f32x4 hi[3] = {splat(max.x), splat(max.y), splat(max.z)};
+
+        size_t i = 0;
+        for(; i+4 <= points.size(); i += 4){
+            f32x4 p[3];
+            load3x4(src + 3*i, p[0], p[1], p[2]);
+            for(int axis=0; axis<3; ++axis){
+                lo[axis] = simd::min(lo[axis], p[axis]);
+                hi[axis] = simd::max(hi[axis], p[axis]);
+            }
+        }
+
+        float lanes[4];
+        for(int axis=0; axis<3; ++axis){
+            store(lanes, lo[axis]);
+            for(auto value: lanes)
+                min[axis] = std::min(min[axis], value);
+            store(lanes, hi[axis]);
+            for(auto value: lanes)
+                max[axis] = std::max(max[axis], value);
+        }
+        for(; i < points.size(); ++i){
+            for(int axis=0; axis<3; ++axis){
+                min[axis] = std::min(min[axis], points[i][axis]);
+                max[axis] = std::max(max[axis], points[i][axis]);
+            }
+        }
+    }
+}
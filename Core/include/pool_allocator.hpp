@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace RenderToy
+{
+    // Small-object pool with power-of-2 size classes (16..1024 bytes).
+    // Each class keeps a central free list fed by 64 KiB slabs; every thread
+    // allocates from its own magazine and only takes the class lock to move
+    // half a magazine at a time. Larger or over-aligned requests go upstream.
+    // Magazines of exited threads stay with the pool until it is destroyed.
+    class pool_resource final: public std::pmr::memory_resource{
+    public:
+        static constexpr size_t MIN_CLASS = 16;
+        static constexpr size_t MAX_CLASS = 1024;
+        static constexpr size_t NUM_CLASSES = std::countr_zero(MAX_CLASS) - std::countr_zero(MIN_CLASS) + 1;
+        static constexpr size_t MAGAZINE_SIZE = 64;
+        static constexpr size_t SLAB_SIZE = 64*1024;
+        static constexpr size_t SLAB_ALIGN = 64;
+
+    private:
+        struct FreeNode{
+            FreeNode* next;
+        };
+        struct Central{
+            std::mutex mtx;
+            FreeNode* head = nullptr;
+            std::vector<void*> slabs;
+        };
+        struct Magazine{
+            std::array<void*, MAGAZINE_SIZE> items;
+            size_t count = 0;
+        };
+        struct ThreadCache{
+            std::array<Magazine, NUM_CLASSES> magazines;
+        };
+
+        std::pmr::memory_resource* upstream;
+        std::array<Central, NUM_CLASSES> centrals;
+        std::vector<std::unique_ptr<ThreadCache>> caches;
+        std::mutex cacheMtx;
+        // never reused, so stale thread caches can't alias a new pool
+        const uint64_t id = nextId();
+
+    public:
+        explicit pool_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        :upstream(upstream){}
+        ~pool_resource(){
+            for(auto& central: centrals)
+                for(auto slab: central.slabs)
+                    upstream->deallocate(slab, SLAB_SIZE, SLAB_ALIGN);
+        }
+        pool_resource(const pool_resource&) = delete;
+        pool_resource& operator=(const pool_resource&) = delete;
+
+        static constexpr bool pooled(size_t bytes, size_t alignment){
+            return bytes <= MAX_CLASS && alignment <= std::min(class_size(class_of(bytes)), SLAB_ALIGN);
+        }
+        static constexpr size_t class_of(size_t bytes){
+            return std::bit_width(std::max(bytes, MIN_CLASS) - 1) - std::countr_zero(MIN_CLASS);
+        }
+        static constexpr size_t class_size(size_t sizeClass){
+            return MIN_CLASS << sizeClass;
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override{
+            if(!pooled(bytes, alignment)) [[unlikely]]
+                return upstream->allocate(bytes, alignment);
+
+            auto sizeClass = class_of(bytes);
+            auto& magazine = local().magazines[sizeClass];
+            if(magazine.count == 0) [[unlikely]]
+                refill(sizeClass, magazine);
+            return magazine.items[--magazine.count];
+        }
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override{
+            if(!pooled(bytes, alignment)) [[unlikely]]
+                return upstream->deallocate(ptr, bytes, alignment);
+
+            auto sizeClass = class_of(bytes);
+            auto& magazine = local().magazines[sizeClass];
+            if(magazine.count == MAGAZINE_SIZE) [[unlikely]]
+                flush(sizeClass, magazine);
+            magazine.items[magazine.count++] = ptr;
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+            return this == &other;
+        }
+
+        ThreadCache& local(){
+            thread_local std::vector<std::pair<uint64_t, ThreadCache*>> cache;
+            for(auto [owner, threadCache]: cache)
+                if(owner == id)
+                    return *threadCache;
+
+            std::lock_guard lock(cacheMtx);
+            auto& threadCache = caches.emplace_back(std::make_unique<ThreadCache>());
+            cache.emplace_back(id, threadCache.get());
+            return *threadCache;
+        }
+
+        // moves half a magazine from the central list, carving a slab if it's empty
+        void refill(size_t sizeClass, Magazine& magazine){
+            auto& central = centrals[sizeClass];
+            std::lock_guard lock(central.mtx);
+            if(central.head == nullptr)
+                carve(sizeClass, central);
+
+            while(magazine.count < MAGAZINE_SIZE/2 && central.head != nullptr){
+                auto node = central.head;
+                central.head = node->next;
+                magazine.items[magazine.count++] = node;
+            }
+        }
+        void flush(size_t sizeClass, Magazine& magazine){
+            auto& central = centrals[sizeClass];
+            std::lock_guard lock(central.mtx);
+            while(magazine.count > MAGAZINE_SIZE/2){
+                auto node = static_cast<FreeNode*>(magazine.items[--magazine.count]);
+                node->next = central.head;
+                central.head = node;
+            }
+        }
+        void carve(size_t sizeClass, Central& central){
+            auto slab = static_cast<std::byte*>(upstream->allocate(SLAB_SIZE, SLAB_ALIGN));
+            central.slabs.push_back(slab);
+
+            auto size = class_size(sizeClass);
+            for(size_t offset = SLAB_SIZE; offset >= size; offset -= size){
+                auto node = ::new(slab + offset - size) FreeNode{central.head};
+                central.head = node;
+            }
+        }
+
+        static uint64_t nextId(){
+            static std::atomic<uint64_t> counter{0};
+            return counter.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // process-wide pool behind pool_allocator / make_pooled
+    inline pool_resource& default_pool(){
+        static pool_resource pool;
+        return pool;
+    }
+
+    // std allocator over a pool_resource, e.g. for node-based containers
+    template<typename T>
+    class pool_allocator{
+    private:
+        pool_resource* resource;
+
+        template<typename U>
+        friend class pool_allocator;
+
+    public:
+        using value_type = T;
+
+        pool_allocator() noexcept:resource(&default_pool()){}
+        explicit pool_allocator(pool_resource* resource) noexcept:resource(resource){}
+        template<typename U>
+        pool_allocator(const pool_allocator<U>& other) noexcept:resource(other.resource){}
+
+        T* allocate(size_t n){
+            return static_cast<T*>(resource->allocate(sizeof(T)*n, alignof(T)));
+        }
+        void deallocate(T* ptr, size_t n) noexcept{
+            resource->deallocate(ptr, sizeof(T)*n, alignof(T));
+        }
+
+        template<typename U>
+        bool operator==(const pool_allocator<U>& other) const noexcept{
+            return resource == other.resource;
+        }
+    };
+
+    // remembers the allocated size, so pool_ptr<Base> may own a Derived
+    struct pool_deleter{
+        size_t size = 0;
+        size_t alignment = 0;
+
+        template<typename T>
+        void operator()(T* ptr) const{
+            void* mem = ptr;
+            if constexpr(std::is_polymorphic_v<T>)
+                mem = dynamic_cast<void*>(ptr);
+            std::destroy_at(ptr);
+            default_pool().deallocate(mem, size, alignment);
+        }
+    };
+
+    template<typename T>
+    using pool_ptr = std::unique_ptr<T, pool_deleter>;
+
+    template<typename T, typename... Args>
+    pool_ptr<T> make_pooled(Args&&... args){
+        auto mem = default_pool().allocate(sizeof(T), alignof(T));
+        try{
+            return pool_ptr<T>(::new(mem) T(std::forward<Args>(args)...),
+                pool_deleter{sizeof(T), alignof(T)});
+        }
+        catch(...){
+            default_pool().deallocate(mem, sizeof(T), alignof(T));
+            throw;
+        }
+    }
+}
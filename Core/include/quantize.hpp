@@ -0,0 +1,425 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include "math.hpp"
+#include "simd.hpp"
+
+namespace RenderToy
+{
+    // Compact encodings for bandwidth-bound data (vertex streams, snapshots).
+    // Scalar conversions are constexpr; *_batch variants run 4 lanes at a time.
+
+    namespace detail
+    {
+        // IEEE binary16, round to nearest even
+        inline constexpr uint16_t float_to_half(float f){
+            auto x = std::bit_cast<uint32_t>(f);
+            uint32_t sign = (x >> 16) & 0x8000;
+            uint32_t absx = x & 0x7FFFFFFF;
+
+            // inf / nan (nan keeps a quiet bit)
+            if(absx >= 0x7F800000)
+                return uint16_t(sign | 0x7C00 | (absx > 0x7F800000 ? 0x200 | ((absx >> 13) & 0x3FF) : 0));
+            // >= 65520 rounds past the largest half
+            if(absx >= 0x477FF000)
+                return uint16_t(sign | 0x7C00);
+            // half subnormal range (< 2^-14)
+            if(absx < 0x38800000){
+                if(absx <= 0x33000000)
+                    return uint16_t(sign);
+                uint32_t shift = 126 - (absx >> 23);
+                uint32_t mantissa = (absx & 0x7FFFFF) | 0x800000;
+                uint32_t h = mantissa >> shift;
+                uint32_t rest = mantissa & ((1u << shift) - 1);
+                uint32_t halfway = 1u << (shift - 1);
+                if(rest > halfway || (rest == halfway && (h & 1)))
+                    ++h;
+                return uint16_t(sign | h);
+            }
+
+            // rebias 127 -> 15; a rounding carry may step into the exponent
+            uint32_t h = (absx - 0x38000000) >> 13;
+            uint32_t rest = absx & 0x1FFF;
+            if(rest > 0x1000 || (rest == 0x1000 && (h & 1)))
+                ++h;
+            return uint16_t(sign | h);
+        }
+        inline constexpr float half_to_float(uint16_t h){
+            uint32_t sign = uint32_t(h & 0x8000) << 16;
+            uint32_t exponent = (h >> 10) & 0x1F;
+            uint32_t mantissa = h & 0x3FF;
+
+            if(exponent == 0){
+                auto f = float(mantissa) * 0x1p-24f;
+                return sign ? -f : f;
+            }
+            if(exponent == 31)
+                return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+            return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+        }
+
+        // round half away from zero; constexpr stand-in for std::lround
+        inline constexpr float round_away(float f){
+            return f >= 0.0f ? f + 0.5f : f - 0.5f;
+        }
+    }
+
+    //==========================================================================
+    // half
+    //==========================================================================
+
+    struct half{
+        uint16_t bits = 0;
+
+        constexpr half() = default;
+        constexpr explicit half(float f):bits(detail::float_to_half(f)){}
+
+        static constexpr half from_bits(uint16_t bits){
+            half h;
+            h.bits = bits;
+            return h;
+        }
+        constexpr explicit operator float() const{ return detail::half_to_float(bits); }
+
+        constexpr bool operator==(const half&) const = default;
+    }; static_assert(sizeof(half) == 2 && std::is_trivially_copyable_v<half>);
+
+    struct Vec2h{
+        half x, y;
+    }; static_assert(sizeof(Vec2h) == 4);
+
+    struct Vec4h{
+        half x, y, z, w;
+    }; static_assert(sizeof(Vec4h) == 8);
+
+    inline constexpr auto asVec2h(Vec2 v){
+        return Vec2h{half(v.x), half(v.y)};
+    }
+    inline constexpr auto asVec2(Vec2h v){
+        return Vec2{float(v.x), float(v.y)};
+    }
+    inline constexpr auto asVec4h(Vec4 v){
+        return Vec4h{half(v.x), half(v.y), half(v.z), half(v.w)};
+    }
+    inline constexpr auto asVec4(Vec4h v){
+        return Vec4{float(v.x), float(v.y), float(v.z), float(v.w)};
+    }
+
+    // out[i] = half(in[i]); Vec2/Vec4 arrays convert through their floats
+    inline void to_half_batch(std::span<const float> in, std::span<half> out){
+        assert(out.size() >= in.size());
+        size_t i = 0;
+#if defined(RENDERTOY_SIMD_HALF)
+        static_assert(sizeof(half) == sizeof(uint16_t));
+        for(; i+4 <= in.size(); i += 4)
+            simd::store_half(&out[i].bits, simd::load(&in[i]));
+#endif
+        for(; i < in.size(); ++i)
+            out[i] = half(in[i]);
+    }
+    inline void from_half_batch(std::span<const half> in, std::span<float> out){
+        assert(out.size() >= in.size());
+        size_t i = 0;
+#if defined(RENDERTOY_SIMD_HALF)
+        for(; i+4 <= in.size(); i += 4)
+            simd::store(&out[i], simd::load_half(&in[i].bits));
+#endif
+        for(; i < in.size(); ++i)
+            out[i] = float(in[i]);
+    }
+
+    //==========================================================================
+    // snorm / unorm
+    //==========================================================================
+
+    // [-1, 1] <-> [-MAX, MAX]; -MIN is never produced
+    template<std::signed_integral T>
+    inline constexpr T to_snorm(float f){
+        constexpr auto MAX = float(std::numeric_limits<T>::max());
+        return T(detail::round_away(std::clamp(f, -1.0f, 1.0f) * MAX));
+    }
+    template<std::signed_integral T>
+    inline constexpr float from_snorm(T v){
+        constexpr auto MAX = float(std::numeric_limits<T>::max());
+        return std::max(float(v) / MAX, -1.0f);
+    }
+    // [0, 1] <-> [0, MAX]
+    template<std::unsigned_integral T>
+    inline constexpr T to_unorm(float f){
+        constexpr auto MAX = float(std::numeric_limits<T>::max());
+        return T(std::clamp(f, 0.0f, 1.0f) * MAX + 0.5f);
+    }
+    template<std::unsigned_integral T>
+    inline constexpr float from_unorm(T v){
+        constexpr auto MAX = float(std::numeric_limits<T>::max());
+        return float(v) / MAX;
+    }
+
+    using Vec2snorm16 = std::array<int16_t, 2>;
+    using Vec4snorm16 = std::array<int16_t, 4>;
+    using Vec4snorm8  = std::array<int8_t, 4>;
+    using Vec4unorm16 = std::array<uint16_t, 4>;
+    using Vec4unorm8  = std::array<uint8_t, 4>;
+
+    template<std::signed_integral T>
+    inline constexpr auto to_snorm(Vec2 v){
+        return std::array<T, 2>{to_snorm<T>(v.x), to_snorm<T>(v.y)};
+    }
+    template<std::signed_integral T>
+    inline constexpr auto to_snorm(Vec4 v){
+        return std::array<T, 4>{to_snorm<T>(v.x), to_snorm<T>(v.y), to_snorm<T>(v.z), to_snorm<T>(v.w)};
+    }
+    template<std::signed_integral T>
+    inline constexpr auto from_snorm(const std::array<T, 2>& v){
+        return Vec2{from_snorm(v[0]), from_snorm(v[1])};
+    }
+    template<std::signed_integral T>
+    inline constexpr auto from_snorm(const std::array<T, 4>& v){
+        return Vec4{from_snorm(v[0]), from_snorm(v[1]), from_snorm(v[2]), from_snorm(v[3])};
+    }
+    template<std::unsigned_integral T>
+    inline constexpr auto to_unorm(Vec4 v){
+        return std::array<T, 4>{to_unorm<T>(v.x), to_unorm<T>(v.y), to_unorm<T>(v.z), to_unorm<T>(v.w)};
+    }
+    template<std::unsigned_integral T>
+    inline constexpr auto from_unorm(const std::array<T, 4>& v){
+        return Vec4{from_unorm(v[0]), from_unorm(v[1]), from_unorm(v[2]), from_unorm(v[3])};
+    }
+
+    namespace detail
+    {
+        // shared body of the snorm/unorm batches: clamp, scale and round
+        // exactly like the scalar path, then narrow
+        template<std::integral T>
+        inline void quantize_batch(std::span<const float> in, std::span<T> out, float LO, float HI){
+            assert(out.size() >= in.size());
+            constexpr auto MAX = float(std::numeric_limits<T>::max());
+            auto lo = simd::splat(LO), hi = simd::splat(HI);
+            auto scale = simd::splat(MAX), half = simd::splat(0.5f);
+
+            size_t i = 0;
+            int32_t lanes[4];
+            for(; i+4 <= in.size(); i += 4){
+                auto x = simd::min(simd::max(simd::load(&in[i]), lo), hi) * scale;
+                simd::store_truncated(lanes, x + simd::copysign(half, x));
+                for(int k=0; k<4; ++k)
+                    out[i+k] = T(lanes[k]);
+            }
+            for(; i < in.size(); ++i)
+                out[i] = T(detail::round_away(std::clamp(in[i], LO, HI) * MAX));
+        }
+        template<std::integral T>
+        inline void dequantize_batch(std::span<const T> in, std::span<float> out, float LO){
+            assert(out.size() >= in.size());
+            constexpr auto MAX = float(std::numeric_limits<T>::max());
+            auto lo = simd::splat(LO), scale = simd::splat(MAX);
+
+            size_t i = 0;
+            int32_t lanes[4];
+            for(; i+4 <= in.size(); i += 4){
+                for(int k=0; k<4; ++k)
+                    lanes[k] = in[i+k];
+                simd::store(&out[i], simd::max(simd::load_converted(lanes) / scale, lo));
+            }
+            for(; i < in.size(); ++i)
+                out[i] = std::max(float(in[i]) / MAX, LO);
+        }
+    }
+
+    // component-wise batches; vector arrays convert through their floats
+    template<std::signed_integral T>
+    inline void to_snorm_batch(std::span<const float> in, std::span<T> out){
+        detail::quantize_batch(in, out, -1.0f, 1.0f);
+    }
+    template<std::signed_integral T>
+    inline void from_snorm_batch(std::span<const T> in, std::span<float> out){
+        detail::dequantize_batch(in, out, -1.0f);
+    }
+    template<std::unsigned_integral T>
+    inline void to_unorm_batch(std::span<const float> in, std::span<T> out){
+        detail::quantize_batch(in, out, 0.0f, 1.0f);
+    }
+    template<std::unsigned_integral T>
+    inline void from_unorm_batch(std::span<const T> in, std::span<float> out){
+        detail::dequantize_batch(in, out, 0.0f);
+    }
+
+    //==========================================================================
+    // Octahedral normals
+    //==========================================================================
+
+    // unit vector folded onto the octahedron, 2 x snorm16 (4 bytes instead of 12).
+    // worst-case angular error is about 0.005 degrees.
+    struct OctNormal{
+        int16_t x, y;
+
+        constexpr bool operator==(const OctNormal&) const = default;
+    }; static_assert(sizeof(OctNormal) == 4);
+
+    // the zero vector has no direction and encodes as +Z
+    inline constexpr OctNormal encode_octahedral(Vec3 n){
+        auto l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if(l1 == 0.0f)
+            return OctNormal{0, 0};
+        auto x = n.x / l1;
+        auto y = n.y / l1;
+        // lower hemisphere folds over the diagonals
+        if(n.z < 0.0f){
+            auto fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            auto fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = fx;
+            y = fy;
+        }
+        return OctNormal{to_snorm<int16_t>(x), to_snorm<int16_t>(y)};
+    }
+    inline Vec3 decode_octahedral(OctNormal oct){
+        auto x = from_snorm(oct.x);
+        auto y = from_snorm(oct.y);
+        auto z = 1.0f - std::abs(x) - std::abs(y);
+        auto t = std::max(-z, 0.0f);
+        x -= std::copysign(t, x);
+        y -= std::copysign(t, y);
+        return normalize(Vec3{x, y, z});
+    }
+
+    inline void encode_octahedral_batch(std::span<const Vec3> in, std::span<OctNormal> out){
+        assert(out.size() >= in.size());
+        using namespace simd;
+
+        auto src = reinterpret_cast<const float*>(in.data());
+        auto one = splat(1.0f), minusOne = splat(-1.0f), zero = splat(0.0f);
+        auto scale = splat(float(std::numeric_limits<int16_t>::max()));
+        auto half = splat(0.5f);
+
+        size_t i = 0;
+        int32_t lanesX[4], lanesY[4];
+        for(; i+4 <= in.size(); i += 4){
+            f32x4 x, y, z;
+            load3x4(src + 3*i, x, y, z);
+            auto l1 = simd::abs(x) + simd::abs(y) + simd::abs(z);
+            // zero vectors divide to (0, 0), +Z like the scalar path
+            l1 = select(equal(l1, zero), one, l1);
+            x = x / l1;
+            y = y / l1;
+
+            // -0 counts as positive, like the scalar x >= 0 test
+            auto lower = less(z, zero);
+            auto fx = (one - simd::abs(y)) * select(less(x, zero), minusOne, one);
+            auto fy = (one - simd::abs(x)) * select(less(y, zero), minusOne, one);
+            x = select(lower, fx, x);
+            y = select(lower, fy, y);
+
+            x = simd::min(simd::max(x, minusOne), one) * scale;
+            y = simd::min(simd::max(y, minusOne), one) * scale;
+            store_truncated(lanesX, x + copysign(half, x));
+            store_truncated(lanesY, y + copysign(half, y));
+            for(int k=0; k<4; ++k)
+                out[i+k] = OctNormal{int16_t(lanesX[k]), int16_t(lanesY[k])};
+        }
+        for(; i < in.size(); ++i)
+            out[i] = encode_octahedral(in[i]);
+    }
+    inline void decode_octahedral_batch(std::span<const OctNormal> in, std::span<Vec3> out){
+        assert(out.size() >= in.size());
+        using namespace simd;
+
+        auto dst = reinterpret_cast<float*>(out.data());
+        auto scale = splat(float(std::numeric_limits<int16_t>::max()));
+        auto minusOne = splat(-1.0f), one = splat(1.0f), zero = splat(0.0f);
+
+        size_t i = 0;
+        int32_t lanesX[4], lanesY[4];
+        for(; i+4 <= in.size(); i += 4){
+            for(int k=0; k<4; ++k){
+                lanesX[k] = in[i+k].x;
+                lanesY[k] = in[i+k].y;
+            }
+            auto x = simd::max(load_converted(lanesX) / scale, minusOne);
+            auto y = simd::max(load_converted(lanesY) / scale, minusOne);
+            auto z = one - simd::abs(x) - simd::abs(y);
+            auto t = simd::max(zero - z, zero);
+            x = x - copysign(t, x);
+            y = y - copysign(t, y);
+
+            auto invLen = one / sqrt(madd(z, z, madd(y, y, x*x)));
+            store3x4(dst + 3*i, x*invLen, y*invLen, z*invLen);
+        }
+        for(; i < in.size(); ++i)
+            out[i] = decode_octahedral(in[i]);
+    }
+
+    //==========================================================================
+    // Smallest-three quaternions
+    //==========================================================================
+
+    // Unit quaternion in 32 bits: 2-bit index of the largest component
+    // (dropped, rebuilt from unit length) and the other three in 10 bits each
+    // over [-1/sqrt2, 1/sqrt2]. q and -q are the same rotation, so the dropped
+    // component is made positive. Max component error ~0.0007.
+    struct PackedQuat{
+        uint32_t bits;
+
+        constexpr bool operator==(const PackedQuat&) const = default;
+    }; static_assert(sizeof(PackedQuat) == 4);
+
+    namespace detail
+    {
+        inline constexpr float QUAT_RANGE = 0.70710678f; // 1/sqrt2
+        inline constexpr uint32_t QUAT_MAX = (1u << 10) - 1;
+    }
+
+    inline constexpr PackedQuat pack_quat(Vec4 q){
+        uint32_t largest = 0;
+        for(uint32_t i=1; i<4; ++i)
+            if(std::abs(q[i]) > std::abs(q[largest]))
+                largest = i;
+        auto sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+        uint32_t bits = largest;
+        for(uint32_t i=0; i<4; ++i){
+            if(i == largest)
+                continue;
+            auto c = std::clamp(q[i] * sign, -detail::QUAT_RANGE, detail::QUAT_RANGE);
+            auto u = uint32_t((c / detail::QUAT_RANGE * 0.5f + 0.5f) * float(detail::QUAT_MAX) + 0.5f);
+            bits = (bits << 10) | u;
+        }
+        return PackedQuat{bits};
+    }
+    inline Vec4 unpack_quat(PackedQuat packed){
+        auto largest = packed.bits >> 30;
+        Vec4 q;
+        float sum = 0.0f;
+        int shift = 20;
+        for(uint32_t i=0; i<4; ++i){
+            if(i == largest)
+                continue;
+            auto u = (packed.bits >> shift) & detail::QUAT_MAX;
+            shift -= 10;
+            q[i] = (float(u) / float(detail::QUAT_MAX) * 2.0f - 1.0f) * detail::QUAT_RANGE;
+            sum += q[i]*q[i];
+        }
+        q[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+        return q;
+    }
+
+    // the largest-component pick is per element, so these stay scalar loops
+    inline void pack_quat_batch(std::span<const Vec4> in, std::span<PackedQuat> out){
+        assert(out.size() >= in.size());
+        for(size_t i=0; i<in.size(); ++i)
+            out[i] = pack_quat(in[i]);
+    }
+    inline void unpack_quat_batch(std::span<const PackedQuat> in, std::span<Vec4> out){
+        assert(out.size() >= in.size());
+        for(size_t i=0; i<in.size(); ++i)
+            out[i] = unpack_quat(in[i]);
+    }
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Backend is picked from the target flags:
+// AVX (-mavx / /arch:AVX2) > SSE2 (every x86-64) > NEON (AArch64) > scalar.
+// define RENDERTOY_NO_SIMD to force the scalar fallback.
+#if defined(RENDERTOY_NO_SIMD)
+    #define RENDERTOY_SIMD_SCALAR 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <immintrin.h>
+    #define RENDERTOY_SIMD_SSE 1
+    #if defined(__AVX__)
+        #define RENDERTOY_SIMD_AVX 1
+    #endif
+    // MSVC has no __FMA__; /arch:AVX2 implies it
+    #if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+        #define RENDERTOY_SIMD_FMA 1
+    #endif
+    // hardware half <-> float; MSVC implies it from /arch:AVX
+    #if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX__))
+        #define RENDERTOY_SIMD_HALF 1
+    #endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define RENDERTOY_SIMD_NEON 1
+    #define RENDERTOY_SIMD_FMA 1
+    #define RENDERTOY_SIMD_HALF 1
+#else
+    #define RENDERTOY_SIMD_SCALAR 1
+#endif
+
+namespace RenderToy::simd
+{
+    // 4 x float in one register. Only the operations the Core math headers need;
+    // every backend gives the same results up to FMA rounding.
+    // Comparisons return lane masks (all bits set / clear) for select().
+    struct f32x4{
+#if defined(RENDERTOY_SIMD_SSE)
+        __m128 v;
+#elif defined(RENDERTOY_SIMD_NEON)
+        float32x4_t v;
+#else
+        float v[4];
+#endif
+    };
+
+#if defined(RENDERTOY_SIMD_SSE)
+    inline f32x4 load(const float* p){ return {_mm_loadu_ps(p)}; }
+    inline void store(float* p, f32x4 a){ _mm_storeu_ps(p, a.v); }
+    inline f32x4 splat(float f){ return {_mm_set1_ps(f)}; }
+    inline f32x4 set(float x, float y, float z, float w){ return {_mm_setr_ps(x, y, z, w)}; }
+
+    inline f32x4 operator+(f32x4 a, f32x4 b){ return {_mm_add_ps(a.v, b.v)}; }
+    inline f32x4 operator-(f32x4 a, f32x4 b){ return {_mm_sub_ps(a.v, b.v)}; }
+    inline f32x4 operator*(f32x4 a, f32x4 b){ return {_mm_mul_ps(a.v, b.v)}; }
+    inline f32x4 operator/(f32x4 a, f32x4 b){ return {_mm_div_ps(a.v, b.v)}; }
+    inline f32x4 sqrt(f32x4 a){ return {_mm_sqrt_ps(a.v)}; }
+    inline f32x4 min(f32x4 a, f32x4 b){ return {_mm_min_ps(a.v, b.v)}; }
+    inline f32x4 max(f32x4 a, f32x4 b){ return {_mm_max_ps(a.v, b.v)}; }
+
+    inline f32x4 abs(f32x4 a){ return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+    // magnitude of mag, sign of sgn
+    inline f32x4 copysign(f32x4 mag, f32x4 sgn){
+        auto signMask = _mm_set1_ps(-0.0f);
+        return {_mm_or_ps(_mm_andnot_ps(signMask, mag.v), _mm_and_ps(signMask, sgn.v))};
+    }
+    inline f32x4 less(f32x4 a, f32x4 b){ return {_mm_cmplt_ps(a.v, b.v)}; }
+    inline f32x4 equal(f32x4 a, f32x4 b){ return {_mm_cmpeq_ps(a.v, b.v)}; }
+    // mask ? a : b
+    inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b){
+        return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+    }
+
+    // int32 conversion, truncating toward zero
+    inline void store_truncated(int32_t* p, f32x4 a){
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_cvttps_epi32(a.v));
+    }
+    inline f32x4 load_converted(const int32_t* p){
+        return {_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))};
+    }
+
+    #if defined(RENDERTOY_SIMD_HALF)
+    inline void store_half(uint16_t* p, f32x4 a){
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_cvtps_ph(a.v, _MM_FROUND_TO_NEAREST_INT));
+    }
+    inline f32x4 load_half(const uint16_t* p){
+        return {_mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)))};
+    }
+    #endif
+
+    // a*b + c
+    inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c){
+    #if defined(RENDERTOY_SIMD_FMA)
+        return {_mm_fmadd_ps(a.v, b.v, c.v)};
+    #else
+        return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)};
+    #endif
+    }
+
+    // result[i] = a[I_i]
+    template<int X, int Y, int Z, int W>
+    inline f32x4 shuffle(f32x4 a){
+        return {_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(W, Z, Y, X))};
+    }
+    // {a[X], a[Y], b[Z], b[W]}
+    template<int X, int Y, int Z, int W>
+    inline f32x4 shuffle(f32x4 a, f32x4 b){
+        return {_mm_shuffle_ps(a.v, b.v, _MM_SHUFFLE(W, Z, Y, X))};
+    }
+
+#elif defined(RENDERTOY_SIMD_NEON)
+    inline f32x4 load(const float* p){ return {vld1q_f32(p)}; }
+    inline void store(float* p, f32x4 a){ vst1q_f32(p, a.v); }
+    inline f32x4 splat(float f){ return {vdupq_n_f32(f)}; }
+    inline f32x4 set(float x, float y, float z, float w){
+        const float lanes[4] = {x, y, z, w};
+        return {vld1q_f32(lanes)};
+    }
+
+    inline f32x4 operator+(f32x4 a, f32x4 b){ return {vaddq_f32(a.v, b.v)}; }
+    inline f32x4 operator-(f32x4 a, f32x4 b){ return {vsubq_f32(a.v, b.v)}; }
+    inline f32x4 operator*(f32x4 a, f32x4 b){ return {vmulq_f32(a.v, b.v)}; }
+    inline f32x4 operator/(f32x4 a, f32x4 b){ return {vdivq_f32(a.v, b.v)}; }
+    inline f32x4 sqrt(f32x4 a){ return {vsqrtq_f32(a.v)}; }
+    inline f32x4 min(f32x4 a, f32x4 b){ return {vminq_f32(a.v, b.v)}; }
+    inline f32x4 max(f32x4 a, f32x4 b){ return {vmaxq_f32(a.v, b.v)}; }
+
+    inline f32x4 abs(f32x4 a){ return {vabsq_f32(a.v)}; }
+    inline f32x4 copysign(f32x4 mag, f32x4 sgn){
+        return {vbslq_f32(vdupq_n_u32(0x80000000u), sgn.v, mag.v)};
+    }
+    inline f32x4 less(f32x4 a, f32x4 b){ return {vreinterpretq_f32_u32(vcltq_f32(a.v, b.v))}; }
+    inline f32x4 equal(f32x4 a, f32x4 b){ return {vreinterpretq_f32_u32(vceqq_f32(a.v, b.v))}; }
+    inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b){
+        return {vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)};
+    }
+
+    inline void store_truncated(int32_t* p, f32x4 a){ vst1q_s32(p, vcvtq_s32_f32(a.v)); }
+    inline f32x4 load_converted(const int32_t* p){ return {vcvtq_f32_s32(vld1q_s32(p))}; }
+
+    inline void store_half(uint16_t* p, f32x4 a){
+        vst1_u16(p, vreinterpret_u16_f16(vcvt_f16_f32(a.v)));
+    }
+    inline f32x4 load_half(const uint16_t* p){
+        return {vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p)))};
+    }
+
+    inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c){ return {vfmaq_f32(c.v, a.v, b.v)}; }
+
+    template<int X, int Y, int Z, int W>
+    inline f32x4 shuffle(f32x4 a){
+    #if defined(__clang__) || defined(__GNUC__)
+        return {__builtin_shufflevector(a.v, a.v, X, Y, Z, W)};
+    #else
+        float lanes[4];
+        vst1q_f32(lanes, a.v);
+        return set(lanes[X], lanes[Y], lanes[Z], lanes[W]);
+    #endif
+    }
+    template<int X, int Y, int Z, int W>
+    inline f32x4 shuffle(f32x4 a, f32x4 b){
+    #if defined(__clang__) || defined(__GNUC__)
+        return {__builtin_shufflevector(a.v, b.v, X, Y, Z+4, W+4)};
+    #else
+        float la[4], lb[4];
+        vst1q_f32(la, a.v);
+        vst1q_f32(lb, b.v);
+        return set(la[X], la[Y], lb[Z], lb[W]);
+    #endif
+    }
+
+#else
+    inline f32x4 load(const float* p){ return {{p[0], p[1], p[2], p[3]}}; }
+    inline void store(float* p, f32x4 a){
+        for(int i=0; i<4; ++i) p[i] = a.v[i];
+    }
+    inline f32x4 splat(float f){ return {{f, f, f, f}}; }
+    inline f32x4 set(float x, float y, float z, float w){ return {{x, y, z, w}}; }
+
+    template<typename Op>
+    inline f32x4 lanewise(f32x4 a, f32x4 b, Op op){
+        return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+    }
+    inline f32x4 operator+(f32x4 a, f32x4 b){ return lanewise(a, b, [](float x, float y){ return x+y; }); }
+    inline f32x4 operator-(f32x4 a, f32x4 b){ return lanewise(a, b, [](float x, float y){ return x-y; }); }
+    inline f32x4 operator*(f32x4 a, f32x4 b){ return lanewise(a, b, [](float x, float y){ return x*y; }); }
+    inline f32x4 operator/(f32x4 a, f32x4 b){ return lanewise(a, b, [](float x, float y){ return x/y; }); }
+    inline f32x4 min(f32x4 a, f32x4 b){ return lanewise(a, b, [](float x, float y){ return x<y ? x : y; }); }
+    inline f32x4 max(f32x4 a, f32x4 b){ return lanewise(a, b, [](float x, float y){ return x>y ? x : y; }); }
+
+    inline f32x4 abs(f32x4 a){ return {{std::abs(a.v[0]), std::abs(a.v[1]), std::abs(a.v[2]), std::abs(a.v[3])}}; }
+    inline f32x4 copysign(f32x4 mag, f32x4 sgn){
+        return lanewise(mag, sgn, [](float x, float y){ return std::copysign(x, y); });
+    }
+    inline f32x4 less(f32x4 a, f32x4 b){
+        return lanewise(a, b, [](float x, float y){ return std::bit_cast<float>(x<y ? ~0u : 0u); });
+    }
+    inline f32x4 equal(f32x4 a, f32x4 b){
+        return lanewise(a, b, [](float x, float y){ return std::bit_cast<float>(x==y ? ~0u : 0u); });
+    }
+    inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b){
+        f32x4 r;
+        for(int i=0; i<4; ++i)
+            r.v[i] = std::bit_cast<uint32_t>(mask.v[i]) ? a.v[i] : b.v[i];
+        return r;
+    }
+
+    inline void store_truncated(int32_t* p, f32x4 a){
+        for(int i=0; i<4; ++i) p[i] = int32_t(a.v[i]);
+    }
+    inline f32x4 load_converted(const int32_t* p){
+        return {{float(p[0]), float(p[1]), float(p[2]), float(p[3])}};
+    }
+    inline f32x4 sqrt(f32x4 a){
+        return {{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}};
+    }
+
+    inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c){ return a*b + c; }
+
+    template<int X, int Y, int Z, int W>
+    inline f32x4 shuffle(f32x4 a){ return {{a.v[X], a.v[Y], a.v[Z], a.v[W]}}; }
+    template<int X, int Y, int Z, int W>
+    inline f32x4 shuffle(f32x4 a, f32x4 b){ return {{a.v[X], a.v[Y], b.v[Z], b.v[W]}}; }
+#endif
+
+    // broadcasts lane I to every lane
+    template<int I>
+    inline f32x4 lane(f32x4 a){ return shuffle<I, I, I, I>(a); }
+
+    // dot product broadcast to every lane
+    inline f32x4 dot4(f32x4 a, f32x4 b){
+        auto m = a * b;
+        auto s = m + shuffle<1, 0, 3, 2>(m);
+        return s + shuffle<2, 3, 0, 1>(s);
+    }
+
+    // AoS <-> SoA for blocks of 4 packed float3 (12 floats)
+    inline void load3x4(const float* p, f32x4& x, f32x4& y, f32x4& z){
+        auto a = load(p);     // x0 y0 z0 x1
+        auto b = load(p + 4); // y1 z1 x2 y2
+        auto c = load(p + 8); // z2 x3 y3 z3
+        x = shuffle<0, 3, 2, 0>(a, shuffle<1, 1, 2, 2>(c, b));
+        y = shuffle<0, 2, 0, 2>(shuffle<1, 1, 0, 0>(a, b), shuffle<3, 3, 2, 2>(b, c));
+        z = shuffle<0, 2, 0, 2>(shuffle<2, 2, 1, 1>(a, b), shuffle<0, 0, 3, 3>(c, c));
+    }
+    inline void store3x4(float* p, f32x4 x, f32x4 y, f32x4 z){
+        store(p,     shuffle<0, 2, 0, 2>(shuffle<0, 0, 0, 0>(x, y), shuffle<0, 0, 1, 1>(z, x)));
+        store(p + 4, shuffle<0, 2, 0, 2>(shuffle<1, 1, 1, 1>(y, z), shuffle<2, 2, 2, 2>(x, y)));
+        store(p + 8, shuffle<0, 2, 0, 2>(shuffle<2, 2, 3, 3>(z, x), shuffle<3, 3, 3, 3>(y, z)));
+    }
+
+    // in-place transpose of 4 rows
+    inline void transpose4(f32x4& r0, f32x4& r1, f32x4& r2, f32x4& r3){
+        auto t0 = shuffle<0, 1, 0, 1>(r0, r1); // 00 01 10 11
+        auto t1 = shuffle<2, 3, 2, 3>(r0, r1); // 02 03 12 13
+        auto t2 = shuffle<0, 1, 0, 1>(r2, r3); // 20 21 30 31
+        auto t3 = shuffle<2, 3, 2, 3>(r2, r3); // 22 23 32 33
+        r0 = shuffle<0, 2, 0, 2>(t0, t2);
+        r1 = shuffle<1, 3, 1, 3>(t0, t2);
+        r2 = shuffle<0, 2, 0, 2>(t1, t3);
+        r3 = shuffle<1, 3, 1, 3>(t1, t3);
+    }
+
+    // Hamilton product, (x, y, z, w) layout
+    inline f32x4 quat_mul(f32x4 a, f32x4 b){
+        auto r = lane<3>(a) * b;
+        r = madd(lane<0>(a), shuffle<3, 2, 1, 0>(b) * set( 1.0f, -1.0f,  1.0f, -1.0f), r);
+        r = madd(lane<1>(a), shuffle<2, 3, 0, 1>(b) * set( 1.0f,  1.0f, -1.0f, -1.0f), r);
+        r = madd(lane<2>(a), shuffle<1, 0, 3, 2>(b) * set(-1.0f,  1.0f,  1.0f, -1.0f), r);
+        return r;
+    }
+
+    // out = lhs * rhs over row-major 4x4 floats; out may alias either input.
+    // row i of out is sum_k lhs[i][k] * rhs row k
+    inline void mat4_mul(const float* lhs, const float* rhs, float* out){
+#if defined(RENDERTOY_SIMD_AVX)
+        // two output rows per register
+        auto b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs));
+        auto b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 4));
+        auto b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 8));
+        auto b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 12));
+        auto rows = [&](__m256 a){
+            auto r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+    #if defined(RENDERTOY_SIMD_FMA)
+            r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0x55), b1, r);
+            r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xAA), b2, r);
+            r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xFF), b3, r);
+    #else
+            r = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), b1), r);
+            r = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xAA), b2), r);
+            r = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xFF), b3), r);
+    #endif
+            return r;
+        };
+        auto r01 = rows(_mm256_loadu_ps(lhs));
+        auto r23 = rows(_mm256_loadu_ps(lhs + 8));
+        _mm256_storeu_ps(out, r01);
+        _mm256_storeu_ps(out + 8, r23);
+#else
+        auto b0 = load(rhs);
+        auto b1 = load(rhs + 4);
+        auto b2 = load(rhs + 8);
+        auto b3 = load(rhs + 12);
+        auto row = [&](f32x4 a){
+            auto r = lane<0>(a) * b0;
+            r = madd(lane<1>(a), b1, r);
+            r = madd(lane<2>(a), b2, r);
+            return madd(lane<3>(a), b3, r);
+        };
+        // every row is computed before the first store, for aliasing
+        auto r0 = row(load(lhs));
+        auto r1 = row(load(lhs + 4));
+        auto r2 = row(load(lhs + 8));
+        auto r3 = row(load(lhs + 12));
+        store(out, r0);
+        store(out + 4, r1);
+        store(out + 8, r2);
+        store(out + 12, r3);
+#endif
+    }
+}
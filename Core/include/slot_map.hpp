@@ -1,17 +1,23 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
 #include <format>
 #include <new>
 #include <ranges>
+#include <span>
 #include <vector>
+#include "chunk_storage.hpp"
+#include "compiler.hpp"
 #include "generic_handle.hpp"
 #include "math.hpp"
 #include "core_types.hpp"
 
 namespace RenderToy
 {
-    template<typename T>
+    // Storage selects growth of the slot array. stable storages
+    // (paged_storage, virtual_storage) never move live values.
+    template<typename T, typename Storage = contiguous_storage>
     class slot_map{
     private:
         using Handle = generic_handle<T>;
@@ -22,27 +28,34 @@ namespace RenderToy
 
             T* get(){ return std::launder(reinterpret_cast<T*>(&storage)); }
             const T* get() const{ return std::launder(reinterpret_cast<const T*>(&storage)); }
+            // push/remove both bump generation, so odd means live
+            bool alive() const{ return generation & 1; }
 
             Slot() = default;
+            // std::vector growth must move the value, not its bytes
+            Slot(Slot&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            :generation(other.generation){
+                if(alive())
+                    std::construct_at(get(), std::move(*other.get()));
+            }
+            Slot& operator=(Slot&&) = delete;
+            ~Slot(){
+                if(alive())
+                    std::destroy_at(get());
+            }
         };
-        std::vector<Slot> slots;
+        using Slots = std::conditional_t<Storage::stable,
+            stable_vector<Slot, Storage>, std::vector<Slot>>;
+        Slots slots;
         using Indexes = std::vector<Index>;
         Indexes freeIndexes;
+        // generation of slots trimmed by shrink_to_fit(), so a regrown
+        // slot never revives a stale handle
+        uint32_t retiredGeneration = 0;
 
     public:
         slot_map() = default;
-        ~slot_map(){
-            std::sort(freeIndexes.begin(), freeIndexes.end());
-
-            Index freeIdxPtr = 0;
-            for(Index i=0; i<slots.size(); ++i){
-                if(freeIdxPtr<freeIndexes.size() && freeIndexes[freeIdxPtr]==i){
-                    ++freeIdxPtr;
-                    continue;
-                }
-                std::destroy_at(slots[i].get());
-            }
-        }
+        ~slot_map() = default;
 
         Handle push(T&& t){
             Index freeIndex = std::numeric_limits<uint32_t>::max();
@@ -52,7 +65,7 @@ namespace RenderToy
                 freeIndexes.resize(freeIndexes.size() - 1);
             }
             else{
-                slots.resize(slots.size() + 1);
+                growSlots(slots.size() + 1);
                 freeIndex = slots.size() - 1;
             }
             std::construct_at(slots[freeIndex].get(), std::move(t));
@@ -69,65 +82,105 @@ namespace RenderToy
             return push(T(std::forward<Args>(args)...));
         }
 
+        // moves every value in, writes handles to out (out.size() >= values.size())
+        std::span<Handle> push_range(std::span<T> values, std::span<Handle> out){
+            assert(out.size() >= values.size());
+            if(values.size() > freeIndexes.size())
+                reserve(slots.size() + values.size() - freeIndexes.size());
+
+            for(Index i=0; i<values.size(); ++i)
+                out[i] = push(std::move(values[i]));
+            return out.first(values.size());
+        }
+
         void remove(Handle handle){
-            if( (handle.index >= slots.size()) ||
-                (slots[handle.index].generation != handle.generation)
-            )
-                throw std::out_of_range(std::format(
-                    "Handle(Index={}) generation {} is mismatched. (valid generation={})",
-                    handle.index, handle.generation, slots[handle.index].generation
-                ));
+            if(!contains(handle)) [[unlikely]]
+                throwMismatch(handle);
             ++slots[handle.index].generation;
             std::destroy_at(slots[handle.index].get());
             freeIndexes.push_back(handle.index);
         }
 
-        void clear(){
-            std::sort(freeIndexes.begin(), freeIndexes.end());
-
-            Index freeIdxPtr = 0;
-            for(Index i=0; i<slots.size(); ++i){
-                if(freeIdxPtr<freeIndexes.size() && freeIndexes[freeIdxPtr]==i){
-                    ++freeIdxPtr;
-                    continue;
-                }
-                std::destroy_at(slots[i].get());
-            }
+        void remove_range(std::span<const Handle> handles){
+            freeIndexes.reserve(freeIndexes.size() + handles.size());
+            for(auto handle: handles)
+                remove(handle);
+        }
 
+        void clear(){
             freeIndexes.clear();
             for(Index i=0; i<slots.size(); ++i){
-                ++slots[i].generator;
+                if(slots[i].alive()){
+                    std::destroy_at(slots[i].get());
+                    ++slots[i].generation;
+                }
                 freeIndexes.push_back(i);
             }
         }
 
+        bool contains(Handle handle) const{
+            return handle.index < slots.size() &&
+                slots[handle.index].generation == handle.generation;
+        }
+
+        // checked: throws std::out_of_range on stale handle
         T& operator[](Handle handle){
-            if( (handle.index > slots.size()) ||
-                (slots[handle.index].generation != handle.generation)
-            )
-                throw std::out_of_range(std::format(
-                    "Handle(Index={}) generation {} is mismatched. (valid generation={})",
-                    handle.index, handle.generation, slots[handle.index].generation
-                ));
+            if(!contains(handle)) [[unlikely]]
+                throwMismatch(handle);
             return *slots[handle.index].get();
         }
         const T& operator[](Handle handle) const{
-            if( (handle.index > slots.size()) ||
-                (slots[handle.index].generation != handle.generation)
-            )
-                throw std::out_of_range(std::format(
-                    "Handle(Index={}) generation {} is mismatched. (valid generation={})",
-                    handle.index, handle.generation, slots[handle.index].generation
-                ));
+            if(!contains(handle)) [[unlikely]]
+                throwMismatch(handle);
+            return *slots[handle.index].get();
+        }
+
+        // nullptr on stale handle, never throws
+        T* try_get(Handle handle) noexcept{
+            return contains(handle) ? slots[handle.index].get() : nullptr;
+        }
+        const T* try_get(Handle handle) const noexcept{
+            return contains(handle) ? slots[handle.index].get() : nullptr;
+        }
+
+        // validated by assert only; release build is a single indexed load
+        T& get_unchecked(Handle handle) noexcept{
+            assert(contains(handle) && "stale handle");
+            return *slots[handle.index].get();
+        }
+        const T& get_unchecked(Handle handle) const noexcept{
+            assert(contains(handle) && "stale handle");
             return *slots[handle.index].get();
         }
 
+        // grows slot array and puts new slots on the free list,
+        // lowest index popped first
         void reserve(size_t size){
             if(size <= slots.size())
                 return;
-            for(auto i=slots.size(); i<size; ++i)
-                freeIndexes.push_back(i);
-            slots.resize(size);
+            auto oldSize = slots.size();
+            growSlots(size);
+
+            freeIndexes.reserve(freeIndexes.size() + (size - oldSize));
+            for(auto i=size; i>oldSize; --i)
+                freeIndexes.push_back(i - 1);
+        }
+
+        // drops trailing dead slots and rebuilds the free list in index order
+        void shrink_to_fit(){
+            while(slots.size() > 0 && !slots[slots.size() - 1].alive()){
+                retiredGeneration = std::max(retiredGeneration, slots[slots.size() - 1].generation);
+                slots.resize(slots.size() - 1);
+            }
+
+            freeIndexes.clear();
+            for(auto i=slots.size(); i>0; --i){
+                if(!slots[i - 1].alive())
+                    freeIndexes.push_back(i - 1);
+            }
+            freeIndexes.shrink_to_fit();
+            if constexpr(!Storage::stable)
+                slots.shrink_to_fit();
         }
 
         size_t size() const{
@@ -136,5 +189,27 @@ namespace RenderToy
         size_t capacity() const{
             return slots.size();
         }
+
+    private:
+        // geometric growth, new slots start past any retired generation
+        void growSlots(size_t size){
+            if constexpr(!Storage::stable){
+                if(size > slots.capacity())
+                    slots.reserve(std::max(size, 2*slots.capacity()));
+            }
+            auto oldSize = slots.size();
+            slots.resize(size);
+            for(auto i=oldSize; i<size; ++i)
+                slots[i].generation = retiredGeneration;
+        }
+
+        [[noreturn]] RENDERTOY_COLD_PATH
+        void throwMismatch(Handle handle) const{
+            throw std::out_of_range(std::format(
+                "Handle(Index={}) generation {} is mismatched. (valid generation={})",
+                handle.index, handle.generation,
+                handle.index < slots.size() ? slots[handle.index].generation : 0
+            ));
+        }
     };
 }
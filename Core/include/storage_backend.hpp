@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include "aligned_alloc.hpp"
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace RenderToy
+{
+    // Raw memory backends for chunk storages.
+    // alignment is what every returned block is aligned to.
+    // reallocate() keeps the first min(old_bytes, new_bytes) bytes.
+    template<typename B>
+    concept storage_backend = requires(B b, void* ptr, size_t bytes){
+        { B::alignment } -> std::convertible_to<size_t>;
+        { b.allocate(bytes) } -> std::same_as<void*>;
+        { b.reallocate(ptr, bytes, bytes) } -> std::same_as<void*>;
+        { b.deallocate(ptr, bytes) } -> std::same_as<void>;
+    };
+
+    namespace detail
+    {
+        template<typename B>
+        void* move_reallocate(B& backend, void* ptr, size_t old_bytes, size_t new_bytes){
+            auto new_ptr = backend.allocate(new_bytes);
+            if(new_ptr != nullptr && ptr != nullptr){
+                std::memcpy(new_ptr, ptr, std::min(old_bytes, new_bytes));
+                backend.deallocate(ptr, old_bytes);
+            }
+            return new_ptr;
+        }
+    }
+
+    // plain malloc/realloc, 16-byte alignment. realloc may grow in place (mremap).
+    struct malloc_backend{
+        static constexpr size_t alignment = alignof(std::max_align_t);
+
+        void* allocate(size_t bytes){ return std::malloc(bytes); }
+        void* reallocate(void* ptr, size_t, size_t new_bytes){ return std::realloc(ptr, new_bytes); }
+        void deallocate(void* ptr, size_t){ std::free(ptr); }
+    };
+
+    // ALIGN-aligned blocks (cache line by default); rows are aligned too
+    // when the row size is a multiple of ALIGN
+    template<size_t ALIGN = CACHE_LINE_SIZE>
+    struct aligned_backend{
+        static_assert(std::has_single_bit(ALIGN), "ALIGN must be power of 2");
+        static constexpr size_t alignment = ALIGN;
+
+        void* allocate(size_t bytes){ return aligned_malloc(bytes, ALIGN); }
+        void* reallocate(void* ptr, size_t old_bytes, size_t new_bytes){
+            return detail::move_reallocate(*this, ptr, old_bytes, new_bytes);
+        }
+        void deallocate(void* ptr, size_t){ aligned_free(ptr); }
+    };
+
+    // aligned_backend which asks for transparent huge pages once a block
+    // reaches THRESHOLD bytes. cuts TLB misses on large archetypes.
+    // madvise is a hint only; platforms without it get plain aligned blocks.
+    template<size_t ALIGN = CACHE_LINE_SIZE, size_t THRESHOLD = size_t(2) << 20>
+    struct huge_page_backend{
+        static constexpr size_t alignment = ALIGN;
+        static constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+        void* allocate(size_t bytes){
+            if(bytes < THRESHOLD)
+                return aligned_malloc(bytes, ALIGN);
+
+            auto rounded = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            auto ptr = aligned_malloc(rounded, std::max(ALIGN, HUGE_PAGE_SIZE));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            if(ptr != nullptr)
+                madvise(ptr, rounded, MADV_HUGEPAGE);
+#endif
+            return ptr;
+        }
+        void* reallocate(void* ptr, size_t old_bytes, size_t new_bytes){
+            return detail::move_reallocate(*this, ptr, old_bytes, new_bytes);
+        }
+        void deallocate(void* ptr, size_t){ aligned_free(ptr); }
+    };
+
+    // forwards to a std::pmr::memory_resource (arenas, pools, ...).
+    // the resource must outlive every storage using it.
+    template<size_t ALIGN = CACHE_LINE_SIZE>
+    struct pmr_backend{
+        static constexpr size_t alignment = ALIGN;
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+
+        void* allocate(size_t bytes){ return resource->allocate(bytes, ALIGN); }
+        void* reallocate(void* ptr, size_t old_bytes, size_t new_bytes){
+            return detail::move_reallocate(*this, ptr, old_bytes, new_bytes);
+        }
+        void deallocate(void* ptr, size_t bytes){
+            if(ptr != nullptr)
+                resource->deallocate(ptr, bytes, ALIGN);
+        }
+    };
+
+    static_assert(storage_backend<malloc_backend>);
+    static_assert(storage_backend<aligned_backend<>>);
+    static_assert(storage_backend<huge_page_backend<>>);
+    static_assert(storage_backend<pmr_backend<>>);
+}
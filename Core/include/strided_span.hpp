@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include "core_types.hpp"
+#include "ptr_util.hpp"
+
+namespace RenderToy
+{
+    // View of `count` T's placed every `stride` bytes: one field of an
+    // array of structs, e.g. one component column of an AoS chunk array.
+    // stride == sizeof(T) is an ordinary contiguous span.
+    template<typename T>
+    class strided_span{
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using void_pointer = std::conditional_t<std::is_const_v<T>, const void*, void*>;
+
+        class iterator{
+        private:
+            void_pointer ptr = nullptr;
+            std::ptrdiff_t stride = 0;
+
+        public:
+            using iterator_concept = std::random_access_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = strided_span::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            iterator() = default;
+            iterator(void_pointer ptr, size_t stride)
+            :ptr(ptr), stride(std::ptrdiff_t(stride)){}
+
+            T& operator*() const{ return *static_cast<T*>(ptr); }
+            T* operator->() const{ return static_cast<T*>(ptr); }
+            T& operator[](difference_type n) const{ return *(*this + n); }
+
+            iterator& operator++(){ ptr = step(ptr, stride); return *this; }
+            iterator& operator--(){ ptr = step(ptr, -stride); return *this; }
+            iterator operator++(int){ auto old = *this; ++*this; return old; }
+            iterator operator--(int){ auto old = *this; --*this; return old; }
+            iterator& operator+=(difference_type n){ ptr = step(ptr, n * stride); return *this; }
+            iterator& operator-=(difference_type n){ ptr = step(ptr, -n * stride); return *this; }
+
+            friend iterator operator+(iterator it, difference_type n){ return it += n; }
+            friend iterator operator+(difference_type n, iterator it){ return it += n; }
+            friend iterator operator-(iterator it, difference_type n){ return it -= n; }
+            friend difference_type operator-(const iterator& lhs, const iterator& rhs){
+                assert(lhs.stride == rhs.stride);
+                auto bytes = static_cast<const std::byte*>(lhs.ptr) - static_cast<const std::byte*>(rhs.ptr);
+                return lhs.stride == 0 ? 0 : bytes / lhs.stride;
+            }
+            friend bool operator==(const iterator& lhs, const iterator& rhs){ return lhs.ptr == rhs.ptr; }
+            friend auto operator<=>(const iterator& lhs, const iterator& rhs){
+                return static_cast<const std::byte*>(lhs.ptr) <=> static_cast<const std::byte*>(rhs.ptr);
+            }
+
+        private:
+            static void_pointer step(void_pointer ptr, std::ptrdiff_t bytes){
+                using byte_pointer = std::conditional_t<std::is_const_v<T>, const std::byte*, std::byte*>;
+                return static_cast<byte_pointer>(ptr) + bytes;
+            }
+        };
+
+    private:
+        void_pointer first = nullptr;
+        size_t count = 0;
+        size_t stride_ = sizeof(T);
+
+    public:
+        strided_span() = default;
+        strided_span(void_pointer first, size_t count, size_t stride)
+        :first(first), count(count), stride_(stride){
+            assert(stride >= sizeof(T) || count <= 1);
+        }
+        strided_span(std::span<T> span)
+        :first(span.data()), count(span.size()){}
+
+        T& operator[](Index index) const{
+            assert(index < count);
+            return *static_cast<T*>(ptrAdd(first, index*stride_));
+        }
+        T& front() const{ return (*this)[0]; }
+        T& back() const{ return (*this)[count - 1]; }
+
+        size_t size() const{ return count; }
+        bool empty() const{ return count == 0; }
+        size_t stride() const{ return stride_; }
+        T* data() const{ return static_cast<T*>(first); }
+
+        iterator begin() const{ return {first, stride_}; }
+        iterator end() const{ return {ptrAdd(first, count*stride_), stride_}; }
+
+        strided_span subspan(Index offset, size_t n) const{
+            assert(offset + n <= count);
+            return {ptrAdd(first, offset*stride_), n, stride_};
+        }
+
+        // true when the elements are packed, i.e. as_span() is valid
+        bool contiguous() const{ return stride_ == sizeof(T) || count <= 1; }
+        std::span<T> as_span() const{
+            assert(contiguous());
+            return {data(), count};
+        }
+    };
+}
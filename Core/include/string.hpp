@@ -2,14 +2,24 @@
 
 #include <algorithm>
 #include <string>
+#include <string_view>
 
 namespace RenderToy
 {
-    inline std::string toUpper(const std::string& text){
-        std::string upper = text;
-        std::transform(text.begin(), text.end(), upper.begin(),
+    inline std::string toUpper(std::string text){
+        std::transform(text.begin(), text.end(), text.begin(),
             [](unsigned char c){ return std::toupper(c); }
         );
-        return upper;
+        return text;
     }
-}
\ No newline at end of file
+
+    // ASCII-only, no allocation
+    inline constexpr bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs){
+        constexpr auto upper = [](char c){
+            return c >= 'a' && c <= 'z' ? char(c - 'a' + 'A') : c;
+        };
+        return lhs.size() == rhs.size() &&
+            std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+                [&](char l, char r){ return upper(l) == upper(r); });
+    }
+}
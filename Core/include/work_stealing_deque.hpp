@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace RenderToy
+{
+    // Chase-Lev work-stealing deque of pointers (Lê et al., "Correct and
+    // Efficient Work-Stealing for Weak Memory Models", 2013).
+    // - push() / take(): owner thread only, at the bottom (LIFO)
+    // - steal(): any thread, at the top (FIFO); nullptr when empty or
+    //   when it lost a race, so thieves just move on
+    // The ring doubles when full. Old rings stay alive until the deque is
+    // destroyed, since a thief may still be reading one.
+    template<typename T>
+    class work_stealing_deque{
+        static_assert(std::is_pointer_v<T>, "stores pointers: nullptr means empty");
+
+    private:
+        struct ring{
+            const int64_t capacity;
+            const int64_t mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+
+            explicit ring(int64_t capacity)
+            :capacity(capacity), mask(capacity - 1), slots(new std::atomic<T>[capacity]){
+                assert((capacity & mask) == 0 && "capacity must be a power of 2");
+            }
+            T get(int64_t i) const{ return slots[i & mask].load(std::memory_order_relaxed); }
+            void put(int64_t i, T value){ slots[i & mask].store(value, std::memory_order_relaxed); }
+        };
+
+        alignas(64) std::atomic<int64_t> top = 0;
+        alignas(64) std::atomic<int64_t> bottom = 0;
+        alignas(64) std::atomic<ring*> current;
+        // every ring ever used; touched by the owner only
+        std::vector<std::unique_ptr<ring>> rings;
+
+    public:
+        explicit work_stealing_deque(int64_t capacity = 1024){
+            rings.push_back(std::make_unique<ring>(capacity));
+            current.store(rings.back().get(), std::memory_order_relaxed);
+        }
+        work_stealing_deque(const work_stealing_deque&) = delete;
+        work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+        void push(T value){
+            auto b = bottom.load(std::memory_order_relaxed);
+            auto t = top.load(std::memory_order_acquire);
+            auto r = current.load(std::memory_order_relaxed);
+            if(b - t > r->capacity - 1)
+                r = grow(r, t, b);
+            r->put(b, value);
+            // publishes the slot, and whatever `value` points to
+            bottom.store(b + 1, std::memory_order_release);
+        }
+
+        T take(){
+            auto b = bottom.load(std::memory_order_relaxed) - 1;
+            auto r = current.load(std::memory_order_relaxed);
+            // seq_cst store/load pair instead of the paper's fence, which
+            // thread sanitizers don't model
+            bottom.store(b, std::memory_order_seq_cst);
+            auto t = top.load(std::memory_order_seq_cst);
+
+            if(t > b){
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            auto value = r->get(b);
+            if(t == b){
+                // last element: race the thieves for it
+                if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    value = nullptr;
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return value;
+        }
+
+        T steal(){
+            auto t = top.load(std::memory_order_seq_cst);
+            auto b = bottom.load(std::memory_order_seq_cst);
+            if(t >= b)
+                return nullptr;
+
+            auto value = current.load(std::memory_order_acquire)->get(t);
+            if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+            return value;
+        }
+
+        // a snapshot; exact only on the owner while nobody steals
+        int64_t size() const{
+            auto b = bottom.load(std::memory_order_relaxed);
+            auto t = top.load(std::memory_order_relaxed);
+            return b > t ? b - t : 0;
+        }
+        bool empty() const{ return size() == 0; }
+
+    private:
+        ring* grow(ring* old, int64_t t, int64_t b){
+            rings.push_back(std::make_unique<ring>(old->capacity * 2));
+            auto bigger = rings.back().get();
+            for(auto i = t; i < b; ++i)
+                bigger->put(i, old->get(i));
+            current.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+    };
+}
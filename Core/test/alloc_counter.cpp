@@ -0,0 +1,53 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "alloc_counter.hpp"
+
+namespace
+{
+    std::atomic<size_t> g_allocations = 0;
+
+    void* countedAlloc(size_t size){
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        if(auto ptr = std::malloc(size == 0 ? 1 : size))
+            return ptr;
+        throw std::bad_alloc();
+    }
+    void* countedAlloc(size_t size, std::align_val_t align){
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        auto alignment = static_cast<size_t>(align);
+        auto rounded = (size + alignment - 1) / alignment * alignment;
+#if defined(_MSC_VER)
+        if(auto ptr = _aligned_malloc(rounded == 0 ? alignment : rounded, alignment))
+#else
+        if(auto ptr = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded))
+#endif
+            return ptr;
+        throw std::bad_alloc();
+    }
+    void alignedFree(void* ptr){
+#if defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+size_t RenderToy::test::allocationCount(){
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size){ return countedAlloc(size); }
+void* operator new[](size_t size){ return countedAlloc(size); }
+void* operator new(size_t size, std::align_val_t align){ return countedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align){ return countedAlloc(size, align); }
+
+void operator delete(void* ptr) noexcept{ std::free(ptr); }
+void operator delete[](void* ptr) noexcept{ std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept{ std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept{ std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept{ alignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept{ alignedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept{ alignedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept{ alignedFree(ptr); }
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+namespace RenderToy::test
+{
+    // global operator new calls since program start (see alloc_counter.cpp)
+    size_t allocationCount();
+
+    // counts operator new calls made while alive
+    class AllocationScope{
+    private:
+        size_t begin;
+
+    public:
+        AllocationScope():begin(allocationCount()){}
+
+        size_t count() const{ return allocationCount() - begin; }
+    };
+}
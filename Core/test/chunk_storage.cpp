@@ -0,0 +1,117 @@
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "dynamic_vector.hpp"
+#include "slot_map.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    constexpr size_t STRESS_COUNT = 200000;
+
+    template<typename Storage>
+    void stressDynamicVector(){
+        basic_dynamic_vector<Storage> vec(sizeof(uint64_t));
+        std::vector<void*> addresses;
+        addresses.reserve(STRESS_COUNT);
+
+        for(size_t i=0; i<STRESS_COUNT; ++i){
+            vec.emplace(uint64_t(i));
+            addresses.push_back(vec[i]);
+        }
+        ASSERT_EQ(vec.size(), STRESS_COUNT);
+        for(size_t i=0; i<STRESS_COUNT; ++i){
+            ASSERT_EQ(vec[i], addresses[i]);
+            ASSERT_EQ(*static_cast<uint64_t*>(vec[i]), i);
+        }
+
+        // swap_remove across page boundaries
+        while(vec.size() > 1)
+            vec.swap_remove(0);
+        EXPECT_EQ(*static_cast<uint64_t*>(vec[0]), 1u);
+    }
+}
+
+TEST(chunk_storage, PagedDynamicVectorStress){
+    stressDynamicVector<paged_storage<>>();
+}
+
+TEST(chunk_storage, SmallPageDynamicVectorStress){
+    stressDynamicVector<paged_storage<64>>();
+}
+
+TEST(chunk_storage, VirtualDynamicVectorStress){
+    stressDynamicVector<virtual_storage<>>();
+}
+
+TEST(chunk_storage, PagedIteratorCrossesPages){
+    basic_dynamic_vector<paged_storage<64>> vec(sizeof(int));
+    for(int i=0; i<100; ++i)
+        vec.emplace(int(i));
+
+    int expected = 0;
+    for(auto it = vec.begin(); it != vec.end(); ++it){
+        EXPECT_EQ(*static_cast<int*>(*it), expected);
+        ++expected;
+    }
+    EXPECT_EQ(expected, 100);
+}
+
+TEST(chunk_storage, PagedSlotMapStress){
+    slot_map<std::string, paged_storage<>> map;
+    std::vector<generic_handle<std::string>> handles;
+    std::vector<const std::string*> addresses;
+
+    for(size_t i=0; i<STRESS_COUNT; ++i){
+        handles.push_back(map.push(std::to_string(i)));
+        addresses.push_back(&map[handles.back()]);
+    }
+    for(size_t i=0; i<STRESS_COUNT; ++i){
+        ASSERT_EQ(&map[handles[i]], addresses[i]);
+        ASSERT_EQ(map[handles[i]], std::to_string(i));
+    }
+
+    for(size_t i=0; i<STRESS_COUNT; i+=2)
+        map.remove(handles[i]);
+    EXPECT_EQ(map.size(), STRESS_COUNT/2);
+    for(size_t i=1; i<STRESS_COUNT; i+=2)
+        ASSERT_EQ(map[handles[i]], std::to_string(i));
+}
+
+namespace
+{
+    template<typename Storage>
+    void checkAlignedGrowth(basic_dynamic_vector<Storage>& vec){
+        for(uint64_t i=0; i<10000; ++i){
+            vec.emplace(uint64_t(i), uint64_t(i*2));
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(vec[0]) % Storage::alignment, 0u);
+        }
+        for(uint64_t i=0; i<10000; ++i)
+            ASSERT_EQ(static_cast<uint64_t*>(vec[i])[1], i*2);
+    }
+}
+
+TEST(chunk_storage, AlignedStorageKeepsCacheLineAlignment){
+    static_assert(aligned_storage::alignment == CACHE_LINE_SIZE);
+    aligned_dynamic_vector vec(2*sizeof(uint64_t));
+    checkAlignedGrowth(vec);
+}
+
+TEST(chunk_storage, HugePageStorageCrossesThreshold){
+    // small threshold so the huge page path is taken early
+    basic_dynamic_vector<basic_contiguous_storage<huge_page_backend<64, 4096>>> vec(2*sizeof(uint64_t));
+    checkAlignedGrowth(vec);
+}
+
+TEST(chunk_storage, PmrBackendUsesResource){
+    std::pmr::monotonic_buffer_resource arena;
+    basic_dynamic_vector<basic_contiguous_storage<pmr_backend<>>> vec(
+        2*sizeof(uint64_t), 0, pmr_backend<>{&arena});
+    checkAlignedGrowth(vec);
+
+    paged_storage<4096, pmr_backend<>> pages(sizeof(uint64_t), pmr_backend<>{&arena});
+    pages.reserve(1000);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pages.at(512)) % CACHE_LINE_SIZE, 0u);
+}
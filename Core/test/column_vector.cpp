@@ -0,0 +1,72 @@
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "column_vector.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    struct Wide{
+        double data[3];
+    };
+    constexpr std::array<size_t, 3> SIZES = {sizeof(uint32_t), sizeof(float), sizeof(Wide)};
+}
+
+TEST(column_vector, ColumnsAreCacheLineAligned){
+    column_vector vec(SIZES, 5);
+    EXPECT_EQ(vec.column_count(), 3u);
+    EXPECT_GE(vec.capacity(), 5u);
+    for(Index i=0; i<vec.column_count(); ++i)
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(vec.column(i)) % CACHE_LINE_SIZE, 0u);
+}
+
+TEST(column_vector, EmplaceWritesEveryColumn){
+    column_vector vec(SIZES);
+    for(uint32_t i=0; i<100; ++i)
+        vec.emplace(i, float(i)*0.5f, Wide{{double(i), 0.0, 1.0}});
+    ASSERT_EQ(vec.size(), 100u);
+
+    auto ids = vec.column<uint32_t>(0);
+    auto halves = vec.column<float>(1);
+    auto wides = vec.column<Wide>(2);
+    ASSERT_EQ(ids.size(), 100u);
+    for(uint32_t i=0; i<100; ++i){
+        EXPECT_EQ(ids[i], i);
+        EXPECT_EQ(halves[i], float(i)*0.5f);
+        EXPECT_EQ(wides[i].data[0], double(i));
+    }
+    // growth keeps alignment
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(wides.data()) % CACHE_LINE_SIZE, 0u);
+}
+
+TEST(column_vector, SwapRemoveKeepsColumnsInSync){
+    column_vector vec(SIZES);
+    for(uint32_t i=0; i<4; ++i)
+        vec.emplace(i, float(i), Wide{{double(i)}});
+
+    vec.swap_remove(1);
+    ASSERT_EQ(vec.size(), 3u);
+    EXPECT_EQ(vec.column<uint32_t>(0)[1], 3u);
+    EXPECT_EQ(vec.column<float>(1)[1], 3.0f);
+    EXPECT_EQ(vec.column<Wide>(2)[1].data[0], 3.0);
+
+    // removing the last row leaves the others untouched
+    vec.swap_remove(2);
+    ASSERT_EQ(vec.size(), 2u);
+    EXPECT_EQ(vec.column<uint32_t>(0)[0], 0u);
+    EXPECT_EQ(vec.column<uint32_t>(0)[1], 3u);
+
+    vec.clear();
+    EXPECT_EQ(vec.size(), 0u);
+    EXPECT_TRUE(vec.column<float>(1).empty());
+}
+
+TEST(column_vector, EmplaceBackReturnsRow){
+    column_vector vec(SIZES);
+    auto row = vec.emplace_back();
+    EXPECT_EQ(row, 0u);
+    *static_cast<float*>(vec.at(1, row)) = 2.0f;
+    EXPECT_EQ(vec.column<float>(1)[0], 2.0f);
+    EXPECT_EQ(vec.emplace_back(), 1u);
+}
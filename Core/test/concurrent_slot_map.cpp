@@ -0,0 +1,82 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "concurrent_slot_map.hpp"
+
+using RenderToy::concurrent_slot_map;
+using RenderToy::generic_handle;
+
+TEST(concurrent_slot_map, PushAndGet){
+    concurrent_slot_map<std::string> map;
+    auto h0 = map.push("a");
+    auto h1 = map.push("b");
+
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map[h0], "a");
+    EXPECT_EQ(*map.get(h1), "b");
+}
+
+TEST(concurrent_slot_map, StaleHandle){
+    concurrent_slot_map<int> map;
+    auto h0 = map.push(1);
+    map.remove(h0);
+
+    EXPECT_EQ(map.get(h0), nullptr);
+    EXPECT_THROW(map[h0], std::out_of_range);
+    EXPECT_THROW(map.remove(h0), std::out_of_range);
+
+    auto h1 = map.push(2);
+    EXPECT_EQ(h0.index, h1.index);
+    EXPECT_NE(h0.generation, h1.generation);
+    EXPECT_EQ(map[h1], 2);
+}
+
+TEST(concurrent_slot_map, GrowthKeepsAddress){
+    concurrent_slot_map<int, 16> map;
+    auto h0 = map.push(42);
+    auto p0 = map.get(h0);
+
+    for(int i=0; i<1000; ++i)
+        map.push(int(i));
+
+    EXPECT_EQ(map.get(h0), p0);
+    EXPECT_EQ(*p0, 42);
+}
+
+TEST(concurrent_slot_map, ConcurrentPushRemove){
+    constexpr int NUM_THREADS = 8;
+    constexpr int NUM_OPS = 20000;
+
+    concurrent_slot_map<int, 256> map;
+    std::atomic<int> mismatches = 0;
+    std::vector<std::thread> threads;
+
+    for(int t=0; t<NUM_THREADS; ++t){
+        threads.emplace_back([&, t]{
+            std::vector<generic_handle<int>> owned;
+            for(int i=0; i<NUM_OPS; ++i){
+                auto value = t*NUM_OPS + i;
+                owned.push_back(map.push(int(value)));
+
+                // churn half of them to exercise the free list
+                if(i % 2 == 1){
+                    auto handle = owned[owned.size() - 2];
+                    map.remove(handle);
+                    owned.erase(owned.end() - 2);
+                }
+            }
+            for(size_t i=0; i<owned.size(); ++i){
+                auto ptr = map.get(owned[i]);
+                if(ptr == nullptr || *ptr != t*NUM_OPS + int(2*i + 1))
+                    ++mismatches;
+            }
+        });
+    }
+    for(auto& thread: threads)
+        thread.join();
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(map.size(), size_t(NUM_THREADS * NUM_OPS / 2));
+}
@@ -0,0 +1,122 @@
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "culling.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    // camera at the origin looking down -z, 90 degree fov, near 1, far 100
+    Frustum testFrustum(){
+        auto proj = perspective(std::numbers::pi_v<float>/2, 1.0f, 1.0f, 100.0f);
+        auto view = lookAt(zeros(), -unitZ(), unitY());
+        return extract_frustum(proj * view);
+    }
+
+    AABB boxAt(Vec3 center, float half){
+        return AABB{center - Vec3{half, half, half}, center + Vec3{half, half, half}};
+    }
+
+    std::vector<AABB> randomBoxes(size_t count){
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> pos(-150.0f, 150.0f);
+        std::uniform_real_distribution<float> size(0.1f, 5.0f);
+        std::vector<AABB> boxes(count);
+        for(auto& box: boxes)
+            box = boxAt(Vec3{pos(rng), pos(rng), pos(rng)}, size(rng));
+        return boxes;
+    }
+}
+
+TEST(culling, PlanesAreNormalizedAndFacingInside){
+    auto frustum = testFrustum();
+    for(auto plane: frustum.planes){
+        EXPECT_NEAR(norm(asVec3(plane)), 1.0f, 1e-5f);
+        // a point straight ahead, between near and far, is inside every plane
+        EXPECT_GT(plane_distance(plane, Vec3{0, 0, -50}), 0.0f);
+    }
+    EXPECT_NEAR(plane_distance(frustum.planes[Frustum::Near], Vec3{0, 0, -1}), 0.0f, 1e-4f);
+    EXPECT_NEAR(plane_distance(frustum.planes[Frustum::Far], Vec3{0, 0, -100}), 0.0f, 1e-3f);
+}
+
+TEST(culling, AABBIntersects){
+    auto frustum = testFrustum();
+    EXPECT_TRUE(intersects(frustum, boxAt(Vec3{0, 0, -10}, 1.0f)));
+    // behind the camera, beyond far, off to the side
+    EXPECT_FALSE(intersects(frustum, boxAt(Vec3{0, 0, 10}, 1.0f)));
+    EXPECT_FALSE(intersects(frustum, boxAt(Vec3{0, 0, -200}, 1.0f)));
+    EXPECT_FALSE(intersects(frustum, boxAt(Vec3{50, 0, -10}, 1.0f)));
+    // straddling the left plane
+    EXPECT_TRUE(intersects(frustum, boxAt(Vec3{-10.5f, 0, -10}, 1.0f)));
+}
+
+TEST(culling, SphereIntersects){
+    auto frustum = testFrustum();
+    EXPECT_TRUE(intersects(frustum, BoundingSphere{Vec3{0, 0, -10}, 1.0f}));
+    EXPECT_FALSE(intersects(frustum, BoundingSphere{Vec3{0, 0, 10}, 1.0f}));
+    EXPECT_TRUE(intersects(frustum, BoundingSphere{Vec3{0, 0, 1}, 2.5f}));
+}
+
+TEST(culling, TransformAABBMatchesCorners){
+    auto box = AABB{Vec3{-1, -2, -3}, Vec3{1, 2, 3}};
+    auto m = translateMat(Vec3{5, 0, -1}) * rotateYMat(0.6f) * scaleMat(Vec3{2, 1, 1});
+    auto result = transform_aabb(box, m);
+
+    Vec3 lo{1e9f, 1e9f, 1e9f}, hi{-1e9f, -1e9f, -1e9f};
+    for(int corner=0; corner<8; ++corner){
+        Vec3 p{
+            corner & 1 ? box.max.x : box.min.x,
+            corner & 2 ? box.max.y : box.min.y,
+            corner & 4 ? box.max.z : box.min.z
+        };
+        auto q = asVec3(m * asVec4(p, 1.0f));
+        for(int axis=0; axis<3; ++axis){
+            lo[axis] = std::min(lo[axis], q[axis]);
+            hi[axis] = std::max(hi[axis], q[axis]);
+        }
+    }
+    for(int axis=0; axis<3; ++axis){
+        EXPECT_NEAR(result.min[axis], lo[axis], 1e-4f);
+        EXPECT_NEAR(result.max[axis], hi[axis], 1e-4f);
+    }
+}
+
+TEST(culling, CullAABBsMatchesScalar){
+    auto frustum = testFrustum();
+    // sizes around the 4/8 block boundaries
+    for(size_t size: {0, 1, 4, 7, 8, 13, 10000}){
+        auto boxes = randomBoxes(size);
+        std::vector<uint32_t> visible(size);
+        auto count = cull_aabbs(frustum, boxes, visible);
+
+        std::vector<uint32_t> expected;
+        for(uint32_t i=0; i<size; ++i)
+            if(intersects(frustum, boxes[i]))
+                expected.push_back(i);
+        visible.resize(count);
+        EXPECT_EQ(visible, expected) << size;
+    }
+}
+
+TEST(culling, CullSpheresMatchesScalar){
+    auto frustum = testFrustum();
+    auto boxes = randomBoxes(1003);
+    std::vector<BoundingSphere> spheres;
+    for(auto& box: boxes)
+        spheres.push_back({box.center(), norm(box.extents())});
+
+    std::vector<uint32_t> visible(spheres.size());
+    auto count = cull_spheres(frustum, spheres, visible);
+
+    std::vector<uint32_t> expected;
+    for(uint32_t i=0; i<spheres.size(); ++i)
+        if(intersects(frustum, spheres[i]))
+            expected.push_back(i);
+    visible.resize(count);
+    EXPECT_EQ(visible, expected);
+    EXPECT_GT(count, 0u);
+    EXPECT_LT(count, spheres.size());
+}
@@ -0,0 +1,79 @@
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "dense_slot_map.hpp"
+
+using RenderToy::dense_slot_map;
+
+TEST(dense_slot_map, PushAndAccess){
+    dense_slot_map<int> map;
+    auto h0 = map.push(10);
+    auto h1 = map.push(20);
+
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map[h0], 10);
+    EXPECT_EQ(map[h1], 20);
+}
+
+TEST(dense_slot_map, RemoveKeepsPacked){
+    dense_slot_map<int> map;
+    auto h0 = map.push(1);
+    auto h1 = map.push(2);
+    auto h2 = map.push(3);
+
+    map.remove(h0);
+    ASSERT_EQ(map.size(), 2u);
+
+    // last value swapped into the hole
+    std::vector<int> values(map.begin(), map.end());
+    std::vector<int> expected = {3, 2};
+    EXPECT_EQ(values, expected);
+
+    EXPECT_EQ(map[h1], 2);
+    EXPECT_EQ(map[h2], 3);
+    EXPECT_FALSE(map.contains(h0));
+    EXPECT_THROW(map[h0], std::out_of_range);
+}
+
+TEST(dense_slot_map, ReuseSlotBumpsGeneration){
+    dense_slot_map<std::string> map;
+    auto h0 = map.push("first");
+    map.remove(h0);
+    auto h1 = map.push("second");
+
+    EXPECT_EQ(h0.index, h1.index);
+    EXPECT_NE(h0.generation, h1.generation);
+    EXPECT_FALSE(map.contains(h0));
+    EXPECT_EQ(map[h1], "second");
+}
+
+TEST(dense_slot_map, SpanAndOwners){
+    dense_slot_map<int> map;
+    auto h0 = map.push(7);
+    auto h1 = map.push(8);
+    auto h2 = map.push(9);
+    map.remove(h1);
+
+    auto data = map.data();
+    ASSERT_EQ(data.size(), 2u);
+    for(RenderToy::Index i=0; i<data.size(); ++i)
+        EXPECT_EQ(map[map.handle_at(i)], data[i]);
+
+    EXPECT_EQ(map.handle_at(0), h0);
+    EXPECT_EQ(map.handle_at(1), h2);
+}
+
+TEST(dense_slot_map, ClearInvalidatesHandles){
+    dense_slot_map<int> map;
+    auto h0 = map.push(1);
+    auto h1 = map.push(2);
+
+    map.clear();
+    EXPECT_EQ(map.size(), 0u);
+    EXPECT_FALSE(map.contains(h0));
+    EXPECT_FALSE(map.contains(h1));
+
+    auto h2 = map.push(3);
+    EXPECT_EQ(map[h2], 3);
+    EXPECT_EQ(map.size(), 1u);
+}
@@ -0,0 +1,158 @@
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <gtest/gtest.h>
+#include "flat_hash_map.hpp"
+#include "interned_name.hpp"
+
+using RenderToy::flat_hash_map;
+
+namespace
+{
+    // every key in one home slot: exercises long clusters and backward shift
+    struct CollidingHash{
+        size_t operator()(int) const{ return 0; }
+    };
+}
+
+TEST(flat_hash_map, InsertFindErase){
+    flat_hash_map<int, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+
+    auto [it, inserted] = map.try_emplace(1, "one");
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->second, "one");
+    EXPECT_FALSE(map.try_emplace(1, "uno").second);
+    EXPECT_EQ(map.at(1), "one");
+
+    map[2] = "two";
+    map.emplace(3, "three");
+    map.insert({4, "four"});
+    EXPECT_EQ(map.size(), 4u);
+    EXPECT_TRUE(map.contains(3));
+    EXPECT_EQ(map.count(5), 0u);
+    EXPECT_THROW(map.at(5), std::out_of_range);
+
+    EXPECT_EQ(map.erase(2), 1u);
+    EXPECT_EQ(map.erase(2), 0u);
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_FALSE(map.contains(2));
+
+    map.insert_or_assign(1, std::string("uno"));
+    EXPECT_EQ(map.at(1), "uno");
+}
+
+TEST(flat_hash_map, MatchesUnorderedMap){
+    flat_hash_map<uint32_t, uint32_t> map;
+    std::unordered_map<uint32_t, uint32_t> reference;
+    std::mt19937 rng(1);
+
+    for(int step=0; step<200'000; ++step){
+        auto key = rng() % 5000;
+        switch(rng() % 3){
+        case 0:
+            map[key] = step;
+            reference[key] = step;
+            break;
+        case 1:
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+            break;
+        default:
+            auto it = map.find(key);
+            auto ref = reference.find(key);
+            ASSERT_EQ(it == map.end(), ref == reference.end());
+            if(ref != reference.end()){
+                EXPECT_EQ(it->second, ref->second);
+            }
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    size_t visited = 0;
+    for(auto& [key, value]: map){
+        EXPECT_EQ(reference.at(key), value);
+        ++visited;
+    }
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(flat_hash_map, CollidingKeys){
+    flat_hash_map<int, int, CollidingHash> map;
+    for(int i=0; i<100; ++i)
+        map[i] = i*10;
+    // erase from the middle of the cluster, the rest must stay reachable
+    for(int i=0; i<100; i+=3)
+        map.erase(i);
+    for(int i=0; i<100; ++i){
+        if(i % 3 == 0)
+            EXPECT_FALSE(map.contains(i));
+        else
+            EXPECT_EQ(map.at(i), i*10);
+    }
+}
+
+TEST(flat_hash_map, EraseWhileIterating){
+    flat_hash_map<int, int> map;
+    for(int i=0; i<1000; ++i)
+        map[i] = i;
+
+    for(auto it = map.begin(); it != map.end();){
+        if(it->first % 2 == 0)
+            it = map.erase(it);
+        else
+            ++it;
+    }
+    EXPECT_EQ(map.size(), 500u);
+    for(auto& [key, value]: map)
+        EXPECT_EQ(key % 2, 1);
+}
+
+TEST(flat_hash_map, ChurnKeepsCapacity){
+    // no tombstones: insert/erase cycles at a fixed size never grow the table
+    flat_hash_map<uint32_t, uint32_t> map;
+    map.reserve(1000);
+    auto capacity = map.capacity();
+    for(uint32_t round=0; round<100; ++round){
+        for(uint32_t i=0; i<1000; ++i)
+            map[round*1000 + i] = i;
+        for(uint32_t i=0; i<1000; ++i)
+            map.erase(round*1000 + i);
+    }
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.capacity(), capacity);
+}
+
+TEST(flat_hash_map, ValueLifetime){
+    auto tracker = std::make_shared<int>(0);
+    {
+        flat_hash_map<int, std::shared_ptr<int>> map;
+        for(int i=0; i<100; ++i)
+            map[i] = tracker;
+        EXPECT_EQ(tracker.use_count(), 101);
+        for(int i=0; i<50; ++i)
+            map.erase(i);
+        EXPECT_EQ(tracker.use_count(), 51);
+
+        auto copy = map;
+        EXPECT_EQ(tracker.use_count(), 101);
+        auto moved = std::move(copy);
+        EXPECT_EQ(tracker.use_count(), 101);
+        moved.clear();
+        EXPECT_EQ(tracker.use_count(), 51);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(flat_hash_map, HeterogeneousLookup){
+    using namespace RenderToy;
+    flat_hash_map<interned_name, int, name_hash, name_equal> map;
+    map[interned_name("Albedo")] = 1;
+    map[interned_name("Normal")] = 2;
+
+    EXPECT_EQ(map.find(std::string_view("Normal"))->second, 2);
+    EXPECT_EQ(map.find(interned_name("Albedo"))->second, 1);
+    EXPECT_EQ(map.find(std::string_view("Depth")), map.end());
+}
@@ -0,0 +1,116 @@
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "frame_arena.hpp"
+#include "alloc_counter.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    // a frame worth of scratch: containers + raw arrays
+    void simulateFrame(frame_arena& arena, int frame){
+        std::pmr::vector<int> visible(arena.resource());
+        for(int i=0; i<1000; ++i)
+            visible.push_back(i + frame);
+        std::pmr::string label("per-frame label long enough to skip SSO", arena.resource());
+        auto matrices = arena.make_array<float>(16*64);
+        matrices[0] = float(frame);
+        EXPECT_EQ(visible.back(), 999 + frame);
+        EXPECT_EQ(label.size(), 39u);
+    }
+}
+
+TEST(frame_arena, BumpAndAlignment){
+    frame_arena arena(256);
+    auto a = arena.allocate(3, 1);
+    auto b = arena.allocate(8, 64);
+    EXPECT_NE(a, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+    EXPECT_GE(arena.used(), 11u);
+
+    auto value = arena.make<int>(42);
+    EXPECT_EQ(*value, 42);
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.allocate(3, 1), a);
+}
+
+TEST(frame_arena, OverflowMergesBlocksOnReset){
+    frame_arena arena(128);
+    for(int i=0; i<100; ++i)
+        arena.allocate(64);
+    EXPECT_GE(arena.used(), 6400u);
+    auto grown = arena.capacity();
+
+    arena.reset();
+    EXPECT_EQ(arena.capacity(), grown);
+    // the merged block now holds the whole frame
+    test::AllocationScope scope;
+    for(int i=0; i<100; ++i)
+        arena.allocate(64);
+    EXPECT_EQ(scope.count(), 0u);
+}
+
+TEST(frame_arena, SteadyStateFrameHasNoGlobalAllocation){
+    buffered_frame_arena<3> arenas;
+    // warm-up: every slot sees one frame
+    for(int frame=0; frame<3; ++frame){
+        arenas.begin_frame(frame);
+        simulateFrame(arenas.current(), frame);
+    }
+
+    test::AllocationScope scope;
+    for(int frame=3; frame<30; ++frame){
+        arenas.begin_frame(frame);
+        simulateFrame(arenas.current(), frame);
+    }
+    EXPECT_EQ(scope.count(), 0u);
+}
+
+TEST(frame_arena, BufferedKeepsPreviousFramesAlive){
+    buffered_frame_arena<3> arenas;
+    std::vector<int*> values;
+    for(int frame=0; frame<3; ++frame){
+        arenas.begin_frame(frame);
+        values.push_back(arenas.current().make<int>(frame));
+    }
+    // frames 0..2 are all in flight
+    for(int frame=0; frame<3; ++frame)
+        EXPECT_EQ(*values[frame], frame);
+
+    // frame 3 reuses slot 0 only
+    arenas.begin_frame(3);
+    EXPECT_EQ(arenas.frame_index(), 0u);
+    EXPECT_EQ(*values[1], 1);
+    EXPECT_EQ(*values[2], 2);
+}
+
+TEST(frame_arena, ThreadedArenaGivesEachThreadItsOwn){
+    threaded_frame_arena arena;
+    constexpr int THREADS = 4;
+    std::vector<frame_arena*> locals(THREADS);
+    std::vector<std::thread> threads;
+    for(int t=0; t<THREADS; ++t){
+        threads.emplace_back([&, t]{
+            auto& local = arena.local();
+            EXPECT_EQ(&local, &arena.local());
+            locals[t] = &local;
+            for(int i=0; i<1000; ++i)
+                *local.make<int>(i) = i;
+        });
+    }
+    for(auto& thread: threads)
+        thread.join();
+
+    for(int t=0; t<THREADS; ++t)
+        for(int u=t+1; u<THREADS; ++u)
+            EXPECT_NE(locals[t], locals[u]);
+    EXPECT_GE(arena.used(), THREADS*1000*sizeof(int));
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+}
@@ -0,0 +1,103 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "interned_name.hpp"
+
+using namespace RenderToy;
+using namespace RenderToy::literals;
+
+static_assert(hash_string("GBuffer") == "GBuffer"_hs.hash);
+static_assert(hash_string("") != hash_string(std::string_view("\0", 1)));
+static_assert(hash_string("abc", 1) != hash_string("abc", 2));
+
+TEST(interned_name, HashMatchesAtRuntime){
+    // every tail length around the 8-byte step
+    std::string text = "engine/assets/meshes/sponza.gltf";
+    for(size_t length=0; length<=text.size(); ++length){
+        auto view = std::string_view(text).substr(0, length);
+        std::string copy(view);
+        EXPECT_EQ(hash_string(view), hash_string(copy));
+        EXPECT_EQ(hashed_string(view).hash, hash_string(view));
+    }
+    constexpr auto compileTime = hash_string("engine/assets/meshes/sponza.gltf");
+    EXPECT_EQ(hash_string(text), compileTime);
+}
+
+TEST(interned_name, SameTextSameName){
+    std::string dynamic = "Shadow";
+    dynamic += "Map";
+    auto a = interned_name("ShadowMap");
+    auto b = interned_name(dynamic);
+    auto c = interned_name("ShadowMap"_hs);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(a.c_str(), b.c_str());
+    EXPECT_EQ(a.hash(), hash_string("ShadowMap"));
+    EXPECT_EQ(a.str(), "ShadowMap");
+    EXPECT_EQ(a, std::string_view("ShadowMap"));
+
+    auto other = interned_name("ShadowMap2");
+    EXPECT_NE(a, other);
+    EXPECT_LT(a, other);
+}
+
+TEST(interned_name, Empty){
+    interned_name empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty, interned_name(""));
+    EXPECT_EQ(empty.hash(), hash_string(""));
+    EXPECT_STREQ(empty.c_str(), "");
+    EXPECT_EQ(empty.size(), 0);
+}
+
+TEST(interned_name, FindDoesNotIntern){
+    auto before = interned_name::interned_count();
+    EXPECT_FALSE(interned_name::find("never interned anywhere").has_value());
+    EXPECT_EQ(interned_name::interned_count(), before);
+
+    auto name = interned_name("interned once");
+    auto found = interned_name::find("interned once");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(*found, name);
+    EXPECT_EQ(interned_name::interned_count(), before + 1);
+}
+
+TEST(interned_name, HeterogeneousLookup){
+    name_map<int> map;
+    map[interned_name("Albedo")] = 1;
+    map[interned_name("Normal")] = 2;
+
+    EXPECT_EQ(map.find(interned_name("Albedo"))->second, 1);
+    EXPECT_EQ(map.find(std::string_view("Normal"))->second, 2);
+    EXPECT_EQ(map.find(std::string("Normal"))->second, 2);
+    EXPECT_EQ(map.find("Albedo"_hs)->second, 1);
+    EXPECT_EQ(map.find(std::string_view("Depth")), map.end());
+}
+
+TEST(interned_name, ConcurrentIntern){
+    constexpr size_t THREADS = 8;
+    constexpr size_t NAMES = 2000;
+
+    std::vector<std::vector<interned_name>> results(THREADS);
+    std::vector<std::thread> threads;
+    for(size_t t=0; t<THREADS; ++t){
+        threads.emplace_back([&, t]{
+            results[t].reserve(NAMES);
+            // every thread races on the same set, in a different order
+            for(size_t i=0; i<NAMES; ++i){
+                auto n = (i*7 + t*131) % NAMES;
+                results[t].push_back(interned_name("concurrent_" + std::to_string(n)));
+            }
+        });
+    }
+    for(auto& thread: threads)
+        thread.join();
+
+    std::vector<interned_name> expected(NAMES);
+    for(size_t i=0; i<NAMES; ++i)
+        expected[i] = interned_name("concurrent_" + std::to_string(i));
+    for(size_t t=0; t<THREADS; ++t)
+        for(size_t i=0; i<NAMES; ++i)
+            EXPECT_EQ(results[t][i], expected[(i*7 + t*131) % NAMES]);
+}
@@ -0,0 +1,167 @@
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "job_system.hpp"
+
+using namespace RenderToy;
+
+TEST(job_system, ParallelForCoversEveryIndexOnce){
+    job_system jobs(3);
+    std::vector<std::atomic<int>> hits(10'000);
+    jobs.parallel_for(hits.size(), 64, [&](Index begin, Index end){
+        for(auto i=begin; i<end; ++i)
+            hits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+    for(const auto& hit: hits)
+        EXPECT_EQ(hit.load(), 1);
+}
+
+TEST(job_system, RangesDependOnlyOnGrain){
+    auto rangesOf = [](job_system& jobs){
+        std::mutex mutex;
+        std::set<std::pair<Index, Index>> ranges;
+        jobs.parallel_for(1000, 96, [&](Index begin, Index end){
+            std::lock_guard lock(mutex);
+            ranges.emplace(begin, end);
+        });
+        return ranges;
+    };
+    job_system serial(0);
+    job_system parallel(4);
+    auto expected = rangesOf(serial);
+    EXPECT_EQ(expected.size(), 11u);
+    EXPECT_EQ(*expected.rbegin(), (std::pair<Index, Index>(960, 1000)));
+    EXPECT_EQ(rangesOf(parallel), expected);
+}
+
+TEST(job_system, SubmittedJobsRunBeforeShutdown){
+    std::atomic<int> done = 0;
+    {
+        job_system jobs(2);
+        for(int i=0; i<100; ++i)
+            jobs.submit([&]{ done.fetch_add(1); });
+    }
+    EXPECT_EQ(done.load(), 100);
+}
+
+TEST(job_system, ParallelForRethrows){
+    job_system jobs(2);
+    std::atomic<int> ran = 0;
+    EXPECT_THROW(jobs.parallel_for(100, 1, [&](Index begin, Index){
+        ran.fetch_add(1);
+        if(begin == 42)
+            throw std::runtime_error("range 42");
+    }), std::runtime_error);
+    // the other ranges still ran
+    EXPECT_EQ(ran.load(), 100);
+}
+
+TEST(job_system, ThrowingJobStillFinishesItsCounter){
+    job_system jobs(2);
+    job_counter counter, after;
+    std::atomic<int> ran = 0;
+    for(int i=0; i<20; ++i){
+        jobs.submit([&, i]{
+            ran.fetch_add(1);
+            if(i == 7)
+                throw std::runtime_error("job 7");
+        }, &counter);
+    }
+    std::atomic<bool> continued = false;
+    jobs.submit_after(counter, [&]{ continued.store(true); }, &after);
+    EXPECT_THROW(jobs.wait(counter), std::runtime_error);
+    EXPECT_TRUE(counter.done());
+    EXPECT_EQ(ran.load(), 20);
+    // the error was reported once; dependents still run
+    jobs.wait(counter);
+    jobs.wait(after);
+    EXPECT_TRUE(continued.load());
+}
+
+TEST(job_system, WaitRunsJobsWithoutWorkers){
+    job_system jobs(0);
+    job_counter counter;
+    int done = 0;
+    for(int i=0; i<10; ++i)
+        jobs.submit([&]{ ++done; }, &counter);
+    EXPECT_EQ(counter.value(), 10u);
+    jobs.wait(counter);
+    EXPECT_TRUE(counter.done());
+    EXPECT_EQ(done, 10);
+}
+
+TEST(job_system, DependentJobsRunAfterTheirDependency){
+    job_system jobs(3);
+    for(int repeat=0; repeat<50; ++repeat){
+        // stage a: 64 writers; stage b: 64 readers of all of a; stage c: one sum of b
+        std::vector<int> a(64, 0), b(64, 0);
+        std::atomic<int> sum = -1;
+        job_counter aDone, bDone, cDone;
+        for(Index i=0; i<a.size(); ++i)
+            jobs.submit([&, i]{ a[i] = int(i) + 1; }, &aDone);
+        for(Index i=0; i<b.size(); ++i){
+            jobs.submit_after(aDone, [&, i]{
+                for(auto value: a)
+                    b[i] += value;
+            }, &bDone);
+        }
+        jobs.submit_after(bDone, [&]{
+            int total = 0;
+            for(auto value: b)
+                total += value;
+            sum.store(total);
+        }, &cDone);
+
+        jobs.wait(cDone);
+        EXPECT_TRUE(aDone.done());
+        EXPECT_TRUE(bDone.done());
+        EXPECT_EQ(sum.load(), 64 * (64 * 65 / 2));
+    }
+}
+
+TEST(job_system, SubmitAfterFinishedCounterRunsNow){
+    job_system jobs(2);
+    job_counter idle;
+    job_counter counter;
+    std::atomic<bool> ran = false;
+    jobs.submit_after(idle, [&]{ ran.store(true); }, &counter);
+    jobs.wait(counter);
+    EXPECT_TRUE(ran.load());
+}
+
+TEST(job_system, MainJobsRunOnTheMainThread){
+    job_system jobs(3);
+    EXPECT_TRUE(jobs.is_main_thread());
+    job_counter counter;
+    std::atomic<int> onMain = 0;
+    std::atomic<int> elsewhere = 0;
+    // workers queue main-thread work; wait() on the main thread runs it
+    for(int i=0; i<32; ++i){
+        jobs.submit([&]{
+            jobs.submit_main([&]{
+                (jobs.is_main_thread() ? onMain : elsewhere).fetch_add(1);
+            }, &counter);
+        }, &counter);
+    }
+    jobs.wait(counter);
+    EXPECT_EQ(onMain.load(), 32);
+    EXPECT_EQ(elsewhere.load(), 0);
+    EXPECT_EQ(jobs.run_main_jobs(), 0u);
+}
+
+TEST(job_system, NestedParallelForFromWorkers){
+    job_system jobs(3);
+    std::vector<std::atomic<int>> hits(64 * 64);
+    jobs.parallel_for(64, 1, [&](Index outer, Index){
+        jobs.parallel_for(64, 8, [&](Index begin, Index end){
+            for(auto i=begin; i<end; ++i)
+                hits[outer * 64 + i].fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    for(const auto& hit: hits)
+        EXPECT_EQ(hit.load(), 1);
+}
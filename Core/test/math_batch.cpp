@@ -0,0 +1,156 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "math_batch.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    constexpr float EPSILON = 1e-4f;
+    // sizes around the 4-lane block boundary
+    constexpr size_t SIZES[] = {0, 1, 3, 4, 5, 8, 13, 1000};
+
+    bool nearEq(Vec3 a, Vec3 b, float eps = EPSILON){
+        return std::abs(a.x-b.x) < eps && std::abs(a.y-b.y) < eps && std::abs(a.z-b.z) < eps;
+    }
+    bool nearEq(Vec4 a, Vec4 b, float eps = EPSILON){
+        return nearEq(asVec3(a), asVec3(b), eps) && std::abs(a.w-b.w) < eps;
+    }
+    bool nearEq(const Mat4& a, const Mat4& b, float eps = EPSILON){
+        for(int row=0; row<4; ++row)
+            if(!nearEq(a[row], b[row], eps))
+                return false;
+        return true;
+    }
+
+    Vec4 randomVec4(std::mt19937& rng){
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        return Vec4{dist(rng), dist(rng), dist(rng), dist(rng)};
+    }
+    std::vector<Vec3> randomPoints(size_t count, uint32_t seed){
+        std::mt19937 rng(seed);
+        std::vector<Vec3> points(count);
+        for(auto& p: points)
+            p = asVec3(randomVec4(rng));
+        return points;
+    }
+    std::vector<Vec4> randomQuats(size_t count, uint32_t seed){
+        std::mt19937 rng(seed);
+        std::vector<Vec4> quats(count);
+        for(auto& q: quats){
+            q = randomVec4(rng);
+            q = q / std::sqrt(norm_squared(q));
+        }
+        return quats;
+    }
+}
+
+TEST(math_batch, TransformPointsMatchesPerElement){
+    auto m = translateMat(Vec3{1, -2, 3}) * rotateYMat(0.7f) * scaleMat(Vec3{2, 3, 4});
+    for(auto size: SIZES){
+        auto points = randomPoints(size, 1);
+        std::vector<Vec3> out(size);
+        transform_points(points, m, out);
+        for(size_t i=0; i<size; ++i)
+            EXPECT_TRUE(nearEq(out[i], asVec3(m * asVec4(points[i], 1.0f)), 1e-3f)) << size << ":" << i;
+    }
+}
+
+TEST(math_batch, TransformPointsInPlace){
+    auto m = translateMat(Vec3{5, 0, 0});
+    auto points = randomPoints(7, 2);
+    auto expected = points;
+    for(auto& p: expected)
+        p += Vec3{5, 0, 0};
+
+    transform_points(points, m, points);
+    for(size_t i=0; i<points.size(); ++i)
+        EXPECT_TRUE(nearEq(points[i], expected[i]));
+}
+
+TEST(math_batch, MulMatrices){
+    std::mt19937 rng(3);
+    std::vector<Mat4> lhs(9), rhs(9), out(9);
+    for(size_t i=0; i<lhs.size(); ++i){
+        lhs[i] = Mat4{randomVec4(rng), randomVec4(rng), randomVec4(rng), randomVec4(rng)};
+        rhs[i] = Mat4{randomVec4(rng), randomVec4(rng), randomVec4(rng), randomVec4(rng)};
+    }
+    mul_matrices(lhs, rhs, out);
+    for(size_t i=0; i<out.size(); ++i)
+        EXPECT_TRUE(nearEq(out[i], detail::mat_mul_scalar(lhs[i], rhs[i]), 1e-3f));
+}
+
+TEST(math_batch, QuatToMatMatchesRotate){
+    for(auto size: SIZES){
+        auto quats = randomQuats(size, 4);
+        std::vector<Mat4> out(size);
+        quat_to_mat_batch(quats, out);
+        for(size_t i=0; i<size; ++i){
+            EXPECT_TRUE(nearEq(out[i], rotateMat(quats[i]))) << size << ":" << i;
+            auto v = Vec3{1, 2, 3};
+            EXPECT_TRUE(nearEq(asVec3(out[i] * asVec4(v)), rotate(v, quats[i])));
+        }
+    }
+}
+
+TEST(math_batch, RotateMatMatchesAxisMatrices){
+    EXPECT_TRUE(nearEq(rotateMat(rotateX(0.3f)), rotateXMat(0.3f)));
+    EXPECT_TRUE(nearEq(rotateMat(rotateY(0.3f)), rotateYMat(0.3f)));
+    EXPECT_TRUE(nearEq(rotateMat(rotateZ(0.3f)), rotateZMat(0.3f)));
+}
+
+TEST(math_batch, NormalizeVec3){
+    for(auto size: SIZES){
+        auto points = randomPoints(size, 5);
+        std::vector<Vec3> out(size);
+        normalize_batch(points, out);
+        for(size_t i=0; i<size; ++i)
+            EXPECT_TRUE(nearEq(out[i], normalize(points[i])));
+    }
+}
+
+TEST(math_batch, NormalizeVec4InPlace){
+    std::mt19937 rng(6);
+    std::vector<Vec4> vecs(11);
+    for(auto& v: vecs)
+        v = randomVec4(rng);
+    auto expected = vecs;
+    for(auto& v: expected)
+        v = normalize(v);
+
+    normalize_batch(vecs, vecs);
+    for(size_t i=0; i<vecs.size(); ++i)
+        EXPECT_TRUE(nearEq(vecs[i], expected[i]));
+}
+
+TEST(math_batch, Bounds){
+    for(auto size: SIZES){
+        if(size == 0)
+            continue;
+        auto points = randomPoints(size, 7);
+        Vec3 expectedMin = points[0], expectedMax = points[0];
+        for(auto p: points){
+            for(int axis=0; axis<3; ++axis){
+                expectedMin[axis] = std::min(expectedMin[axis], p[axis]);
+                expectedMax[axis] = std::max(expectedMax[axis], p[axis]);
+            }
+        }
+
+        Vec3 min = points[0], max = points[0];
+        bounds_batch(points, min, max);
+        EXPECT_EQ(min, expectedMin);
+        EXPECT_EQ(max, expectedMax);
+    }
+}
+
+TEST(math_batch, BoundsAccumulate){
+    Vec3 min{0, 0, 0}, max{0, 0, 0};
+    std::vector<Vec3> a = {{1, 2, 3}, {-1, 0, 0}};
+    std::vector<Vec3> b = {{0, -5, 0}, {0, 0, 9}, {2, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    bounds_batch(a, min, max);
+    bounds_batch(b, min, max);
+    EXPECT_EQ(min, (Vec3{-1, -5, 0}));
+    EXPECT_EQ(max, (Vec3{2, 2, 9}));
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <cmath>
+#include <random>
 #include "math.hpp"
 
 using namespace RenderToy;
@@ -526,4 +527,82 @@ TEST(LookAtTest, UpPreserved){
     // view space에서도 +Y 방향이어야 함
     EXPECT_NEAR(result.x, 0.0f, kEpsilon);
     EXPECT_GT(result.y, 0.0f);
-}
\ No newline at end of file
+}
+
+//==========================================================================
+// SIMD parity tests (runtime kernels vs constexpr scalar path)
+//==========================================================================
+
+// constant evaluation still takes the scalar path
+static_assert(rotate(Vec3{1, 0, 0}, unitQuat()) == Vec3{1, 0, 0});
+static_assert(Vec4{1, 2, 3, 4} * unitQuat() == Vec4{1, 2, 3, 4});
+
+namespace
+{
+    constexpr int kParityRounds = 1000;
+    // FMA contraction may differ from the scalar path in the last bits
+    constexpr float kParityEpsilon = 1e-4f;
+    // for results built from [-10, 10] operands
+    constexpr float kProductEpsilon = 1e-3f;
+
+    Vec4 randomVec4(std::mt19937& rng){
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        return Vec4{dist(rng), dist(rng), dist(rng), dist(rng)};
+    }
+    Mat4 randomMat4(std::mt19937& rng){
+        return Mat4{randomVec4(rng), randomVec4(rng), randomVec4(rng), randomVec4(rng)};
+    }
+    Vec4 scalarNormalize(Vec4 v){
+        return v / std::sqrt(norm_squared(v));
+    }
+}
+
+TEST(SimdParityTest, MatrixMultiply){
+    std::mt19937 rng(42);
+    for(int i=0; i<kParityRounds; ++i){
+        auto a = randomMat4(rng);
+        auto b = randomMat4(rng);
+
+        auto simd = a * b;
+        auto scalar = detail::mat_mul_scalar(a, b);
+        for(int row=0; row<4; ++row)
+            EXPECT_TRUE(nearEq(simd[row], scalar[row], kProductEpsilon));
+    }
+}
+
+TEST(SimdParityTest, MatrixMultiplyAliasing){
+    auto m = rotateYMat(0.5f) * translateMat(Vec3{1, 2, 3});
+    auto expected = detail::mat_mul_scalar(m, m);
+    m = m * m;
+    for(int row=0; row<4; ++row)
+        EXPECT_TRUE(nearEq(m[row], expected[row], kParityEpsilon));
+}
+
+TEST(SimdParityTest, QuaternionMultiply){
+    std::mt19937 rng(7);
+    for(int i=0; i<kParityRounds; ++i){
+        auto a = randomVec4(rng);
+        auto b = randomVec4(rng);
+        EXPECT_TRUE(nearEq(a * b, detail::quat_mul_scalar(a, b), kProductEpsilon));
+    }
+}
+
+TEST(SimdParityTest, Rotate){
+    std::mt19937 rng(11);
+    for(int i=0; i<kParityRounds; ++i){
+        auto q = scalarNormalize(randomVec4(rng));
+        auto v = asVec3(randomVec4(rng));
+
+        auto expected = asVec3(detail::quat_mul_scalar(
+            detail::quat_mul_scalar(q, asVec4(v)), conjugate(q)));
+        EXPECT_TRUE(nearEq(rotate(v, q), expected, kProductEpsilon));
+    }
+}
+
+TEST(SimdParityTest, Normalize){
+    std::mt19937 rng(13);
+    for(int i=0; i<kParityRounds; ++i){
+        auto v = randomVec4(rng);
+        EXPECT_TRUE(nearEq(normalize(v), scalarNormalize(v), kParityEpsilon));
+    }
+}
@@ -0,0 +1,129 @@
+#include <list>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <gtest/gtest.h>
+#include "pool_allocator.hpp"
+#include "alloc_counter.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    struct Base{
+        virtual ~Base() = default;
+        virtual int value() const = 0;
+    };
+    int g_destroyed = 0;
+    struct Derived: Base{
+        int data[20] = {};
+        explicit Derived(int v){ data[0] = v; }
+        ~Derived() override{ ++g_destroyed; }
+        int value() const override{ return data[0]; }
+    };
+}
+
+TEST(pool_allocator, SizeClasses){
+    static_assert(pool_resource::class_of(1) == 0);
+    static_assert(pool_resource::class_of(16) == 0);
+    static_assert(pool_resource::class_of(17) == 1);
+    static_assert(pool_resource::class_of(1024) == pool_resource::NUM_CLASSES - 1);
+    static_assert(pool_resource::pooled(24, 8));
+    static_assert(!pool_resource::pooled(2048, 8));
+    static_assert(!pool_resource::pooled(16, 128));
+}
+
+TEST(pool_allocator, FreedBlockIsReused){
+    pool_resource pool;
+    auto a = pool.allocate(40, 8);
+    pool.deallocate(a, 40, 8);
+    auto b = pool.allocate(64, 8);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+    pool.deallocate(b, 64, 8);
+
+    // out of class range goes upstream and back
+    auto big = pool.allocate(4096, 16);
+    pool.deallocate(big, 4096, 16);
+}
+
+TEST(pool_allocator, SteadyStateChurnHasNoGlobalAllocation){
+    pool_resource pool;
+    std::vector<void*> live(1000);
+    auto churn = [&]{
+        for(auto& ptr: live)
+            ptr = pool.allocate(48, 8);
+        for(auto ptr: live)
+            pool.deallocate(ptr, 48, 8);
+    };
+    churn();
+
+    test::AllocationScope scope;
+    for(int i=0; i<10; ++i)
+        churn();
+    EXPECT_EQ(scope.count(), 0u);
+}
+
+TEST(pool_allocator, StdContainers){
+    pool_resource pool;
+    std::list<int, pool_allocator<int>> list{pool_allocator<int>(&pool)};
+    for(int i=0; i<1000; ++i)
+        list.push_back(i);
+    EXPECT_EQ(list.back(), 999);
+
+    using Map = std::unordered_map<int, int, std::hash<int>, std::equal_to<>,
+        pool_allocator<std::pair<const int, int>>>;
+    Map map(16, std::hash<int>{}, std::equal_to<>{}, pool_allocator<std::pair<const int, int>>(&pool));
+    for(int i=0; i<1000; ++i)
+        map.emplace(i, i*2);
+    for(int i=0; i<1000; i+=2)
+        map.erase(i);
+    EXPECT_EQ(map.size(), 500u);
+    EXPECT_EQ(map.at(501), 1002);
+}
+
+TEST(pool_allocator, MakePooledDeletesThroughBase){
+    g_destroyed = 0;
+    {
+        pool_ptr<Base> ptr = make_pooled<Derived>(7);
+        EXPECT_EQ(ptr->value(), 7);
+    }
+    EXPECT_EQ(g_destroyed, 1);
+}
+
+TEST(pool_allocator, CrossThreadAllocFree){
+    pool_resource pool;
+    constexpr int THREADS = 4;
+    constexpr int COUNT = 20000;
+    std::vector<std::vector<int*>> produced(THREADS);
+
+    std::vector<std::thread> threads;
+    for(int t=0; t<THREADS; ++t){
+        threads.emplace_back([&, t]{
+            pool_allocator<int> alloc(&pool);
+            for(int i=0; i<COUNT; ++i){
+                auto ptr = alloc.allocate(1);
+                *ptr = t*COUNT + i;
+                produced[t].push_back(ptr);
+            }
+        });
+    }
+    for(auto& thread: threads)
+        thread.join();
+    threads.clear();
+
+    // each thread frees blocks another one allocated
+    for(int t=0; t<THREADS; ++t){
+        threads.emplace_back([&, t]{
+            pool_allocator<int> alloc(&pool);
+            auto& victims = produced[(t+1) % THREADS];
+            auto owner = (t+1) % THREADS;
+            for(int i=0; i<COUNT; ++i){
+                EXPECT_EQ(*victims[i], owner*COUNT + i);
+                alloc.deallocate(victims[i], 1);
+            }
+        });
+    }
+    for(auto& thread: threads)
+        thread.join();
+}
@@ -0,0 +1,213 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "quantize.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    std::vector<Vec3> randomNormals(size_t count){
+        std::mt19937 rng(1);
+        std::normal_distribution<float> dist;
+        std::vector<Vec3> normals(count);
+        for(auto& n: normals)
+            n = normalize(Vec3{dist(rng), dist(rng), dist(rng)});
+        return normals;
+    }
+
+    std::vector<Vec4> randomQuats(size_t count){
+        std::mt19937 rng(2);
+        std::normal_distribution<float> dist;
+        std::vector<Vec4> quats(count);
+        for(auto& q: quats)
+            q = normalize(Vec4{dist(rng), dist(rng), dist(rng), dist(rng)});
+        return quats;
+    }
+
+    float angleDegrees(Vec3 a, Vec3 b){
+        // atan2 stays accurate for tiny angles, acos does not
+        return std::atan2(norm(cross(a, b)), dot(a, b)) * 180.0f / 3.14159265f;
+    }
+}
+
+static_assert(half(1.0f).bits == 0x3C00);
+static_assert(float(half(-2.5f)) == -2.5f);
+static_assert(to_snorm<int16_t>(-1.0f) == -32767);
+static_assert(to_unorm<uint8_t>(1.0f) == 255);
+static_assert(encode_octahedral(Vec3{0, 0, 1}) == OctNormal{0, 0});
+static_assert(encode_octahedral(Vec3{0, 0, 0}) == OctNormal{0, 0});
+
+TEST(quantize, HalfRepresentableRoundTrip){
+    // every finite half survives half -> float -> half
+    for(uint32_t bits=0; bits<0x10000; ++bits){
+        auto h = half::from_bits(uint16_t(bits));
+        auto f = float(h);
+        if(std::isnan(f)){
+            EXPECT_TRUE(std::isnan(float(half(f))));
+            continue;
+        }
+        EXPECT_EQ(half(f).bits, h.bits) << std::hex << bits;
+    }
+}
+
+TEST(quantize, HalfSpecialValues){
+    EXPECT_EQ(half(0.0f).bits, 0x0000);
+    EXPECT_EQ(half(-0.0f).bits, 0x8000);
+    EXPECT_EQ(half(65504.0f).bits, 0x7BFF);
+    // overflow saturates to infinity
+    EXPECT_EQ(half(65520.0f).bits, 0x7C00);
+    EXPECT_EQ(half(-1e10f).bits, 0xFC00);
+    EXPECT_EQ(half(std::numeric_limits<float>::infinity()).bits, 0x7C00);
+    EXPECT_TRUE(std::isnan(float(half(std::numeric_limits<float>::quiet_NaN()))));
+    // smallest subnormal, and half of it rounds to even (zero)
+    EXPECT_EQ(half(0x1p-24f).bits, 0x0001);
+    EXPECT_EQ(half(0x1p-25f).bits, 0x0000);
+    EXPECT_EQ(half(0x1.8p-24f).bits, 0x0002);
+    EXPECT_EQ(float(half::from_bits(0x03FF)), 0x3FFp-24f);
+    // ties round to even in the normal range
+    EXPECT_EQ(half(1.0f + 0x1p-11f).bits, 0x3C00);
+    EXPECT_EQ(half(1.0f + 0x3p-11f).bits, 0x3C02);
+}
+
+TEST(quantize, HalfBatchMatchesScalar){
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-70000.0f, 70000.0f);
+    std::vector<float> in(1027);
+    for(auto& f: in)
+        f = dist(rng) * std::pow(2.0f, -float(rng() % 40));
+    in[0] = 0x1p-20f;
+    in[1] = -0.0f;
+    in[2] = std::numeric_limits<float>::infinity();
+
+    std::vector<half> packed(in.size());
+    std::vector<float> unpacked(in.size());
+    to_half_batch(in, packed);
+    from_half_batch(packed, unpacked);
+    for(size_t i=0; i<in.size(); ++i){
+        EXPECT_EQ(packed[i].bits, half(in[i]).bits) << in[i];
+        EXPECT_EQ(unpacked[i], float(packed[i]));
+    }
+}
+
+TEST(quantize, NormRoundTrip){
+    for(int i=-32767; i<=32767; ++i)
+        EXPECT_EQ(to_snorm<int16_t>(from_snorm(int16_t(i))), i);
+    for(int i=0; i<=255; ++i)
+        EXPECT_EQ(to_unorm<uint8_t>(from_unorm(uint8_t(i))), i);
+
+    // -MIN decodes to -1 as well
+    EXPECT_EQ(from_snorm(int8_t(-128)), -1.0f);
+    EXPECT_EQ(to_snorm<int8_t>(-5.0f), -127);
+    EXPECT_EQ(to_unorm<uint16_t>(2.0f), 65535);
+    EXPECT_EQ(to_unorm<uint16_t>(-1.0f), 0);
+
+    auto v = Vec4{0.25f, -0.5f, 1.0f, -0.75f};
+    auto back = from_snorm(to_snorm<int16_t>(v));
+    for(size_t k=0; k<4; ++k)
+        EXPECT_NEAR(back[k], v[k], 0.5f / 32767.0f);
+}
+
+TEST(quantize, NormBatchMatchesScalar){
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> dist(-1.2f, 1.2f);
+    std::vector<float> in(1023);
+    for(auto& f: in)
+        f = dist(rng);
+    // exact ties and clamped ends
+    in[0] = 0.5f / 127.0f;
+    in[1] = -0.5f / 127.0f;
+    in[2] = -1.0f;
+
+    std::vector<int8_t> snorm(in.size());
+    std::vector<uint16_t> unorm(in.size());
+    std::vector<float> back(in.size());
+    to_snorm_batch<int8_t>(in, snorm);
+    from_snorm_batch<int8_t>(snorm, back);
+    for(size_t i=0; i<in.size(); ++i){
+        EXPECT_EQ(snorm[i], to_snorm<int8_t>(in[i])) << in[i];
+        EXPECT_EQ(back[i], from_snorm(snorm[i]));
+    }
+    to_unorm_batch<uint16_t>(in, unorm);
+    from_unorm_batch<uint16_t>(unorm, back);
+    for(size_t i=0; i<in.size(); ++i){
+        EXPECT_EQ(unorm[i], to_unorm<uint16_t>(in[i])) << in[i];
+        EXPECT_EQ(back[i], from_unorm(unorm[i]));
+    }
+}
+
+TEST(quantize, OctahedralError){
+    auto normals = randomNormals(100'000);
+    // axes and octant diagonals hit the fold seams
+    normals.push_back(Vec3{0, 0, -1});
+    normals.push_back(Vec3{-1, 0, 0});
+    normals.push_back(normalize(Vec3{1, -1, -1}));
+    normals.push_back(normalize(Vec3{-1, 1, 0}));
+    // no direction: decodes to +Z
+    EXPECT_EQ(decode_octahedral(encode_octahedral(Vec3{0, 0, 0})), (Vec3{0, 0, 1}));
+    EXPECT_EQ(decode_octahedral(encode_octahedral(Vec3{-0.0f, 0, -0.0f})), (Vec3{0, 0, 1}));
+
+    float maxError = 0.0f;
+    for(auto n: normals){
+        auto decoded = decode_octahedral(encode_octahedral(n));
+        EXPECT_NEAR(norm(decoded), 1.0f, 1e-5f);
+        maxError = std::max(maxError, angleDegrees(n, decoded));
+    }
+    EXPECT_LT(maxError, 0.01f);
+}
+
+TEST(quantize, OctahedralBatchMatchesScalar){
+    auto normals = randomNormals(1023);
+    normals[0] = Vec3{0, 0, -1};
+    normals[1] = Vec3{-0.0f, 1, 0};
+    normals[2] = Vec3{0, 0, 0};
+    normals[3] = Vec3{-0.0f, -0.0f, -0.0f};
+
+    std::vector<OctNormal> packed(normals.size());
+    std::vector<Vec3> unpacked(normals.size());
+    encode_octahedral_batch(normals, packed);
+    decode_octahedral_batch(packed, unpacked);
+    for(size_t i=0; i<normals.size(); ++i){
+        EXPECT_EQ(packed[i], encode_octahedral(normals[i])) << i;
+        auto expected = decode_octahedral(packed[i]);
+        for(size_t k=0; k<3; ++k)
+            EXPECT_NEAR(unpacked[i][k], expected[k], 1e-6f);
+    }
+}
+
+TEST(quantize, SmallestThreeError){
+    auto quats = randomQuats(100'000);
+    quats.push_back(Vec4{0, 0, 0, 1});
+    quats.push_back(Vec4{0, 0, -1, 0});
+    quats.push_back(normalize(Vec4{1, 1, 1, 1}));
+    quats.push_back(normalize(Vec4{1, -1, 0, 0}));
+
+    float maxError = 0.0f;
+    for(auto q: quats){
+        auto decoded = unpack_quat(pack_quat(q));
+        // q and -q are the same rotation
+        auto sign = dot(q, decoded) < 0.0f ? -1.0f : 1.0f;
+        for(size_t k=0; k<4; ++k)
+            maxError = std::max(maxError, std::abs(q[k] - sign*decoded[k]));
+    }
+    EXPECT_LT(maxError, 0.002f);
+
+    // rotating a vector with the decoded quaternion stays close
+    auto q = normalize(Vec4{0.3f, -0.2f, 0.9f, 0.4f});
+    auto v = Vec3{1, 2, 3};
+    auto expected = rotate(v, q);
+    auto actual = rotate(v, unpack_quat(pack_quat(q)));
+    for(size_t k=0; k<3; ++k)
+        EXPECT_NEAR(actual[k], expected[k], 0.02f);
+
+    std::vector<PackedQuat> packed(quats.size());
+    std::vector<Vec4> unpacked(quats.size());
+    pack_quat_batch(quats, packed);
+    unpack_quat_batch(packed, unpacked);
+    for(size_t i=0; i<quats.size(); ++i){
+        EXPECT_EQ(packed[i], pack_quat(quats[i]));
+        EXPECT_EQ(unpacked[i], unpack_quat(packed[i]));
+    }
+}
@@ -0,0 +1,144 @@
+#include <bit>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "slot_map.hpp"
+#include "alloc_counter.hpp"
+
+using RenderToy::slot_map;
+
+TEST(slot_map, PushAndAccess){
+    slot_map<std::string> map;
+    auto h0 = map.push("a");
+    auto h1 = map.push("b");
+
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map[h0], "a");
+    EXPECT_EQ(map[h1], "b");
+}
+
+TEST(slot_map, StaleHandleThrows){
+    slot_map<int> map;
+    auto h0 = map.push(1);
+    map.remove(h0);
+
+    EXPECT_FALSE(map.contains(h0));
+    EXPECT_THROW(map[h0], std::out_of_range);
+    EXPECT_THROW(map.remove(h0), std::out_of_range);
+}
+
+TEST(slot_map, InvalidHandleThrows){
+    slot_map<int> map;
+    map.push(1);
+
+    RenderToy::generic_handle<int> invalid;
+    EXPECT_FALSE(map.contains(invalid));
+    EXPECT_THROW(map[invalid], std::out_of_range);
+}
+
+TEST(slot_map, TryGet){
+    slot_map<int> map;
+    auto h0 = map.push(5);
+
+    ASSERT_NE(map.try_get(h0), nullptr);
+    EXPECT_EQ(*map.try_get(h0), 5);
+
+    map.remove(h0);
+    EXPECT_EQ(map.try_get(h0), nullptr);
+}
+
+TEST(slot_map, GetUnchecked){
+    slot_map<int> map;
+    auto h0 = map.push(5);
+    EXPECT_EQ(map.get_unchecked(h0), 5);
+
+#ifndef NDEBUG
+    map.remove(h0);
+    EXPECT_DEATH(map.get_unchecked(h0), "");
+#endif
+}
+
+TEST(slot_map, GrowthMovesValues){
+    slot_map<std::string> map;
+    std::vector<RenderToy::generic_handle<std::string>> handles;
+    for(int i=0; i<100; ++i)
+        handles.push_back(map.push(std::to_string(i)));
+
+    for(int i=0; i<100; ++i)
+        EXPECT_EQ(map[handles[i]], std::to_string(i));
+}
+
+TEST(slot_map, ClearInvalidatesHandles){
+    slot_map<std::string> map;
+    auto h0 = map.push("a");
+    auto h1 = map.push("b");
+    map.remove(h0);
+
+    map.clear();
+    EXPECT_EQ(map.size(), 0u);
+    EXPECT_FALSE(map.contains(h1));
+
+    auto h2 = map.push("c");
+    EXPECT_EQ(map[h2], "c");
+}
+
+TEST(slot_map, PushRangeAndRemoveRange){
+    slot_map<std::string> map;
+    std::vector<std::string> values = {"a", "b", "c", "d"};
+    std::vector<RenderToy::generic_handle<std::string>> buffer(values.size());
+
+    auto handles = map.push_range(values, buffer);
+    ASSERT_EQ(handles.size(), 4u);
+    EXPECT_EQ(map.size(), 4u);
+    EXPECT_EQ(map[handles[0]], "a");
+    EXPECT_EQ(map[handles[3]], "d");
+
+    map.remove_range(handles.first(2));
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_FALSE(map.contains(handles[0]));
+    EXPECT_EQ(map[handles[2]], "c");
+}
+
+TEST(slot_map, ReserveUsesLowIndexFirst){
+    slot_map<int> map;
+    map.reserve(8);
+    EXPECT_EQ(map.size(), 0u);
+    EXPECT_EQ(map.capacity(), 8u);
+
+    auto h0 = map.push(1);
+    auto h1 = map.push(2);
+    EXPECT_EQ(h0.index, 0u);
+    EXPECT_EQ(h1.index, 1u);
+    EXPECT_EQ(map.capacity(), 8u);
+}
+
+TEST(slot_map, ShrinkToFitKeepsStaleHandlesStale){
+    slot_map<int> map;
+    std::vector<RenderToy::generic_handle<int>> handles;
+    for(int i=0; i<8; ++i)
+        handles.push_back(map.push(int(i)));
+    for(int i=2; i<8; ++i)
+        map.remove(handles[i]);
+
+    map.shrink_to_fit();
+    EXPECT_EQ(map.capacity(), 2u);
+    EXPECT_EQ(map[handles[1]], 1);
+
+    // regrown slots must not revive trimmed handles
+    for(int i=0; i<6; ++i)
+        map.push(int(100 + i));
+    for(int i=2; i<8; ++i)
+        EXPECT_FALSE(map.contains(handles[i]));
+}
+
+TEST(slot_map, BulkLoadAllocatesLogarithmically){
+    constexpr size_t COUNT = 100000;
+    slot_map<int> map;
+
+    RenderToy::test::AllocationScope scope;
+    for(size_t i=0; i<COUNT; ++i)
+        map.push(int(i));
+
+    // geometric growth: about log2(COUNT) reallocations
+    EXPECT_LE(scope.count(), 2*std::bit_width(COUNT));
+}
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <numeric>
+#include <gtest/gtest.h>
+#include "strided_span.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    struct Row{
+        uint32_t id;
+        float x;
+        float y;
+    };
+    static_assert(std::random_access_iterator<strided_span<float>::iterator>);
+    static_assert(std::random_access_iterator<strided_span<const float>::iterator>);
+}
+
+TEST(strided_span, ViewsOneFieldOfRows){
+    std::array<Row, 5> rows{};
+    for(uint32_t i=0; i<rows.size(); ++i)
+        rows[i] = {i, float(i), -float(i)};
+
+    strided_span<float> xs(&rows[0].x, rows.size(), sizeof(Row));
+    ASSERT_EQ(xs.size(), 5u);
+    EXPECT_EQ(xs.stride(), sizeof(Row));
+    EXPECT_FALSE(xs.contiguous());
+    for(Index i=0; i<xs.size(); ++i)
+        EXPECT_EQ(xs[i], float(i));
+
+    for(auto& x: xs)
+        x *= 2.0f;
+    EXPECT_EQ(rows[3].x, 6.0f);
+    EXPECT_EQ(rows[3].y, -3.0f);
+    EXPECT_EQ(std::accumulate(xs.begin(), xs.end(), 0.0f), 20.0f);
+}
+
+TEST(strided_span, IteratorArithmetic){
+    std::array<Row, 8> rows{};
+    for(uint32_t i=0; i<rows.size(); ++i)
+        rows[i].id = 7 - i;
+
+    strided_span<const uint32_t> ids(&rows[0].id, rows.size(), sizeof(Row));
+    EXPECT_EQ(ids.end() - ids.begin(), 8);
+    EXPECT_EQ(*(ids.begin() + 3), 4u);
+    EXPECT_EQ(ids.begin()[7], 0u);
+    EXPECT_LT(ids.begin(), ids.end());
+    EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end(), std::greater<>{}));
+
+    auto it = ids.end();
+    --it;
+    EXPECT_EQ(*it, 0u);
+    EXPECT_EQ(std::ranges::find(ids, 5u) - ids.begin(), 2);
+}
+
+TEST(strided_span, SubspanAndContiguous){
+    std::array<float, 6> packed = {0, 1, 2, 3, 4, 5};
+    strided_span<float> all{std::span<float>(packed)};
+    EXPECT_TRUE(all.contiguous());
+    EXPECT_EQ(all.as_span().data(), packed.data());
+
+    auto middle = all.subspan(2, 3);
+    ASSERT_EQ(middle.size(), 3u);
+    EXPECT_EQ(middle.front(), 2.0f);
+    EXPECT_EQ(middle.back(), 4.0f);
+
+    strided_span<float> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+}
@@ -0,0 +1,59 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "work_stealing_deque.hpp"
+
+using namespace RenderToy;
+
+TEST(work_stealing_deque, OwnerIsLifoThievesAreFifo){
+    std::vector<int> values(4);
+    work_stealing_deque<int*> deque(2);
+    for(auto& value: values)
+        deque.push(&value);
+    EXPECT_EQ(deque.size(), 4);
+
+    EXPECT_EQ(deque.take(), &values[3]);
+    EXPECT_EQ(deque.steal(), &values[0]);
+    EXPECT_EQ(deque.take(), &values[2]);
+    EXPECT_EQ(deque.steal(), &values[1]);
+    EXPECT_EQ(deque.take(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(work_stealing_deque, EveryItemIsTakenOrStolenOnce){
+    constexpr int COUNT = 200'000;
+    constexpr int THIEVES = 3;
+    std::vector<int> items(COUNT);
+    std::vector<std::atomic<int>> hits(COUNT);
+    work_stealing_deque<int*> deque(16);
+    std::atomic<bool> pushing = true;
+
+    std::vector<std::thread> thieves;
+    for(int t=0; t<THIEVES; ++t){
+        thieves.emplace_back([&]{
+            while(pushing.load() || !deque.empty()){
+                if(auto item = deque.steal())
+                    hits[item - items.data()].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    // the owner pushes in bursts and takes some back, racing the thieves
+    // for the last element and growing the ring under them
+    for(int i=0; i<COUNT; ++i){
+        deque.push(&items[i]);
+        if(i % 3 == 0){
+            if(auto item = deque.take())
+                hits[item - items.data()].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while(auto item = deque.take())
+        hits[item - items.data()].fetch_add(1, std::memory_order_relaxed);
+    pushing.store(false);
+    for(auto& thief: thieves)
+        thief.join();
+
+    for(const auto& hit: hits)
+        ASSERT_EQ(hit.load(), 1);
+}
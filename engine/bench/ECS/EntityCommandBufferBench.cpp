@@ -0,0 +1,56 @@
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "ECS/EntityCommandBuffer.hpp"
+#include "ECS/EntityRegistry.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    std::vector<EntityID> createBodies(EntityRegistry& registry, size_t count){
+        std::vector<EntityID> ids(count);
+        for(auto& id: ids){
+            id = registry.createEntity(
+                Transform{.entity = NULL_ENTITY, .isActive = true, .position = zeros(), .rotation = unitQuat(), .scale = ones()},
+                Rigidbody{.entity = NULL_ENTITY, .isActive = true, .velocity = zeros(), .useGravity = true, .mass = 1.0f}
+            );
+        }
+        return ids;
+    }
+    Collided makeCollided(){
+        return Collided{.entity = NULL_ENTITY, .isActive = true};
+    }
+}
+
+// one combat tick: tag every other body as Collided, then clear the tags
+static void BM_ToggleTagImmediate(benchmark::State& state){
+    EntityRegistry registry;
+    auto ids = createBodies(registry, size_t(state.range(0)));
+
+    for(auto _: state){
+        for(size_t i=0; i<ids.size(); i+=2)
+            registry.appendComponent(ids[i], makeCollided());
+        for(size_t i=0; i<ids.size(); i+=2)
+            registry.removeComponent<Collided>(ids[i]);
+    }
+    state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+static void BM_ToggleTagCommandBuffer(benchmark::State& state){
+    EntityRegistry registry;
+    auto ids = createBodies(registry, size_t(state.range(0)));
+    EntityCommandBuffer commands;
+
+    for(auto _: state){
+        for(size_t i=0; i<ids.size(); i+=2)
+            commands.appendComponent(ids[i], makeCollided());
+        commands.playback(registry);
+        for(size_t i=0; i<ids.size(); i+=2)
+            commands.removeComponent<Collided>(ids[i]);
+        commands.playback(registry);
+    }
+    state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+BENCHMARK(BM_ToggleTagImmediate)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(BM_ToggleTagCommandBuffer)->Arg(1'000)->Arg(10'000)->Arg(100'000);
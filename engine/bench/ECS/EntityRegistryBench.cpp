@@ -0,0 +1,82 @@
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "ECS/EntityRegistry.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    LifeSpan makeLifeSpan(){
+        return LifeSpan{.entity = NULL_ENTITY, .isActive = true, .isAlive = true};
+    }
+    Element makeElement(EntityID id){
+        return Element{.entity = id, .isActive = true, .type = ElementType::FIRE};
+    }
+    std::vector<EntityID> createBodies(EntityRegistry& registry, size_t count){
+        std::vector<EntityID> ids(count);
+        for(auto& id: ids){
+            id = registry.createEntity(
+                Transform{.entity = NULL_ENTITY, .isActive = true, .position = zeros(), .rotation = unitQuat(), .scale = ones()},
+                Rigidbody{.entity = NULL_ENTITY, .isActive = true, .velocity = zeros(), .useGravity = true, .mass = 1.0f}
+            );
+        }
+        return ids;
+    }
+}
+
+// append + remove one component on a registry of N entities.
+// each move swap-removes from the N-sized archetype, so the cost of
+// relinking the swapped entity is what scales (or doesn't) with N.
+static void BM_AppendRemoveComponent(benchmark::State& state){
+    auto count = size_t(state.range(0));
+    EntityRegistry registry;
+    std::vector<EntityID> ids(count);
+    for(auto& id: ids)
+        id = registry.createEntity(makeLifeSpan());
+
+    size_t next = 0;
+    for(auto _: state){
+        auto id = ids[next];
+        next = (next + 7919) % count;
+        registry.appendComponent(id, makeElement(id));
+        registry.removeComponent<Element>(id);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+static void BM_DestroyCreate(benchmark::State& state){
+    auto count = size_t(state.range(0));
+    EntityRegistry registry;
+    std::vector<EntityID> ids(count);
+    for(auto& id: ids)
+        id = registry.createEntity(makeLifeSpan());
+
+    size_t next = 0;
+    for(auto _: state){
+        registry.destroyEntity(ids[next]);
+        ids[next] = registry.createEntity(makeLifeSpan());
+        next = (next + 7919) % count;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// two tags on and off a body: four structural changes per entity, walking
+// body -> +Grounded -> +Collided -> -Grounded -> -Collided
+static void BM_ToggleTags(benchmark::State& state){
+    EntityRegistry registry;
+    auto ids = createBodies(registry, size_t(state.range(0)));
+
+    for(auto _: state){
+        for(auto id: ids){
+            registry.appendComponent(id, Grounded{.entity = NULL_ENTITY, .isActive = true});
+            registry.appendComponent(id, Collided{.entity = NULL_ENTITY, .isActive = true});
+            registry.removeComponent<Grounded>(id);
+            registry.removeComponent<Collided>(id);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ids.size() * 4);
+}
+
+BENCHMARK(BM_AppendRemoveComponent)->RangeMultiplier(10)->Range(1'000, 10'000'000);
+BENCHMARK(BM_DestroyCreate)->RangeMultiplier(10)->Range(1'000, 10'000'000);
+BENCHMARK(BM_ToggleTags)->Arg(1'000)->Arg(10'000)->Arg(100'000);
@@ -0,0 +1,239 @@
+#include <benchmark/benchmark.h>
+#include "job_system.hpp"
+#include "ECS/EntityRegistry.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    constexpr size_t TAG_COUNT = 8;
+    constexpr size_t PER_ARCHETYPE = 4;
+    constexpr size_t BODY_COUNT = 16;
+
+    template<typename Tag>
+    void tagIf(EntityRegistry& registry, EntityID id, bool on){
+        if(on)
+            registry.appendComponent(id, Tag{.entity = id, .isActive = true});
+    }
+
+    // Transform + every subset of 8 tags: 256 archetypes of 4 entities,
+    // and one small Transform + Rigidbody archetype the systems care about
+    void populate(EntityRegistry& registry){
+        for(size_t mask=0; mask<(size_t(1) << TAG_COUNT); ++mask){
+            for(size_t i=0; i<PER_ARCHETYPE; ++i){
+                auto id = registry.createEntity(
+                    Transform{.entity = NULL_ENTITY, .isActive = true, .position = zeros(), .rotation = unitQuat(), .scale = ones()}
+                );
+                tagIf<Player>(registry, id, mask & 1);
+                tagIf<Editor>(registry, id, mask & 2);
+                tagIf<Attachable>(registry, id, mask & 4);
+                tagIf<Climbable>(registry, id, mask & 8);
+                tagIf<Inventory>(registry, id, mask & 16);
+                tagIf<Lootable>(registry, id, mask & 32);
+                tagIf<LootMagnet>(registry, id, mask & 64);
+                tagIf<Collided>(registry, id, mask & 128);
+            }
+        }
+        for(size_t i=0; i<BODY_COUNT; ++i){
+            registry.createEntity(
+                Transform{.entity = NULL_ENTITY, .isActive = true, .position = zeros(), .rotation = unitQuat(), .scale = ones()},
+                Rigidbody{.entity = NULL_ENTITY, .isActive = true, .velocity = zeros(), .useGravity = true, .mass = 1.0f}
+            );
+        }
+    }
+}
+
+// a system touching a few entities among hundreds of archetypes:
+// the cost is finding them, not iterating them
+static void BM_QueryRare(benchmark::State& state){
+    EntityRegistry registry;
+    populate(registry);
+
+    for(auto _: state){
+        float mass = 0.0f;
+        for(auto [id, bit, rigidbody]: registry.query<const Rigidbody>())
+            mass += rigidbody.mass;
+        benchmark::DoNotOptimize(mass);
+    }
+    state.SetItemsProcessed(state.iterations() * BODY_COUNT);
+}
+
+static void BM_QueryRarePersistent(benchmark::State& state){
+    EntityRegistry registry;
+    populate(registry);
+    auto query = registry.makeQuery<const Rigidbody>();
+
+    for(auto _: state){
+        float mass = 0.0f;
+        for(auto [id, bit, rigidbody]: query)
+            mass += rigidbody.mass;
+        benchmark::DoNotOptimize(mass);
+    }
+    state.SetItemsProcessed(state.iterations() * BODY_COUNT);
+}
+
+static void BM_QueryAll(benchmark::State& state){
+    EntityRegistry registry;
+    populate(registry);
+
+    for(auto _: state){
+        float x = 0.0f;
+        for(auto [id, bit, transform]: registry.query<const Transform>())
+            x += transform.position.x;
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations() * registry.query<const Transform>().size());
+}
+
+static void BM_QuerySize(benchmark::State& state){
+    EntityRegistry registry;
+    populate(registry);
+
+    for(auto _: state)
+        benchmark::DoNotOptimize(registry.query<Transform, const Rigidbody>().size());
+}
+
+// position += velocity * dt over Transform + Rigidbody, half of the
+// bodies tagged Grounded so the query spans two archetypes
+namespace
+{
+    constexpr float DT = 1.0f / 60.0f;
+
+    void populateBodies(EntityRegistry& registry, size_t count){
+        for(size_t i=0; i<count; ++i){
+            auto id = registry.createEntity(
+                Transform{.entity = NULL_ENTITY, .isActive = true, .position = zeros(), .rotation = unitQuat(), .scale = ones()},
+                Rigidbody{.entity = NULL_ENTITY, .isActive = true, .velocity = {1.0f, 2.0f, 3.0f}, .useGravity = true, .mass = 1.0f}
+            );
+            if(i % 2)
+                registry.appendComponent(id, Grounded{.entity = id, .isActive = true});
+        }
+    }
+}
+
+static void BM_IntegratePerEntity(benchmark::State& state){
+    auto count = size_t(state.range(0));
+    EntityRegistry registry;
+    populateBodies(registry, count);
+
+    for(auto _: state){
+        for(auto [id, bit, transform, rigidbody]: registry.query<Transform, const Rigidbody>()){
+            transform.position.x += rigidbody.velocity.x * DT;
+            transform.position.y += rigidbody.velocity.y * DT;
+            transform.position.z += rigidbody.velocity.z * DT;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_IntegratePerChunk(benchmark::State& state){
+    auto count = size_t(state.range(0));
+    EntityRegistry registry;
+    populateBodies(registry, count);
+
+    for(auto _: state){
+        registry.query<Transform, const Rigidbody>().forEachChunk([](auto, auto transforms, auto rigidbodies){
+            for(Index i=0; i<transforms.size(); ++i){
+                auto& position = transforms[i].position;
+                const auto& velocity = rigidbodies[i].velocity;
+                position.x += velocity.x * DT;
+                position.y += velocity.y * DT;
+                position.z += velocity.z * DT;
+            }
+        });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// same integration over 2M bodies, on a pool of range(0) threads
+// (range(0) - 1 workers plus the calling thread)
+static void BM_IntegrateParallel(benchmark::State& state){
+    constexpr size_t COUNT = 2'000'000;
+    EntityRegistry registry;
+    populateBodies(registry, COUNT);
+    job_system jobs(size_t(state.range(0)) - 1);
+
+    for(auto _: state){
+        registry.query<Transform, const Rigidbody>().parallelForEachChunk([](auto, auto transforms, auto rigidbodies){
+            for(Index i=0; i<transforms.size(); ++i){
+                auto& position = transforms[i].position;
+                const auto& velocity = rigidbodies[i].velocity;
+                position.x += velocity.x * DT;
+                position.y += velocity.y * DT;
+                position.z += velocity.z * DT;
+            }
+        }, ArchetypeView<Transform, const Rigidbody>::PARALLEL_GRAIN, jobs);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+
+
+// 500k mostly static transforms with range(0) of them moved per frame,
+// scattered over the level. A reader that only wants the movers either
+// scans everything or filters on Changed<Transform>
+namespace
+{
+    constexpr size_t LEVEL_SIZE = 500'000;
+
+    std::vector<EntityID> populateLevel(EntityRegistry& registry){
+        std::vector<EntityID> ids;
+        for(size_t i=0; i<LEVEL_SIZE; ++i){
+            ids.push_back(registry.createEntity(
+                Transform{.entity = NULL_ENTITY, .isActive = true, .position = zeros(), .rotation = unitQuat(), .scale = ones()}
+            ));
+        }
+        return ids;
+    }
+    void moveSome(EntityRegistry& registry, const std::vector<EntityID>& ids, size_t count, size_t& next){
+        for(size_t i=0; i<count; ++i){
+            next = (next + 7919) % ids.size();
+            std::get<0>(registry.query<Transform>(ids[next])).position.x += 1.0f;
+        }
+    }
+}
+
+static void BM_MovedScanAll(benchmark::State& state){
+    EntityRegistry registry;
+    auto ids = populateLevel(registry);
+    size_t next = 0;
+
+    for(auto _: state){
+        moveSome(registry, ids, size_t(state.range(0)), next);
+        float x = 0.0f;
+        for(auto [id, bit, transform]: registry.query<const Transform>())
+            x += transform.position.x;
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations() * LEVEL_SIZE);
+}
+
+static void BM_MovedChanged(benchmark::State& state){
+    EntityRegistry registry;
+    auto ids = populateLevel(registry);
+    auto moved = registry.makeQuery<const Transform, Changed<Transform>>();
+    moved.view();
+    size_t next = 0;
+
+    for(auto _: state){
+        moveSome(registry, ids, size_t(state.range(0)), next);
+        float x = 0.0f;
+        for(auto [id, bit, transform]: moved)
+            x += transform.position.x;
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations() * LEVEL_SIZE);
+}
+
+BENCHMARK(BM_QueryRare);
+BENCHMARK(BM_QueryRarePersistent);
+BENCHMARK(BM_QueryAll);
+BENCHMARK(BM_QuerySize);
+// 5k fits in L2, 50k in L3, 5M streams from memory
+BENCHMARK(BM_IntegratePerEntity)->Arg(5'000)->Arg(50'000)->Arg(5'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_IntegratePerChunk)->Arg(5'000)->Arg(50'000)->Arg(5'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_IntegrateParallel)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MovedScanAll)->Arg(0)->Arg(500)->Arg(50'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MovedChanged)->Arg(0)->Arg(500)->Arg(50'000)->Unit(benchmark::kMicrosecond);
@@ -6,6 +6,7 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "culling.hpp"
 #include "Primitives.hpp"
 
 namespace RenderToy
@@ -46,20 +47,6 @@ namespace RenderToy
         double unitScale = 0.01f;   // Conversion factor (e.g., 0.01 for cm to meters)
     };
 
-    // ============================================================================
-    // Bounding Volume
-    // ============================================================================
-
-    /// Axis-Aligned Bounding Box
-    struct AABB{
-        Vec3 min = zeros();
-        Vec3 max = zeros();
-
-        inline Vec3 center() const { return (min + max) * 0.5f; }
-        inline Vec3 extents() const { return (max - min) * 0.5f; }
-        inline bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
-    };
-
     // ============================================================================
     // Primitive Type
     // ============================================================================
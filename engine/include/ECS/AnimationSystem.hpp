@@ -14,5 +14,6 @@ namespace RenderToy
 
         SystemChain execAfter() const override;
         SystemChain execBefore() const override;
+        ComponentAccess getAccess() const override;
     };
 }
\ No newline at end of file
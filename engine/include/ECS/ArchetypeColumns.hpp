@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstring>
+#include <span>
+#include "column_vector.hpp"
+#include "ptr_util.hpp"
+#include "ECS/Entity.hpp"
+#include "ECS/Component.hpp"
+
+namespace RenderToy
+{
+    // Columnar storage of one archetype.
+    // Same bit/size_of/offset_of metadata as the AoS chunk in dynamic_vector,
+    // but every component gets its own aligned column.
+    class ArchetypeColumns{
+    private:
+        const ArchetypeBit bit;
+        column_vector columns;
+
+    public:
+        explicit ArchetypeColumns(ArchetypeBit bit, size_t initial_cap = 0)
+        :bit(bit), columns(column_sizes_of(bit), initial_cap){}
+
+        ArchetypeBit archetype() const{ return bit; }
+        size_t size() const{ return columns.size(); }
+        size_t capacity() const{ return columns.capacity(); }
+        void reserve(size_t new_cap){ columns.reserve(new_cap); }
+        void clear(){ columns.clear(); }
+
+        std::span<EntityID>       entities()      { return columns.column<EntityID>(0); }
+        std::span<const EntityID> entities() const{ return columns.column<EntityID>(0); }
+
+        template<typename T>
+        std::span<T> column(){
+            assert(isSubset(bit_of<T>(), bit) && "component not in archetype");
+            return columns.column<T>(column_of<T>(bit));
+        }
+        template<typename T>
+        std::span<const T> column() const{
+            assert(isSubset(bit_of<T>(), bit) && "component not in archetype");
+            return columns.column<T>(column_of<T>(bit));
+        }
+
+        // components in any order, must cover the archetype exactly
+        template<all_value... Ts>
+        Index emplace(EntityID id, Ts&&... ts){
+            assert(bits_of<std::remove_cvref_t<Ts>...>() == bit);
+            auto row = columns.emplace_back();
+            ptrCast<EntityID>(columns.at(0, row)) = id;
+            ((ptrCast<std::remove_cvref_t<Ts>>(columns.at(column_of<std::remove_cvref_t<Ts>>(bit), row))
+                = std::forward<Ts>(ts)), ...);
+            return row;
+        }
+
+        // scatter an AoS chunk (dynamic_vector layout) into a new row
+        Index emplace_chunk(const void* chunk){
+            auto row = columns.emplace_back();
+            for(Index i=0; i<columns.column_count(); ++i){
+                auto size = columns.column_size(i);
+                std::memcpy(columns.at(i, row), chunk, size);
+                chunk = ptrAdd(chunk, size);
+            }
+            return row;
+        }
+        // gather a row back into an AoS chunk of size_of(bit) bytes
+        void copy_chunk(Index row, void* chunk) const{
+            for(Index i=0; i<columns.column_count(); ++i){
+                auto size = columns.column_size(i);
+                chunk = ptrWrite(chunk, columns.at(i, row), size);
+            }
+        }
+
+        void swap_remove(Index row){ columns.swap_remove(row); }
+    };
+}
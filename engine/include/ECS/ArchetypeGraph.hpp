@@ -0,0 +1,380 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+#include "dynamic_vector.hpp"
+#include "flat_hash_map.hpp"
+#include "ptr_util.hpp"
+#include "strided_span.hpp"
+#include "ECS/Archetype.hpp"
+#include "ECS/Component.hpp"
+
+namespace RenderToy
+{
+    // Change ticks wrap around: `tick` is newer than `since` when it is
+    // less than half the range ahead. Rows untouched for 2^31 ticks may
+    // show up as changed once more, which only costs a redundant update.
+    constexpr bool isNewerTick(uint32_t tick, uint32_t since){
+        return int32_t(tick - since) > 0;
+    }
+
+    // One archetype: its chunk storage, the byte layout of its chunk, the
+    // change ticks of its components, and cached edges to the archetypes
+    // one component away.
+    class Archetype{
+    public:
+        static constexpr uint32_t NONE = uint32_t(-1);
+        // change ticks are also kept per block of rows, so filters can
+        // skip blocks nobody touched without reading their rows
+        static constexpr size_t TICK_BLOCK_SHIFT = 8;
+        static constexpr size_t TICK_BLOCK = size_t(1) << TICK_BLOCK_SHIFT;
+
+        // memcpy [src, src + size) of the old chunk to [dst, dst + size)
+        struct CopyRun{
+            uint32_t src = 0;
+            uint32_t dst = 0;
+            uint32_t size = 0;
+        };
+        // a chunk moves along an edge with two runs: the bytes before and
+        // after the added/removed component
+        struct Edge{
+            Archetype* target = nullptr;
+            CopyRun head;
+            CopyRun tail;
+            // where the added component goes in target, NONE for removal
+            uint32_t componentOffset = NONE;
+        };
+
+    private:
+        friend class ArchetypeGraph;
+
+        // ticks of one component: when each row got it and last wrote it,
+        // and the newest of each per block (never older than its rows)
+        struct Ticks{
+            std::vector<uint32_t> added;
+            std::vector<uint32_t> changed;
+            std::vector<uint32_t> addedBlocks;
+            std::vector<uint32_t> changedBlocks;
+        };
+
+    public:
+        // one component's row and block ticks, for loops that would rather
+        // not look the component up per row. Invalidated by allocate() and
+        // swapRemove()
+        struct TickColumn{
+            uint32_t* rows = nullptr;
+            uint32_t* blocks = nullptr;
+
+            bool newer(Index row, uint32_t since) const{ return isNewerTick(rows[row], since); }
+            bool blockNewer(Index block, uint32_t since) const{ return isNewerTick(load(blocks[block]), since); }
+            void mark(Index row, uint32_t tick) const{
+                markRow(row, tick);
+                markBlock(row >> TICK_BLOCK_SHIFT, tick);
+            }
+            // rows [begin, end) and the blocks holding them
+            void mark(Index begin, Index end, uint32_t tick) const{
+                if(begin == end)
+                    return;
+                std::fill(rows + begin, rows + end, tick);
+                for(auto block = begin >> TICK_BLOCK_SHIFT; block <= (end - 1) >> TICK_BLOCK_SHIFT; ++block)
+                    markBlock(block, tick);
+            }
+            // a row alone, for loops that stamped its block up front
+            void markRow(Index row, uint32_t tick) const{ rows[row] = tick; }
+            void markBlock(Index block, uint32_t tick) const{ stamp(blocks[block], tick); }
+        };
+
+    private:
+        const ArchetypeBit bit_;
+        const uint32_t chunkSize_;
+        // by component index, NONE if the component is absent
+        std::array<uint32_t, NUM_ARCHETYPES> offsets_;
+        std::array<Edge, NUM_ARCHETYPES> addEdges{};
+        std::array<Edge, NUM_ARCHETYPES> removeEdges{};
+        // one per component, in bit order
+        std::vector<Ticks> ticks_;
+
+    public:
+        // cache-line aligned base; blocks past 2 MiB ask for huge pages,
+        // so only large archetypes get them
+        using ChunkVector = huge_page_dynamic_vector;
+        ChunkVector chunks;
+
+        explicit Archetype(ArchetypeBit bit)
+        :bit_(bit), chunkSize_(uint32_t(size_of(bit))), ticks_(std::popcount(bit)), chunks(size_of(bit)){
+            offsets_.fill(NONE);
+            for(auto rest = bit; rest != 0; rest &= rest - 1)
+                offsets_[std::countr_zero(rest)] = uint32_t(offset_of(rest & (~rest + 1), bit));
+        }
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        ArchetypeBit bit() const{ return bit_; }
+        size_t chunkSize() const{ return chunkSize_; }
+        size_t size() const{ return chunks.size(); }
+
+        bool has(ArchetypeBit component) const{ return isSubset(component, bit_); }
+        template<typename T>
+        bool has() const{ return has(bit_of<T>()); }
+
+        // NONE if absent
+        uint32_t offset(ArchetypeBit component) const{ return offsets_[std::countr_zero(component)]; }
+        template<typename T>
+        uint32_t offset() const{
+            constexpr auto index = std::countr_zero(bit_of<T>());
+            return offsets_[index];
+        }
+
+        void* chunk(Index index){ return chunks[index]; }
+        const void* chunk(Index index) const{ return chunks[index]; }
+        template<typename T>
+        T& get(Index index){
+            assert(has<T>() && "component not in archetype");
+            return *static_cast<T*>(ptrAdd(chunks[index], offset<T>()));
+        }
+
+        // chunks are one contiguous block (huge_page_storage is a
+        // basic_contiguous_storage), so a component is a column strided by chunkSize()
+        strided_span<EntityID> entities(){ return column<EntityID>(0); }
+        strided_span<const EntityID> entities() const{ return column<const EntityID>(0); }
+        template<typename T>
+        strided_span<T> column(){
+            assert(has<T>() && "component not in archetype");
+            return column<T>(offset<T>());
+        }
+        template<typename T>
+        strided_span<const T> column() const{
+            assert(has<T>() && "component not in archetype");
+            return column<const T>(offset<T>());
+        }
+
+        // one uninitialized chunk at the end, its components added at `tick`
+        Index allocate(uint32_t tick){
+            return allocate(1, tick);
+        }
+        // `count` uninitialized chunks at the end; returns the first
+        Index allocate(size_t count, uint32_t tick){
+            auto base = chunks.size();
+            auto size = base + count;
+            chunks.resize(size);
+            if(count == 0)
+                return base;
+            for(auto& t: ticks_){
+                t.added.resize(size, tick);
+                t.changed.resize(size, tick);
+                t.addedBlocks.resize(blockCount(size), tick);
+                t.changedBlocks.resize(blockCount(size), tick);
+                // the block `base` is in may have older rows
+                stamp(t.addedBlocks[base >> TICK_BLOCK_SHIFT], tick);
+                stamp(t.changedBlocks[base >> TICK_BLOCK_SHIFT], tick);
+            }
+            return base;
+        }
+        // moves the last chunk into `index`, like dynamic_vector::swap_remove
+        void swapRemove(Index index){
+            chunks.swap_remove(index);
+            auto size = chunks.size();
+            for(auto& t: ticks_){
+                if(index < size){
+                    t.added[index] = t.added[size];
+                    t.changed[index] = t.changed[size];
+                    raise(t.addedBlocks[index >> TICK_BLOCK_SHIFT], t.added[index]);
+                    raise(t.changedBlocks[index >> TICK_BLOCK_SHIFT], t.changed[index]);
+                }
+                t.added.pop_back();
+                t.changed.pop_back();
+                t.addedBlocks.resize(blockCount(size));
+                t.changedBlocks.resize(blockCount(size));
+            }
+        }
+        // copy chunk `index` into a fresh chunk of edge.target. Components
+        // it keeps keep their ticks; the added one is added at `tick`
+        Index moveTo(const Edge& edge, Index index, uint32_t tick){
+            auto dstIndex = edge.target->allocate(tick);
+            auto src = chunks[index];
+            auto dst = edge.target->chunks[dstIndex];
+            std::memcpy(ptrAdd(dst, edge.head.dst), ptrAdd(src, edge.head.src), edge.head.size);
+            std::memcpy(ptrAdd(dst, edge.tail.dst), ptrAdd(src, edge.tail.src), edge.tail.size);
+            edge.target->copyTicks(*this, index, dstIndex);
+            return dstIndex;
+        }
+        // ticks of the components both archetypes have, from src's row
+        void copyTicks(const Archetype& src, Index srcIndex, Index index){
+            for(auto rest = bit_ & src.bit_; rest != 0; rest &= rest - 1){
+                auto component = rest & (~rest + 1);
+                const auto& from = src.ticks_[src.slot(component)];
+                auto& to = ticks_[slot(component)];
+                to.added[index] = from.added[srcIndex];
+                to.changed[index] = from.changed[srcIndex];
+                // the row was allocated at a tick no older than these
+            }
+        }
+
+        TickColumn changedColumn(ArchetypeBit component){
+            auto& t = ticks_[slot(component)];
+            return {t.changed.data(), t.changedBlocks.data()};
+        }
+        TickColumn addedColumn(ArchetypeBit component){
+            auto& t = ticks_[slot(component)];
+            return {t.added.data(), t.addedBlocks.data()};
+        }
+
+        // `components` of row `index` were written at `tick`
+        void markChanged(ArchetypeBit components, Index index, uint32_t tick){
+            for(auto rest = components; rest != 0; rest &= rest - 1)
+                changedColumn(rest & (~rest + 1)).mark(index, tick);
+        }
+        void markChanged(ArchetypeBit components, Index begin, Index end, uint32_t tick){
+            for(auto rest = components; rest != 0; rest &= rest - 1)
+                changedColumn(rest & (~rest + 1)).mark(begin, end, tick);
+        }
+        // `components` of row `index` were (re)added at `tick`
+        void markAdded(ArchetypeBit components, Index index, uint32_t tick){
+            markChanged(components, index, tick);
+            for(auto rest = components; rest != 0; rest &= rest - 1){
+                auto& t = ticks_[slot(rest & (~rest + 1))];
+                t.added[index] = tick;
+                stamp(t.addedBlocks[index >> TICK_BLOCK_SHIFT], tick);
+            }
+        }
+
+        // every `changed` component written and every `added` one added
+        // after `since`, in row `index`
+        bool changedSince(ArchetypeBit changed, ArchetypeBit added, Index index, uint32_t since) const{
+            for(auto rest = changed; rest != 0; rest &= rest - 1)
+                if(!isNewerTick(ticks_[slot(rest & (~rest + 1))].changed[index], since))
+                    return false;
+            for(auto rest = added; rest != 0; rest &= rest - 1)
+                if(!isNewerTick(ticks_[slot(rest & (~rest + 1))].added[index], since))
+                    return false;
+            return true;
+        }
+        // false only if no row of `block` can pass changedSince()
+        bool blockChangedSince(ArchetypeBit changed, ArchetypeBit added, Index block, uint32_t since) const{
+            for(auto rest = changed; rest != 0; rest &= rest - 1)
+                if(!isNewerTick(load(ticks_[slot(rest & (~rest + 1))].changedBlocks[block]), since))
+                    return false;
+            for(auto rest = added; rest != 0; rest &= rest - 1)
+                if(!isNewerTick(load(ticks_[slot(rest & (~rest + 1))].addedBlocks[block]), since))
+                    return false;
+            return true;
+        }
+        static size_t blockCount(size_t rows){ return (rows + TICK_BLOCK - 1) >> TICK_BLOCK_SHIFT; }
+
+    private:
+        // position of `component` among this archetype's components
+        Index slot(ArchetypeBit component) const{
+            assert(has(component) && "component not in archetype");
+            return std::popcount(bit_ & (component - 1));
+        }
+        // parallel jobs over neighbouring row ranges share blocks, and
+        // all store the same tick
+        static void stamp(uint32_t& block, uint32_t tick){
+            std::atomic_ref(block).store(tick, std::memory_order_relaxed);
+        }
+        static uint32_t load(const uint32_t& block){
+            return std::atomic_ref(const_cast<uint32_t&>(block)).load(std::memory_order_relaxed);
+        }
+        static void raise(uint32_t& block, uint32_t tick){
+            if(isNewerTick(tick, block))
+                block = tick;
+        }
+
+        template<typename T>
+        strided_span<T> column(uint32_t offset) const{
+            if(chunks.size() == 0)
+                return {};
+            // constness comes from T; the public overloads pick it
+            auto base = const_cast<void*>(chunks[0]);
+            return {ptrAdd(base, offset), chunks.size(), chunkSize_};
+        }
+    };
+
+    // Owns every archetype, keyed by bit. Archetypes are boxed: they never
+    // move, so Archetype* and edges stay valid while the graph grows.
+    class ArchetypeGraph{
+    public:
+        using Map = flat_hash_map<ArchetypeBit, std::unique_ptr<Archetype>>;
+
+    private:
+        Map map;
+        // every archetype in creation order; queries read the tail they
+        // haven't seen yet
+        std::vector<Archetype*> order;
+        // registry writes carry the current tick; each query view takes
+        // one of its own by advancing it, so it never sees its own writes
+        std::atomic<uint32_t> tick = 1;
+
+    public:
+        ArchetypeGraph() = default;
+        ArchetypeGraph(const ArchetypeGraph&) = delete;
+        ArchetypeGraph& operator=(const ArchetypeGraph&) = delete;
+
+        Archetype& get(ArchetypeBit bit){
+            if(auto it = map.find(bit); it != map.end())
+                return *it->second;
+            auto [it, _] = map.try_emplace(bit, std::make_unique<Archetype>(bit));
+            order.push_back(it->second.get());
+            return *it->second;
+        }
+        Archetype* find(ArchetypeBit bit){
+            auto it = map.find(bit);
+            return it != map.end() ? it->second.get() : nullptr;
+        }
+
+        // edge from `from` to from + component, created on first use
+        const Archetype::Edge& addEdge(Archetype& from, ArchetypeBit component){
+            auto i = std::countr_zero(component);
+            auto& edge = from.addEdges[i];
+            if(edge.target == nullptr)
+                link(from, get(from.bit() | component), i);
+            return edge;
+        }
+        // edge from `from` to from - component, created on first use
+        const Archetype::Edge& removeEdge(Archetype& from, ArchetypeBit component){
+            auto i = std::countr_zero(component);
+            auto& edge = from.removeEdges[i];
+            if(edge.target == nullptr)
+                link(get(from.bit() & ~component), from, i);
+            return edge;
+        }
+
+        uint32_t changeTick() const{ return tick.load(std::memory_order_relaxed); }
+        uint32_t advanceTick(){ return tick.fetch_add(1, std::memory_order_relaxed); }
+
+        size_t size() const{ return map.size(); }
+        std::span<Archetype* const> created() const{ return order; }
+        Map::iterator begin(){ return map.begin(); }
+        Map::iterator end(){ return map.end(); }
+        Map::const_iterator begin() const{ return map.begin(); }
+        Map::const_iterator end() const{ return map.end(); }
+        Map& archetypes(){ return map; }
+
+    private:
+        // both directions between `smaller` and `larger` = smaller + component i
+        static void link(Archetype& smaller, Archetype& larger, int i){
+            auto split = larger.offsets_[i];
+            auto size = uint32_t(component_size(ArchetypeBit(1) << i));
+            auto tail = smaller.chunkSize_ - split;
+
+            smaller.addEdges[i] = {
+                .target = &larger,
+                .head = {0, 0, split},
+                .tail = {split, split + size, tail},
+                .componentOffset = split
+            };
+            larger.removeEdges[i] = {
+                .target = &smaller,
+                .head = {0, 0, split},
+                .tail = {split + size, split, tail},
+                .componentOffset = Archetype::NONE
+            };
+        }
+    };
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <bit>
+#include <type_traits>
+#include <vector>
 #include "concepts.hpp"
+#include "core_types.hpp"
 #include "math.hpp"
 #include "Primitives.hpp"
 #include "Resource/Resource.hpp"
@@ -158,7 +162,11 @@ namespace RenderToy
 
     template<typename T>
     consteval ArchetypeBit bit_of(){
-        return 0;
+        // const T: read-only access to T in queries
+        if constexpr(std::is_const_v<T>)
+            return bit_of<std::remove_const_t<T>>();
+        else
+            return 0;
     }
     template<typename... Ts>
     consteval ArchetypeBit bits_of(){
@@ -220,6 +228,20 @@ namespace RenderToy
         return size;
     }
 
+    // runtime counterparts of sizeof(T) / offset_of<T>(bit) for a single
+    // component bit: components are laid out in bit order after the EntityID
+    constexpr size_t component_size(ArchetypeBit component){
+        #define X(type, name) \
+            if(component == name##_BIT) \
+                return sizeof(type);
+        ARCHETYPE_PAIRS
+        #undef X
+        return 0;
+    }
+    constexpr size_t offset_of(ArchetypeBit component, ArchetypeBit bit){
+        return size_of(bit & (component - 1));
+    }
+
     template<typename T>
     constexpr size_t offset_of(ArchetypeBit bit){
         if(!isSubset(bit_of<T>(), bit))
@@ -236,6 +258,29 @@ namespace RenderToy
         return offset;
     }
 
+    // columnar layout: column 0 is EntityID, then one column per component in bit order
+    constexpr size_t column_count_of(ArchetypeBit bit){
+        return 1 + std::popcount(bit);
+    }
+
+    template<typename T>
+    constexpr Index column_of(ArchetypeBit bit){
+        if(!isSubset(bit_of<T>(), bit))
+            return -1;
+
+        return 1 + std::popcount(bit & (bit_of<T>() - 1));
+    }
+
+    inline std::vector<size_t> column_sizes_of(ArchetypeBit bit){
+        std::vector<size_t> sizes{sizeof(EntityID)};
+        #define X(type, name) \
+            if(bit & name##_BIT) \
+                sizes.push_back(sizeof(type));
+        ARCHETYPE_PAIRS
+        #undef X
+        return sizes;
+    }
+
     constexpr std::string name_of(ArchetypeBit bit){
         switch(bit) {
         #define X(type, name) \
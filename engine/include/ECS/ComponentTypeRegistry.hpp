@@ -72,10 +72,9 @@ namespace RenderToy
             if constexpr(isBuiltIn<T>())
                 return offset;
 
+            // registered components are laid out in bit order too
             for(const auto& [rc_bit, info]: bitToInfo){
-                if(t_bit == rc_bit)
-                    break;
-                if(rc_bit & t_bit)
+                if(rc_bit < t_bit && (rc_bit & bit))
                     offset += info.size;
             }
             return offset;
@@ -1,8 +1,28 @@
 #pragma once
 
 #include <cstdint>
+#include "core_types.hpp"
 
 namespace RenderToy
 {
-    using EntityID = uint32_t;
-}
\ No newline at end of file
+    // slot index in the low bits, slot generation in the high bits.
+    // same contract as generic_handle. 32 generation bits: a slot retires
+    // when its generation saturates, so a stale id never matches again.
+    using EntityID = uint64_t;
+
+    inline constexpr uint32_t ENTITY_INDEX_BITS = 32;
+    inline constexpr uint32_t ENTITY_GENERATION_BITS = 64 - ENTITY_INDEX_BITS;
+    inline constexpr Index    MAX_ENTITY_COUNT = Index(1) << ENTITY_INDEX_BITS;
+    // generations start at 1, so 0 is never a live id
+    inline constexpr EntityID NULL_ENTITY = 0;
+
+    constexpr Index entity_index(EntityID id){
+        return id & (MAX_ENTITY_COUNT - 1);
+    }
+    constexpr uint32_t entity_generation(EntityID id){
+        return uint32_t(id >> ENTITY_INDEX_BITS);
+    }
+    constexpr EntityID make_entity(Index index, uint32_t generation){
+        return (EntityID(generation) << ENTITY_INDEX_BITS) | EntityID(index);
+    }
+}
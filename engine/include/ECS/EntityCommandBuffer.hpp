@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "concepts.hpp"
+#include "ECS/Component.hpp"
+#include "ECS/Entity.hpp"
+
+namespace RenderToy
+{
+    class EntityRegistry;
+
+    // Records structural changes and applies them to a registry later, in
+    // one batch. Same verbs as EntityRegistry.
+    // - record from any thread: every thread appends to its own stream
+    // - playback() runs on one thread, outside any ArchetypeView iteration,
+    //   and never concurrently with recording
+    // - per entity, one thread's commands apply in recorded order; the
+    //   order between threads is unspecified
+    // - chunk moves are grouped by (source, destination) archetype: the
+    //   copy layout is built once per group, then every chunk is memcpy'd
+    class EntityCommandBuffer{
+    private:
+        enum class Op : uint8_t{
+            CREATE,
+            DESTROY,
+            APPEND,
+            REMOVE
+        };
+        struct Command{
+            EntityID id;
+            Op op;
+            // archetype of CREATE, component of APPEND / REMOVE
+            ArchetypeBit bit;
+            // offset of the chunk / component bytes in Stream::bytes
+            size_t payload;
+        };
+        struct Stream{
+            std::thread::id owner;
+            std::vector<Command> commands;
+            std::vector<std::byte> bytes;
+        };
+
+        std::vector<std::unique_ptr<Stream>> streams;
+        std::mutex streamsMutex;
+        // playback work lists, kept so steady-state playback doesn't allocate
+        struct Scratch;
+        std::unique_ptr<Scratch> scratch;
+        // tells the thread_local stream cache apart from a previous buffer
+        // at the same address
+        const uint64_t serial;
+
+    public:
+        EntityCommandBuffer();
+        ~EntityCommandBuffer();
+        EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+        EntityCommandBuffer(EntityCommandBuffer&&) = delete;
+        auto operator=(const EntityCommandBuffer&)->EntityCommandBuffer& = delete;
+        auto operator=(EntityCommandBuffer&&)->EntityCommandBuffer& = delete;
+
+        // the id is issued at playback
+        template<all_value... Ts>
+        void createEntity(Ts&&... components){
+            constexpr auto bit = bits_of<std::remove_cvref_t<Ts>...>();
+
+            auto& stream = local();
+            auto payload = stream.bytes.size();
+            stream.bytes.resize(payload + size_of(bit));
+            auto chunk = stream.bytes.data() + payload;
+            (std::memcpy(chunk + offset_of<std::remove_cvref_t<Ts>>(bit), &components, sizeof(components)), ...);
+
+            stream.commands.push_back({NULL_ENTITY, Op::CREATE, bit, payload});
+        }
+        void destroyEntity(EntityID id){
+            local().commands.push_back({id, Op::DESTROY, 0, 0});
+        }
+        template<value_type T>
+        void appendComponent(EntityID id, T&& component){
+            using U = std::remove_cvref_t<T>;
+            U copy = std::forward<T>(component);
+            copy.entity = id;
+
+            auto& stream = local();
+            auto payload = stream.bytes.size();
+            stream.bytes.resize(payload + sizeof(U));
+            std::memcpy(stream.bytes.data() + payload, &copy, sizeof(U));
+
+            stream.commands.push_back({id, Op::APPEND, bit_of<U>(), payload});
+        }
+        template<typename T>
+        void removeComponent(EntityID id){
+            local().commands.push_back({id, Op::REMOVE, bit_of<T>(), 0});
+        }
+
+        // applies every recorded command, then clears
+        void playback(EntityRegistry&);
+        void clear();
+
+        size_t size() const;
+        bool empty() const{ return size() == 0; }
+
+    private:
+        Stream& local();
+    };
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <limits>
+#include <stdexcept>
+#include "chunk_storage.hpp"
+#include "core_types.hpp"
+#include "ECS/Entity.hpp"
+
+namespace RenderToy
+{
+    class Archetype;
+
+    struct EntityInfo{
+        Archetype* archetype;
+        Index chunkIndex;
+    };
+
+    // EntityID -> EntityInfo, indexed by the id's slot index: no hashing.
+    // - slots live in pages and never move, so EntityInfo& stays valid
+    //   while other entities are created or destroyed
+    // - destroy bumps the slot generation, stale ids miss afterwards
+    // - freed slots are recycled oldest first
+    // - a slot whose generation reaches maxGeneration is retired instead
+    //   of wrapping, so no id is ever issued twice
+    class EntityIndex{
+    public:
+        static constexpr uint32_t MAX_GENERATION = std::numeric_limits<uint32_t>::max();
+
+    private:
+        static constexpr Index NONE = std::numeric_limits<Index>::max();
+
+        struct Slot{
+            // chunkIndex links the free list while the slot is dead
+            EntityInfo info{};
+            uint32_t generation = 1;
+            bool alive = false;
+        };
+
+        stable_vector<Slot, paged_storage<>> slots;
+        uint32_t maxGeneration;
+        Index freeHead = NONE;
+        Index freeTail = NONE;
+        size_t liveCount = 0;
+
+    public:
+        // a lower maxGeneration retires slots sooner; tests use it to
+        // reach retirement without 2^32 reuses
+        explicit EntityIndex(uint32_t maxGeneration = MAX_GENERATION)
+        :maxGeneration(maxGeneration){}
+        ~EntityIndex() = default;
+        EntityIndex(const EntityIndex&) = delete;
+        EntityIndex& operator=(const EntityIndex&) = delete;
+
+        EntityID create(EntityInfo info){
+            Index index;
+            if(freeHead != NONE){
+                index = freeHead;
+                freeHead = slots[index].info.chunkIndex;
+                if(freeHead == NONE)
+                    freeTail = NONE;
+            }
+            else{
+                index = slots.size();
+                if(index >= MAX_ENTITY_COUNT)
+                    throw std::runtime_error("EntityIndex: entity count limit reached");
+                slots.resize(index + 1);
+            }
+
+            auto& slot = slots[index];
+            slot.info = info;
+            slot.alive = true;
+            ++liveCount;
+            return make_entity(index, slot.generation);
+        }
+
+        void destroy(EntityID id){
+            auto slot = live_slot(id);
+            if(slot == nullptr)
+                return;
+
+            slot->alive = false;
+            slot->info.chunkIndex = NONE;
+            --liveCount;
+            // retired: never recycled, so its last id stays stale for good
+            if(slot->generation >= maxGeneration)
+                return;
+            ++slot->generation;
+
+            auto index = entity_index(id);
+            if(freeTail != NONE)
+                slots[freeTail].info.chunkIndex = index;
+            else
+                freeHead = index;
+            freeTail = index;
+        }
+
+        // nullptr if id was never issued or is stale
+        EntityInfo* find(EntityID id){
+            auto slot = live_slot(id);
+            return slot ? &slot->info : nullptr;
+        }
+        const EntityInfo* find(EntityID id) const{
+            return const_cast<EntityIndex*>(this)->find(id);
+        }
+        EntityInfo& at(EntityID id){
+            auto info = find(id);
+            if(info == nullptr)
+                throw std::out_of_range("EntityIndex: entity not alive");
+            return *info;
+        }
+        const EntityInfo& at(EntityID id) const{
+            return const_cast<EntityIndex*>(this)->at(id);
+        }
+        bool contains(EntityID id) const{ return find(id) != nullptr; }
+
+        size_t size() const{ return liveCount; }
+        bool empty() const{ return liveCount == 0; }
+
+    private:
+        Slot* live_slot(EntityID id){
+            auto index = entity_index(id);
+            if(index >= slots.size())
+                return nullptr;
+            auto& slot = slots[index];
+            if(!slot.alive || slot.generation != entity_generation(id))
+                return nullptr;
+            return &slot;
+        }
+    };
+}
@@ -1,155 +1,29 @@
 #pragma once
 
-#include <unordered_map>
-#include "dynamic_vector.hpp"
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "ECS/ArchetypeGraph.hpp"
 #include "ECS/Entity.hpp"
+#include "ECS/EntityIndex.hpp"
 #include "ECS/Component.hpp"
+#include "ECS/Query.hpp"
 #include "Log/Log.hpp"
 
 namespace RenderToy
 {
-    template<typename... Ts>
-    struct ArchetypeView{
-        using Map = std::unordered_map<ArchetypeBit, dynamic_vector>;
+    namespace detail
+    {
+        inline std::atomic<size_t> next_query_slot = 0;
 
-    private:
-        Map&         map;
-        static constexpr ArchetypeBit required_bit = bits_of<Ts...>();
-
-    public:
-        struct sentinel{};
-        struct iterator{
-        private:
-            Map::iterator map_it;
-            Map::iterator map_end;
-            Index         vec_index = 0;
-            static constexpr ArchetypeBit required_bit = ArchetypeView::required_bit;
-
-        public:
-            iterator(Map::iterator map_it, Map::iterator map_end)
-            :map_it(map_it), map_end(map_end){
-                advance_to_valid_archetype();
-            }
-
-            auto operator*(){
-                assert(!at_end());
-                auto bit = map_it->first;
-                auto& vec = map_it->second;
-                assert(vec_index < vec.size());
-                auto chunk_ptr = vec[vec_index];
-
-                return std::forward_as_tuple(
-                    *static_cast<EntityID*>(chunk_ptr),
-                    map_it->first,
-                    *static_cast<Ts*>(
-                        ptrAdd(chunk_ptr, offset_of<Ts>(bit))
-                    )...
-                );
-            }
-            auto operator++()->iterator&{
-                auto& vec = map_it->second;
-                ++vec_index;
-                if(vec_index >= vec.size()){
-                    vec_index = 0;
-                    ++map_it;
-                    advance_to_valid_archetype();
-                }
-                return *this;
-            }
-            auto operator==(sentinel) noexcept{
-                return map_it == map_end;
-            }
-            auto operator!=(sentinel) noexcept{
-                return !((*this)==sentinel{});
-            }
-
-        private:
-            void advance_to_valid_archetype(){
-                while(map_it != map_end){
-                    if( isSubset(required_bit, map_it->first) &&
-                        map_it->second.size() > 0)
-                        return;
-                    ++map_it;
-                }
-            }
-            auto at_end() const noexcept{ return map_it == map_end; }
-        };
-        struct const_iterator{
-        private:
-            Map::const_iterator map_it;
-            Map::const_iterator map_end;
-            Index               vec_index = 0;
-            static constexpr ArchetypeBit required_bit = ArchetypeView::required_bit;
-
-        public:
-            const_iterator(Map::const_iterator map_it, Map::const_iterator map_end)
-            :map_it(map_it), map_end(map_end){
-                advance_to_valid_archetype();
-            }
-
-            auto operator*(){
-                assert(!at_end());
-                auto bit = map_it->first;
-                auto& vec = map_it->second;
-                assert(vec_index < vec.size());
-                auto chunk_ptr = vec[vec_index];
-
-                return std::forward_as_tuple(
-                    *static_cast<const EntityID*>(chunk_ptr),
-                    map_it->first,
-                    *static_cast<Ts*>(
-                        ptrAdd(chunk_ptr, offset_of<Ts>(bit))
-                    )...
-                );
-            }
-            auto operator++()->const_iterator&{
-                auto& vec = map_it->second;
-                ++vec_index;
-                if(vec_index >= vec.size()){
-                    vec_index = 0;
-                    ++map_it;
-                    advance_to_valid_archetype();
-                }
-                return *this;
-            }
-            auto operator==(sentinel) noexcept{
-                return map_it == map_end;
-            }
-            auto operator!=(sentinel) noexcept{
-                return !((*this)==sentinel{});
-            }
-
-        private:
-            void advance_to_valid_archetype(){
-                while(map_it != map_end){
-                    if(isSubset(required_bit, map_it->first) &&
-                        map_it->second.size() > 0)
-                        return;
-                    ++map_it;
-                }
-            }
-            auto at_end() const noexcept{ return map_it == map_end; }
-        };
-
-        ArchetypeView(Map& map):map(map){}
-
-        auto  begin() noexcept{ return iterator{map.begin(), map.end()}; }
-        auto    end() noexcept{ return sentinel{}; }
-        auto  begin() const noexcept{ return const_iterator{map.begin(), map.end()}; }
-        auto    end() const noexcept{ return sentinel{}; }
-        auto cbegin() const noexcept{ return const_iterator{map.begin(), map.end()}; }
-        auto   cend() const noexcept{ return sentinel{}; }
-
-        size_t size() const noexcept{
-            size_t size = 0;
-            for(auto it = map.cbegin(); it != map.cend(); ++it){
-                if(isSubset(required_bit, it->first))
-                    size += it->second.size();
-            }
-
-            return size;
+        // dense id per type list, indexes EntityRegistry's query cache
+        template<typename... Ts>
+        size_t query_slot(){
+            static const size_t slot = next_query_slot.fetch_add(1, std::memory_order_relaxed);
+            return slot;
         }
-    };
+    }
 
     template<value_type T>
     void emplace_component(EntityID id, void* chunk, ArchetypeBit bit, T&& t){
@@ -222,25 +96,19 @@ namespace RenderToy
         emplace_component(id, chunk, bit, tn...);
     }
 
-    struct EntityInfo{
-        ArchetypeBit bit;
-        Index chunkIndex;
-    };
-
     struct Entity{
         ArchetypeBit bit = 0;
         void* chunk = nullptr;
     };
 
     class EntityRegistry{
-    private:
-        using ArchetypeMap = std::unordered_map<ArchetypeBit, dynamic_vector>;
-        using EntityTable = std::unordered_map<EntityID, EntityInfo>;
-
-        ArchetypeMap archetypeMap;
-        EntityTable entityTable;
+        friend class EntityCommandBuffer;
 
-        EntityID id_seed = 1;
+    private:
+        ArchetypeGraph archetypes;
+        EntityIndex entityIndex;
+        // Query<Ts...> by detail::query_slot<Ts...>(), for query<Ts...>()
+        std::vector<std::shared_ptr<void>> queries;
 
     public:
         EntityRegistry() = default;
@@ -250,26 +118,17 @@ namespace RenderToy
         auto operator=(const EntityRegistry&)->EntityRegistry& = delete;
         auto operator=(EntityRegistry&&)->EntityRegistry& = delete;
 
-    private:
-        auto issueID(){ return id_seed++; }
-
-    public:
         template<typename... Args>
         auto createEntity(Args&&... args){
             auto bit = bits_of(args...);
             // auto bit = bits_of<remove_optional_t<std::remove_cvref_t<Args>>...>();
 
-            if(archetypeMap.find(bit) == archetypeMap.end())
-                archetypeMap.emplace(bit, size_of(bit));
+            auto& archetype = archetypes.get(bit);
+            auto index = archetype.allocate(archetypes.changeTick());
+            auto chunk = archetype.chunk(index);
 
-            auto& vector = archetypeMap.at(bit);
-            vector.resize(vector.size() + 1);
-            auto index = vector.size() - 1;
-            auto chunk = vector[index];
-
-            auto entity_id = issueID();
-            entityTable.emplace(entity_id, EntityInfo{
-                .bit = bit, .chunkIndex = index
+            auto entity_id = entityIndex.create(EntityInfo{
+                .archetype = &archetype, .chunkIndex = index
             });
             *static_cast<EntityID*>(chunk) = entity_id;
             emplace_component(entity_id, chunk, bit, std::forward<Args>(args)...);
@@ -278,139 +137,115 @@ namespace RenderToy
         }
         void destroyEntity(EntityID);
 
+        // view of a cached Query<Ts...>; the match list lives as long as
+        // the registry. not thread-safe: hold a makeQuery() for jobs.
+        // Shared by every caller, so it can't filter: Changed<T> / Added<T>
+        // need a makeQuery() that remembers its last view
         template<typename... Ts>
         auto query(){
-            return ArchetypeView<Ts...>(archetypeMap);
+            static_assert((Query<Ts...>::changed_bit | Query<Ts...>::added_bit) == 0,
+                "filters need a persistent Query: use makeQuery()");
+            return cachedQuery<Ts...>().view();
+        }
+        template<typename... Ts>
+        auto makeQuery(){
+            return Query<Ts...>(archetypes);
         }
+        // non-const Ts are marked changed
         template<typename... Ts>
         auto query(EntityID id)->std::tuple<Ts&...>{
-            const auto& info = entityTable.at(id);
-            auto& vec = archetypeMap.at(info.bit);
-            auto chunk = vec[info.chunkIndex];
+            const auto& info = entityIndex.at(id);
+            auto chunk = info.archetype->chunk(info.chunkIndex);
+            constexpr auto written = (ArchetypeBit(0) | ... | (std::is_const_v<Ts> ? 0 : bit_of<Ts>()));
+            if constexpr(written != 0)
+                info.archetype->markChanged(written, info.chunkIndex, archetypes.changeTick());
 
             return std::forward_as_tuple(
                 *static_cast<Ts*>(
-                    ptrAdd(chunk, offset_of<Ts>(info.bit))
+                    ptrAdd(chunk, info.archetype->template offset<Ts>())
                 )...
             );
         }
         template<typename T>
         auto query_safe(EntityID id)->std::pair<T&, bool>{
-            const auto& info = entityTable.at(id);
-            auto& vec = archetypeMap.at(info.bit);
-            auto chunk = vec[info.chunkIndex];
+            const auto& info = entityIndex.at(id);
+            auto chunk = info.archetype->chunk(info.chunkIndex);
 
-            auto offset = offset_of<T>(info.bit);
+            auto offset = info.archetype->template offset<T>();
+            if constexpr(!std::is_const_v<T>)
+                if(offset != Archetype::NONE)
+                    info.archetype->markChanged(bit_of<T>(), info.chunkIndex, archetypes.changeTick());
             return {
                 *static_cast<T*>(ptrAdd(chunk, offset)),
-                offset != std::numeric_limits<size_t>::max()
+                offset != Archetype::NONE
             };
         }
         auto query(EntityID id)->Entity;
 
         template<typename T>
         void appendComponent(EntityID id, T&& component){
-            auto entity_it = entityTable.find(id);
-            if(entity_it == entityTable.end()){
+            using U = std::remove_cvref_t<T>;
+
+            auto info_ptr = entityIndex.find(id);
+            if(info_ptr == nullptr){
                 LOG_WARN(LOG_CORE, "Entity {} not exist. component cannot be added", id);
                 return;
             }
 
-            auto& info = entity_it->second;
+            auto& info = *info_ptr;
+            auto& archetype = *info.archetype;
 
-            if(isSubset(bit_of<T>(), info.bit)){
+            if(archetype.has<U>()){
                 LOG_WARN(LOG_CORE, "Component {} already exist. (entity: {}, archetype: {})",
-                    bit_of<T>(), id, info.bit);
+                    bit_of<U>(), id, archetype.bit());
                 return;
             }
 
-            auto [new_index, old_vec] = moveChunk(info,
-                std::forward<T>(component));
-            updateEntityInfo(info, old_vec,
-                info.bit | bit_of<T>(), new_index
-            );
+            const auto& edge = archetypes.addEdge(archetype, bit_of<U>());
+            auto new_index = archetype.moveTo(edge, info.chunkIndex, archetypes.changeTick());
+            auto dst = static_cast<U*>(ptrAdd(edge.target->chunk(new_index), edge.componentOffset));
+            *dst = std::forward<T>(component);
+            dst->entity = id;
+
+            relocate(info, *edge.target, new_index);
         }
         template<typename T>
         void removeComponent(EntityID id){
-            auto entity_it = entityTable.find(id);
-            if(entity_it == entityTable.end()){
+            auto info_ptr = entityIndex.find(id);
+            if(info_ptr == nullptr){
                 LOG_WARN(LOG_CORE, "Entity {} not exist. component cannot be added", id);
                 return;
             }
 
-            auto& info = entity_it->second;
+            auto& info = *info_ptr;
+            auto& archetype = *info.archetype;
 
-            if(!isSubset(bit_of<T>(), info.bit)){
+            if(!archetype.has<T>()){
                 LOG_WARN(LOG_CORE, "{} not exist. (entity: {}, archetype: {})",
-                    name_of<T>(), id, info.bit);
+                    name_of<T>(), id, archetype.bit());
                 return;
             }
 
-            auto [new_index, old_vec] = moveChunk<T>(info);
-            updateEntityInfo(info, old_vec,
-                info.bit & (~bit_of<T>()), new_index);
+            const auto& edge = archetypes.removeEdge(archetype, bit_of<T>());
+            auto new_index = archetype.moveTo(edge, info.chunkIndex, archetypes.changeTick());
+
+            relocate(info, *edge.target, new_index);
         }
 
     private:
-        auto getVector(ArchetypeBit)->dynamic_vector&;
-
-        template<typename T>
-        auto moveChunk(EntityInfo& info, T&& component){
-            auto& old_vec = archetypeMap.at(info.bit);
-            auto old_index = info.chunkIndex;
-            auto chunk = old_vec[old_index];
-
-            auto new_bit = info.bit | bit_of<T>();
-            auto& new_vec = getVector(new_bit);
-
-            new_vec.resize(new_vec.size() + 1);
-            auto new_index = new_vec.size() - 1;
-            auto dst = new_vec[new_index];
-
-            // 1. copy new chunk
-            // copy chunk before component
-            dst = ptrWrite(dst, chunk, offset_of<T>(new_bit));
-            chunk = ptrAdd(     chunk, offset_of<T>(new_bit));
-            // copy component
-            dst = ptrWrite(dst, std::forward<T>(component));
-            // copy chunk after component
-            ptrWrite(dst, chunk, size_of(info.bit) - offset_of<T>(new_bit));
-
-            // 2. remove old chunk
-            old_vec.swap_remove(info.chunkIndex);
-
-            return std::tuple<size_t, dynamic_vector&>{new_index, old_vec};
-        }
-        template<typename T>
-        auto moveChunk(EntityInfo& info){
-            auto& old_vec = archetypeMap.at(info.bit);
-            auto old_index = info.chunkIndex;
-            auto chunk = old_vec[old_index];
-
-            auto new_bit = info.bit & (~bit_of<T>());
-            auto& new_vec = getVector(new_bit);
-
-            new_vec.resize(new_vec.size() + 1);
-            auto new_index = new_vec.size() - 1;
-            auto dst = new_vec[new_index];
-
-            // 1. copy new chunk
-            // copy chunk before component
-            dst = ptrWrite(dst, chunk, offset_of<T>(info.bit));
-            // skip target component
-            chunk = ptrAdd(chunk, offset_of<T>(info.bit) + sizeof(T));
-            // copy chunk after component
-            ptrWrite(dst, chunk, size_of(info.bit) - offset_of<T>(info.bit) - sizeof(T));
-
-            // 2. remove old chunk
-            old_vec.swap_remove(info.chunkIndex);
-
-            return std::tuple<Index, dynamic_vector&>{new_index, old_vec};
+        template<typename... Ts>
+        auto cachedQuery()->Query<Ts...>&{
+            auto slot = detail::query_slot<Ts...>();
+            if(slot >= queries.size())
+                queries.resize(slot + 1);
+            if(queries[slot] == nullptr)
+                queries[slot] = std::make_shared<Query<Ts...>>(archetypes);
+            return *static_cast<Query<Ts...>*>(queries[slot].get());
         }
 
-        void updateEntityInfo(EntityInfo& updated, dynamic_vector& swapped,
-            ArchetypeBit updated_bit, Index updated_index);
-
-        auto findEntityFromProperty(ArchetypeBit bit, Index chunkIndex)->EntityTable::iterator;
+        // frees the entity's old chunk and points it at its copy in `target`
+        void relocate(EntityInfo& info, Archetype& target, Index index);
+        // after vec.swap_remove(hole): repoint the entity moved into the hole
+        void relinkSwapped(Archetype::ChunkVector& vec, Index hole);
     };
-}
\ No newline at end of file
+}
@@ -3,11 +3,51 @@
 #include <typeindex>
 #include <vector>
 #include "Time.hpp"
+#include "ECS/Component.hpp"
 
 namespace RenderToy
 {
     class World;
 
+    // Components a system touches in onUpdate. Two systems conflict when
+    // one writes what the other reads or writes; systems that don't
+    // conflict may run at the same time.
+    struct ComponentAccess{
+        ArchetypeBit readBit = 0;
+        ArchetypeBit writeBit = 0;
+        // conflicts with everything, e.g. structural changes or unknown access
+        bool exclusive = false;
+        // state bound to the main thread, e.g. window or UI: World runs the
+        // system there, alongside the rest of its wave
+        bool mainThread = false;
+
+        static ComponentAccess all(){ return {.exclusive = true}; }
+
+        template<typename... Ts>
+        ComponentAccess reads() const{
+            auto access = *this;
+            access.readBit |= bits_of<Ts...>();
+            return access;
+        }
+        template<typename... Ts>
+        ComponentAccess writes() const{
+            auto access = *this;
+            access.writeBit |= bits_of<Ts...>();
+            return access;
+        }
+        ComponentAccess onMainThread() const{
+            auto access = *this;
+            access.mainThread = true;
+            return access;
+        }
+
+        bool conflictsWith(const ComponentAccess& other) const{
+            return exclusive || other.exclusive
+                || (writeBit & (other.readBit | other.writeBit)) != 0
+                || (other.writeBit & (readBit | writeBit)) != 0;
+        }
+    };
+
     class ISystem{
     public:
         using SystemChain = std::vector<std::type_index>;
@@ -27,7 +67,20 @@ namespace RenderToy
         virtual SystemChain execAfter() const{ return {}; }
         virtual SystemChain execBefore() const{ return {}; }
 
+        // e.g. `return reads<Transform>().writes<Rigidbody>();`
+        // Undeclared systems are exclusive and run alone. Structural
+        // changes (create, destroy, add or remove components) need
+        // exclusive access or an EntityCommandBuffer, and systems that
+        // share a wave iterate Query objects made in onInit rather than
+        // EntityRegistry::query<Ts...>(), whose cache isn't thread-safe.
+        virtual ComponentAccess getAccess() const{ return ComponentAccess::all(); }
+
     protected:
+        template<typename... Ts>
+        static ComponentAccess reads(){ return ComponentAccess{}.reads<Ts...>(); }
+        template<typename... Ts>
+        static ComponentAccess writes(){ return ComponentAccess{}.writes<Ts...>(); }
+
         bool enabled = true;
     };
 
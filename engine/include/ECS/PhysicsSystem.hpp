@@ -13,5 +13,6 @@ namespace RenderToy
         void onUpdate(DeltaTime) override;
 
         SystemChain execBefore() const override;
+        ComponentAccess getAccess() const override;
     };
 }
\ No newline at end of file
@@ -0,0 +1,586 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "job_system.hpp"
+#include "ptr_util.hpp"
+#include "strided_span.hpp"
+#include "ECS/ArchetypeGraph.hpp"
+#include "ECS/Entity.hpp"
+#include "ECS/Component.hpp"
+
+namespace RenderToy
+{
+    // Query filters: only rows whose T was written (Changed) or added
+    // (Added) since the query's previous view. They fetch nothing, e.g.
+    // Query<const Transform, Changed<Transform>>, and combine with AND:
+    // Query<Transform, Changed<Rigidbody>, Added<Color>>.
+    template<typename T>
+    struct Changed{};
+    template<typename T>
+    struct Added{};
+
+    // what a view reports, and which tick its writes carry
+    struct ChangeTicks{
+        // filters pass ticks newer than this
+        uint32_t since = 0;
+        // stamped on the non-const components the view hands out
+        uint32_t now = 0;
+        // components of the Changed<T> / Added<T> filters
+        ArchetypeBit changed = 0;
+        ArchetypeBit added = 0;
+    };
+
+    namespace detail
+    {
+        template<typename T>
+        struct filter_of{
+            static constexpr ArchetypeBit changed = 0;
+            static constexpr ArchetypeBit added = 0;
+        };
+        template<typename T>
+        struct filter_of<Changed<T>>{
+            static constexpr ArchetypeBit changed = bit_of<T>();
+            static constexpr ArchetypeBit added = 0;
+        };
+        template<typename T>
+        struct filter_of<Added<T>>{
+            static constexpr ArchetypeBit changed = 0;
+            static constexpr ArchetypeBit added = bit_of<T>();
+        };
+        template<typename T>
+        constexpr bool is_filter = (filter_of<T>::changed | filter_of<T>::added) != 0;
+
+        // std::tuple<Kept..., Ts...> with the filters taken out of Ts
+        template<typename Kept, typename... Ts>
+        struct without_filters;
+        template<typename... Kept>
+        struct without_filters<std::tuple<Kept...>>{
+            using type = std::tuple<Kept...>;
+        };
+        template<typename... Kept, typename T, typename... Ts>
+        struct without_filters<std::tuple<Kept...>, T, Ts...>
+        :std::conditional_t<is_filter<T>,
+            without_filters<std::tuple<Kept...>, Ts...>,
+            without_filters<std::tuple<Kept..., T>, Ts...>>{};
+    }
+
+    template<bool Filtered, typename... Ts>
+    struct BasicArchetypeView;
+
+    namespace detail
+    {
+        template<bool Filtered, typename Fetched>
+        struct view_of;
+        template<bool Filtered, typename... Ts>
+        struct view_of<Filtered, std::tuple<Ts...>>{
+            using type = BasicArchetypeView<Filtered, Ts...>;
+        };
+    }
+
+    // the view of Query<Ts...>: Ts minus the filters, which are known at
+    // compile time, so unfiltered views pay nothing for them
+    template<typename... Ts>
+    using ArchetypeView = typename detail::view_of<
+        (detail::is_filter<Ts> || ...),
+        typename detail::without_filters<std::tuple<>, Ts...>::type
+    >::type;
+
+    // one archetype matching a query, with the offsets of the queried
+    // components in its chunk, in query order
+    template<size_t N>
+    struct QueryMatch{
+        Archetype* archetype;
+        std::array<uint32_t, N> offsets;
+    };
+
+    // The rows of one archetype matching a query: its entities and one
+    // strided column per queried component, in query order.
+    template<typename... Ts>
+    struct ArchetypeChunk{
+        ArchetypeBit bit = 0;
+        strided_span<const EntityID> entities;
+        std::tuple<strided_span<Ts>...> columns;
+
+        size_t size() const{ return entities.size(); }
+        template<typename T>
+        auto column() const{
+            if constexpr((std::is_same_v<T, Ts> || ...))
+                return std::get<strided_span<T>>(columns);
+            else
+                return std::get<strided_span<const T>>(columns);
+        }
+    };
+
+    // Iterates the chunks of a match list. Yields
+    // (EntityID&, ArchetypeBit, Ts&...) per entity; empty archetypes are skipped.
+    // chunks() / forEachChunk() yield whole archetypes instead, for tight
+    // loops over strided columns.
+    // Components handed out mutably (non-const Ts, non-const view) are
+    // marked changed, whether or not the caller writes them: take const Ts
+    // to only read. Entity iteration marks a block of Archetype::TICK_BLOCK
+    // rows as it enters it, the chunk functions the ranges they hand out.
+    // Filters all have to pass; entity iteration then skips unchanged rows,
+    // chunk iteration blocks none of whose rows passes.
+    // Invalidated by structural changes, like the registry's own iterators.
+    template<bool Filtered, typename... Ts>
+    struct BasicArchetypeView{
+        using Match = QueryMatch<sizeof...(Ts)>;
+        // rows per parallel range: enough to amortize a job, few enough
+        // to spread a few hundred thousand rows over 16 workers
+        static constexpr size_t PARALLEL_GRAIN = 4096;
+        // the components written through mutable access
+        static constexpr ArchetypeBit write_bit = (ArchetypeBit(0) | ... | (std::is_const_v<Ts> ? 0 : bit_of<Ts>()));
+
+    private:
+        std::span<const Match> matches;
+        ChangeTicks ticks;
+
+        // one archetype's filters, and the tick columns its written
+        // components are stamped in, looked up once per archetype. The
+        // first filter is checked inline, any others through the archetype
+        struct RowTicks{
+            Archetype* archetype = nullptr;
+            Archetype::TickColumn first{};
+            ArchetypeBit restChanged = 0;
+            ArchetypeBit restAdded = 0;
+            std::array<Archetype::TickColumn, std::popcount(write_bit)> writes{};
+            uint32_t since = 0;
+            uint32_t now = 0;
+
+            RowTicks() = default;
+            RowTicks(Archetype& archetype, const ChangeTicks& ticks)
+            :archetype(&archetype), restChanged(ticks.changed), restAdded(ticks.added),
+            since(ticks.since), now(ticks.now){
+                if(restChanged != 0){
+                    first = archetype.changedColumn(restChanged & (~restChanged + 1));
+                    restChanged &= restChanged - 1;
+                }
+                else if(restAdded != 0){
+                    first = archetype.addedColumn(restAdded & (~restAdded + 1));
+                    restAdded &= restAdded - 1;
+                }
+                auto rest = write_bit;
+                for(auto& column: writes){
+                    column = archetype.changedColumn(rest & (~rest + 1));
+                    rest &= rest - 1;
+                }
+            }
+
+            // only meaningful with filters
+            bool passes(Index row) const{
+                return first.newer(row, since)
+                    && ((restChanged | restAdded) == 0 || archetype->changedSince(restChanged, restAdded, row, since));
+            }
+            bool blockPasses(Index block) const{
+                return first.blockNewer(block, since)
+                    && ((restChanged | restAdded) == 0 || archetype->blockChangedSince(restChanged, restAdded, block, since));
+            }
+            // rows [begin, end), blocks and all
+            void mark(Index begin, Index end) const{
+                for(const auto& column: writes)
+                    column.mark(begin, end, now);
+            }
+            void markRow(Index row) const{
+                for(const auto& column: writes)
+                    column.markRow(row, now);
+            }
+            // the blocks holding rows [begin, end)
+            void markBlocks(Index begin, Index end) const{
+                if(begin == end)
+                    return;
+                for(const auto& column: writes)
+                    for(auto block = begin >> Archetype::TICK_BLOCK_SHIFT; block <= (end - 1) >> Archetype::TICK_BLOCK_SHIFT; ++block)
+                        column.markBlock(block, now);
+            }
+        };
+
+        // rows [begin, end) of matches[match]
+        struct Run{
+            Index match;
+            Index begin;
+            Index end;
+        };
+
+    public:
+        struct sentinel{};
+        template<bool IsConst>
+        struct basic_iterator{
+        private:
+            template<typename T>
+            using ref = std::conditional_t<IsConst, const T&, T&>;
+            using chunk_ptr = std::conditional_t<IsConst, const void*, void*>;
+            static constexpr bool marks = !IsConst && write_bit != 0;
+            static constexpr bool ticked = marks || Filtered;
+            struct NoTicks{};
+
+            const Match* match;
+            const Match* match_end;
+            // only kept by iterators that filter or mark
+            [[no_unique_address]]
+            std::conditional_t<ticked, ChangeTicks, NoTicks> ticks;
+            [[no_unique_address]]
+            std::conditional_t<ticked, RowTicks, NoTicks> current;
+            // row 0 of the current archetype; rows are chunkSize() apart
+            chunk_ptr    base = nullptr;
+            size_t       stride = 0;
+            Index        row = 0;
+            size_t       rows = 0;
+            // operator++ just steps `row` below this; from there on,
+            // advance() applies the filters, stamps and moves on
+            Index        fast_end = 0;
+            // rows of the current archetype whose blocks are stamped
+            Index        stamped = 0;
+
+        public:
+            basic_iterator(const Match* match, const Match* match_end, ChangeTicks ticks)
+            :match(match), match_end(match_end){
+                if constexpr(ticked)
+                    this->ticks = ticks;
+                enter_archetype();
+                advance();
+            }
+
+            auto operator*() const{
+                assert(!at_end());
+                assert(row < rows);
+                if constexpr(marks && Filtered)
+                    current.markRow(row);
+                return deref(ptrAdd(base, row*stride), std::index_sequence_for<Ts...>{});
+            }
+            auto operator++()->basic_iterator&{
+                if(++row >= fast_end)
+                    advance();
+                return *this;
+            }
+            auto operator==(sentinel) const noexcept{
+                return at_end();
+            }
+            auto operator!=(sentinel) const noexcept{
+                return !at_end();
+            }
+
+        private:
+            template<size_t... I>
+            auto deref(chunk_ptr chunk, std::index_sequence<I...>) const{
+                return std::tuple<ref<EntityID>, ArchetypeBit, ref<Ts>...>(
+                    *static_cast<std::remove_reference_t<ref<EntityID>>*>(chunk),
+                    match->archetype->bit(),
+                    *static_cast<std::remove_reference_t<ref<Ts>>*>(
+                        ptrAdd(chunk, match->offsets[I])
+                    )...
+                );
+            }
+            void enter_archetype(){
+                row = 0;
+                fast_end = 0;
+                stamped = 0;
+                if(at_end())
+                    return;
+                rows = match->archetype->size();
+                if(rows == 0)
+                    return;
+                base = match->archetype->chunk(0);
+                stride = match->archetype->chunkSize();
+                if constexpr(ticked)
+                    current = RowTicks(*match->archetype, ticks);
+            }
+            // from `row` on, to the next row to hand out, moving on to
+            // later archetypes as needed
+            void advance(){
+                while(!at_end()){
+                    if constexpr(Filtered)
+                        skip_unchanged();
+                    if(row < rows){
+                        enter_row();
+                        return;
+                    }
+                    ++match;
+                    enter_archetype();
+                }
+            }
+            // Without filters every row is handed out, so a block's rows
+            // are stamped together as the iterator enters it. With them,
+            // only the block is, and operator* marks the rows
+            void enter_row(){
+                auto block_end = std::min<Index>(rows, ((row >> Archetype::TICK_BLOCK_SHIFT) + 1) << Archetype::TICK_BLOCK_SHIFT);
+                if constexpr(Filtered){
+                    if constexpr(marks)
+                        if(row >= stamped){
+                            current.markBlocks(row, block_end);
+                            stamped = block_end;
+                        }
+                    fast_end = row + 1;
+                }
+                else if constexpr(marks){
+                    current.mark(row, block_end);
+                    fast_end = block_end;
+                }
+                else
+                    fast_end = rows;
+            }
+            void skip_unchanged(){
+                while(row < rows){
+                    auto block = row >> Archetype::TICK_BLOCK_SHIFT;
+                    auto block_end = std::min<Index>(rows, (block + 1) << Archetype::TICK_BLOCK_SHIFT);
+                    if(!current.blockPasses(block)){
+                        row = block_end;
+                        continue;
+                    }
+                    for(; row < block_end; ++row)
+                        if(current.passes(row))
+                            return;
+                }
+            }
+            auto at_end() const noexcept{ return match == match_end; }
+        };
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        BasicArchetypeView(std::span<const Match> matches, ChangeTicks ticks)
+        :matches(matches), ticks(ticks){}
+
+        static Match match(Archetype* archetype){
+            return {archetype, {archetype->template offset<Ts>()...}};
+        }
+
+        auto  begin() noexcept{ return iterator{first(), last(), ticks}; }
+        auto    end() noexcept{ return sentinel{}; }
+        auto  begin() const noexcept{ return const_iterator{first(), last(), ticks}; }
+        auto    end() const noexcept{ return sentinel{}; }
+        auto cbegin() const noexcept{ return const_iterator{first(), last(), ticks}; }
+        auto   cend() const noexcept{ return sentinel{}; }
+
+        // rows passing the filters
+        size_t size() const noexcept{
+            size_t size = 0;
+            forEachRun([&](const Run& run){
+                if constexpr(!Filtered){
+                    size += run.end - run.begin;
+                    return;
+                }
+                RowTicks rowTicks(*matches[run.match].archetype, ticks);
+                for(auto row = run.begin; row < run.end; ++row)
+                    size += rowTicks.passes(row);
+            });
+            return size;
+        }
+
+        // one ArchetypeChunk per non-empty matching archetype; with filters,
+        // per run of blocks that pass
+        auto chunks(){
+            std::vector<ArchetypeChunk<Ts...>> chunks;
+            forEachRun([&](const Run& run){ chunks.push_back(touch_chunk(run)); });
+            return chunks;
+        }
+        auto chunks() const{
+            std::vector<ArchetypeChunk<const Ts...>> chunks;
+            forEachRun([&](const Run& run){ chunks.push_back(chunk_of<const Ts...>(run)); });
+            return chunks;
+        }
+        // f(strided_span<const EntityID>, strided_span<Ts>...) per chunk
+        template<typename F>
+        void forEachChunk(F&& f){
+            forEachRun([&](const Run& run){ apply_chunk(f, touch_chunk(run)); });
+        }
+        template<typename F>
+        void forEachChunk(F&& f) const{
+            forEachRun([&](const Run& run){ apply_chunk(f, chunk_of<const Ts...>(run)); });
+        }
+
+        // forEachChunk over ranges of at most `grain` rows, run on `jobs`.
+        // Ranges are cut from each chunk's start, so they depend only on
+        // the data and grain, never on the thread count. f must only touch
+        // the rows it is given.
+        template<typename F>
+        void parallelForEachChunk(F&& f, size_t grain = PARALLEL_GRAIN, job_system& jobs = job_system::shared()){
+            parallelForEachRun([&](const Run& run){
+                apply_chunk(f, touch_chunk(run));
+            }, grain, jobs);
+        }
+        // f(EntityID, Ts&...) per entity passing the filters, over the same ranges
+        template<typename F>
+        void parallelForEach(F&& f, size_t grain = PARALLEL_GRAIN, job_system& jobs = job_system::shared()){
+            parallelForEachRun([&](const Run& run){
+                auto chunk = chunk_of<Ts...>(run);
+                RowTicks rowTicks(*matches[run.match].archetype, ticks);
+                if constexpr(!Filtered){
+                    rowTicks.mark(run.begin, run.end);
+                    std::apply([&](const auto&... columns){
+                        for(Index i=0; i<chunk.size(); ++i)
+                            f(chunk.entities[i], columns[i]...);
+                    }, chunk.columns);
+                    return;
+                }
+                rowTicks.markBlocks(run.begin, run.end);
+                std::apply([&](const auto&... columns){
+                    for(Index i=0; i<chunk.size(); ++i){
+                        auto row = run.begin + i;
+                        if(!rowTicks.passes(row))
+                            continue;
+                        rowTicks.markRow(row);
+                        f(chunk.entities[i], columns[i]...);
+                    }
+                }, chunk.columns);
+            }, grain, jobs);
+        }
+
+    private:
+        const Match* first() const noexcept{ return matches.data(); }
+        const Match* last() const noexcept{ return matches.data() + matches.size(); }
+
+        // f(Run) per non-empty archetype, or per run of passing blocks
+        template<typename F>
+        void forEachRun(F&& f) const{
+            for(Index m=0; m<matches.size(); ++m){
+                auto rows = matches[m].archetype->size();
+                if(rows == 0)
+                    continue;
+                if constexpr(!Filtered){
+                    f(Run{m, 0, rows});
+                    continue;
+                }
+
+                RowTicks rowTicks(*matches[m].archetype, ticks);
+                auto blocks = Archetype::blockCount(rows);
+                for(Index block=0; block<blocks;){
+                    if(!rowTicks.blockPasses(block)){
+                        ++block;
+                        continue;
+                    }
+                    auto begin = block;
+                    while(block < blocks && rowTicks.blockPasses(block))
+                        ++block;
+                    f(Run{m, begin << Archetype::TICK_BLOCK_SHIFT, std::min(rows, block << Archetype::TICK_BLOCK_SHIFT)});
+                }
+            }
+        }
+        // f(Run) per range of at most `grain` rows of forEachRun's runs
+        template<typename F>
+        void parallelForEachRun(F&& f, size_t grain, job_system& jobs){
+            grain = std::max<size_t>(grain, 1);
+            std::vector<Run> runs;
+            forEachRun([&](const Run& run){ runs.push_back(run); });
+            // firstRange[r]: index of the first range of runs[r]
+            std::vector<size_t> firstRange(runs.size() + 1, 0);
+            for(Index r=0; r<runs.size(); ++r)
+                firstRange[r + 1] = firstRange[r] + (runs[r].end - runs[r].begin + grain - 1) / grain;
+
+            jobs.parallel_for(firstRange.back(), 1, [&](Index begin, Index end){
+                for(auto range = begin; range < end; ++range){
+                    auto r = Index(std::ranges::upper_bound(firstRange, range) - firstRange.begin()) - 1;
+                    auto row = runs[r].begin + (range - firstRange[r]) * grain;
+                    f(Run{runs[r].match, row, std::min(row + grain, runs[r].end)});
+                }
+            });
+        }
+
+        template<typename F, typename Chunk>
+        static void apply_chunk(F& f, const Chunk& chunk){
+            std::apply([&](const auto&... columns){ f(chunk.entities, columns...); }, chunk.columns);
+        }
+        // the chunk of `run`, its written components marked changed
+        ArchetypeChunk<Ts...> touch_chunk(const Run& run){
+            if constexpr(write_bit != 0)
+                matches[run.match].archetype->markChanged(write_bit, run.begin, run.end, ticks.now);
+            return chunk_of<Ts...>(run);
+        }
+        template<typename... Us>
+        ArchetypeChunk<Us...> chunk_of(const Run& run) const{
+            return make_chunk<Us...>(matches[run.match], run, std::index_sequence_for<Us...>{});
+        }
+        template<typename... Us, size_t... I>
+        static ArchetypeChunk<Us...> make_chunk(const Match& match, const Run& run, std::index_sequence<I...>){
+            const auto& archetype = *match.archetype;
+            auto base = match.archetype->chunk(0);
+            auto rows = run.end - run.begin;
+            return {
+                .bit = archetype.bit(),
+                .entities = archetype.entities().subspan(run.begin, rows),
+                .columns = {strided_span<Us>(ptrAdd(base, match.offsets[I]), archetype.size(), archetype.chunkSize()).subspan(run.begin, rows)...}
+            };
+        }
+    };
+
+    // Persistent query: the archetypes holding every Ts, found once and
+    // kept. update() only looks at archetypes created since the last call,
+    // so steady-state iteration never touches non-matching archetypes.
+    // Ts are components, const for read-only access, and Changed<T> /
+    // Added<T> filters. Every view() reports the changes made since the
+    // previous one, except those made through that view itself.
+    template<typename... Ts>
+    class Query{
+    public:
+        using View = ArchetypeView<Ts...>;
+        using Match = typename View::Match;
+        static constexpr ArchetypeBit changed_bit = (ArchetypeBit(0) | ... | detail::filter_of<Ts>::changed);
+        static constexpr ArchetypeBit added_bit = (ArchetypeBit(0) | ... | detail::filter_of<Ts>::added);
+        static constexpr ArchetypeBit required_bit = bits_of<Ts...>() | changed_bit | added_bit;
+
+    private:
+        ArchetypeGraph* graph = nullptr;
+        // archetypes of graph->created() already tested
+        size_t seen = 0;
+        std::vector<Match> matches;
+        // the tick of the previous view()
+        uint32_t lastTick = 0;
+
+    public:
+        Query() = default;
+        explicit Query(ArchetypeGraph& graph):graph(&graph){
+            update();
+        }
+
+        void update(){
+            if(graph == nullptr)
+                return;
+
+            auto created = graph->created();
+            for(; seen < created.size(); ++seen){
+                auto archetype = created[seen];
+                if(isSubset(required_bit, archetype->bit()))
+                    matches.push_back(View::match(archetype));
+            }
+        }
+
+        // updates, then views every matching archetype
+        View view(){
+            update();
+            if(graph == nullptr)
+                return View(matches, {});
+            // a filtered view takes a tick of its own, so the next one skips
+            // its writes; others stamp with the current tick
+            if constexpr((changed_bit | added_bit) == 0)
+                return View(matches, {.now = graph->changeTick()});
+            ChangeTicks ticks{.since = lastTick, .now = graph->advanceTick(), .changed = changed_bit, .added = added_bit};
+            lastTick = ticks.now;
+            return View(matches, ticks);
+        }
+        std::span<const Match> archetypes() const{ return matches; }
+
+        auto begin(){ return view().begin(); }
+        auto   end(){ return typename View::sentinel{}; }
+        // rows the next view() would visit
+        size_t size(){
+            update();
+            return View(matches, {.since = lastTick, .changed = changed_bit, .added = added_bit}).size();
+        }
+
+        template<typename F>
+        void forEachChunk(F&& f){ view().forEachChunk(std::forward<F>(f)); }
+        template<typename F>
+        void parallelForEachChunk(F&& f, size_t grain = View::PARALLEL_GRAIN, job_system& jobs = job_system::shared()){
+            view().parallelForEachChunk(std::forward<F>(f), grain, jobs);
+        }
+        template<typename F>
+        void parallelForEach(F&& f, size_t grain = View::PARALLEL_GRAIN, job_system& jobs = job_system::shared()){
+            view().parallelForEach(std::forward<F>(f), grain, jobs);
+        }
+    };
+}
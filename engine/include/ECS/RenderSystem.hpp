@@ -15,5 +15,6 @@ namespace RenderToy
         void onUpdate(DeltaTime) override;
 
         SystemChain execAfter() const override;
+        ComponentAccess getAccess() const override;
     };
 }
\ No newline at end of file
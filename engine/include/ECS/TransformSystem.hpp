@@ -1,10 +1,27 @@
 #pragma once
 
-#include "ISystem.hpp"
+#include <span>
+#include <vector>
+#include "math.hpp"
+#include "ECS/Entity.hpp"
+#include "ECS/ISystem.hpp"
+#include "ECS/Query.hpp"
 
 namespace RenderToy
 {
+    // builds a world matrix (T * R * S) for every active Transform each update
     class TransformSystem: public ISystem{
+    private:
+        World* world = nullptr;
+        Query<const Transform> transforms;
+
+        // SoA scratch, reused across frames
+        std::vector<EntityID> entities;
+        std::vector<Vec3> positions;
+        std::vector<Vec4> rotations;
+        std::vector<Vec3> scales;
+        std::vector<Mat4> worldMatrices;
+
     public:
         TransformSystem() = default;
 
@@ -12,9 +29,15 @@ namespace RenderToy
             return "TransformSystem";
         }
 
+        void onInit(World*) override;
         void onUpdate(DeltaTime) override;
 
         SystemChain execAfter() const override;
         SystemChain execBefore() const override;
+        ComponentAccess getAccess() const override;
+
+        // worldMatrices[i] belongs to entities[i]; valid until the next update
+        std::span<const EntityID> getEntities() const{ return entities; }
+        std::span<const Mat4> getWorldMatrices() const{ return worldMatrices; }
     };
 }
\ No newline at end of file
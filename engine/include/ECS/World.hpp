@@ -1,9 +1,12 @@
 #pragma once 
 
 #include <memory>
+#include <span>
 #include <typeindex>
 #include <unordered_map>
 #include <vector>
+#include "job_system.hpp"
+#include "pool_allocator.hpp"
 #include "Time.hpp"
 #include "ECS/EntityRegistry.hpp"
 #include "ECS/ISystem.hpp"
@@ -12,22 +15,31 @@ namespace RenderToy
 {
     class World{
     private:
-        using SystemPtr = std::unique_ptr<ISystem>;
+        using SystemPtr = pool_ptr<ISystem>;
 
         EntityRegistry entityRegistry;
         std::unordered_map<std::type_index, SystemPtr> systems;
+        // in addSystem() order, so sorting doesn't depend on hashing
+        std::vector<ISystem*> addedSystems;
         bool needsSort = false;
         std::vector<ISystem*> sortedSystems;
+        // systemWaves[i] runs after every system of wave i - 1; the systems
+        // of one wave neither conflict nor are ordered against each other
+        std::vector<std::vector<ISystem*>> systemWaves;
+        job_system* jobs;
 
     public:
+        explicit World(job_system& jobs = job_system::shared()):jobs(&jobs){}
+
         template<System S, typename... Args>
         S* addSystem(Args&&... args){
-            auto system = std::make_unique<S>(std::forward<Args>(args)...);
+            auto system = make_pooled<S>(std::forward<Args>(args)...);
             auto ptr = system.get();
 
             system->onInit(this);
 
-            systems.emplace(typeid(S), std::move(system));
+            if(systems.emplace(typeid(S), std::move(system)).second)
+                addedSystems.push_back(ptr);
             needsSort = true;
 
             return ptr;
@@ -42,7 +54,11 @@ namespace RenderToy
             return it->second.get();
         }
 
+        EntityRegistry& getRegistry(){ return entityRegistry; }
+
+        // runs the waves in order, the systems of each wave in parallel
         void update(DeltaTime);
         void sortSystems();
+        std::span<const std::vector<ISystem*>> getSystemWaves() const{ return systemWaves; }
     };
 }
\ No newline at end of file
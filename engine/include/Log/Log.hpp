@@ -1,25 +1,41 @@
 #pragma once
 
 #include <format>
+#include <iterator>
+#include "frame_arena.hpp"
 #include "Logger.hpp"
 
 namespace RenderToy
 {
+    // per-thread scratch for message text, rewound after every message
+    inline frame_arena& logScratch(){
+        thread_local frame_arena arena(4*1024);
+        return arena;
+    }
+
     template<typename... Args>
     void log(LogLevel level, LogCategory category,
         std::source_location location,
         std::format_string<Args...> fmt, Args&&... args
     ){
-        LogMessage msg{
-            .level = level,
-            .category = category,
-            .text = std::format(fmt, std::forward<Args>(args)...),
-            .location = location,
-            .thread_id = std::this_thread::get_id(),
-            .time_point = std::chrono::system_clock::now()
-        };
+        if(level < Logger::instance().getMinLevel())
+            return;
+
+        auto& scratch = logScratch();
+        {
+            LogMessage msg{
+                .level = level,
+                .category = category,
+                .text = std::pmr::string(scratch.resource()),
+                .location = location,
+                .thread_id = std::this_thread::get_id(),
+                .time_point = std::chrono::system_clock::now()
+            };
+            std::format_to(std::back_inserter(msg.text), fmt, std::forward<Args>(args)...);
 
-        Logger::instance().log(std::move(msg));
+            Logger::instance().log(std::move(msg));
+        }
+        scratch.reset();
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory_resource>
 #include <string>
 #include <source_location>
 #include <thread>
@@ -12,7 +13,8 @@ namespace RenderToy
     struct LogMessage{
         LogLevel level;
         LogCategory category;
-        std::string text;
+        // lives in the logging thread's scratch arena, valid only during ISink::write
+        std::pmr::string text;
 
         std::source_location location;
 
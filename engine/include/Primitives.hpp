@@ -1,7 +1,9 @@
 #pragma once
 
 #include "math.hpp"
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include "string.hpp"
 
 namespace RenderToy
@@ -16,17 +18,15 @@ namespace RenderToy
         MainCamera  =  0,
         SubCamera   =  1,
     };
-    inline auto cameraType(const std::string& text){
-        static std::unordered_map<std::string, CameraType> text2camera = {
+    inline auto cameraType(std::string_view text){
+        static constexpr std::pair<std::string_view, CameraType> text2camera[] = {
             {"MAINCAMERA", CameraType::MainCamera},
             { "SUBCAMERA",  CameraType::SubCamera},
         };
-        auto upper = toUpper(text);
-        auto it = text2camera.find(upper);
-        if (it == text2camera.end()){
-            return CameraType::UNKNOWN;
-        }
-        return it->second;
+        for(auto [name, type]: text2camera)
+            if(equalsIgnoreCase(text, name))
+                return type;
+        return CameraType::UNKNOWN;
     }
 
     enum class Projection: uint8_t{
@@ -34,17 +34,15 @@ namespace RenderToy
         PERSPECTIVE =  0,
         ORTHOGRAPHIC=  1,
     };
-    inline auto projection(const std::string& text){
-        static std::unordered_map<std::string, Projection> text2projection = {
+    inline auto projection(std::string_view text){
+        static constexpr std::pair<std::string_view, Projection> text2projection[] = {
             {"PERSPECTIVE", Projection::PERSPECTIVE},
             {"ORTHOGRAPHIC",  Projection::ORTHOGRAPHIC},
         };
-        auto upper = toUpper(text);
-        auto it = text2projection.find(upper);
-        if (it == text2projection.end()){
-            return Projection::UNKNOWN;
-        }
-        return it->second;
+        for(auto [name, type]: text2projection)
+            if(equalsIgnoreCase(text, name))
+                return type;
+        return Projection::UNKNOWN;
     }
 
     struct Ray{
@@ -5,6 +5,7 @@
 #include "RHIDevice.hpp"
 #include "Log/Category.hpp"
 #include "Log/Log.hpp"
+#include "frame_arena.hpp"
 #include <chrono>
 
 namespace RenderToy
@@ -34,6 +35,9 @@ namespace RenderToy
             // Wait for oldest frame to complete
             fenceManager.beginFrame();
 
+            // GPU is done with this slot, so its scratch memory can be reused
+            frameArena.begin_frame(getCurrentFrameIndex());
+
             // Update timing
             auto currentTime = std::chrono::high_resolution_clock::now();
             std::chrono::duration<double> elapsed = currentTime - lastFrameTime;
@@ -95,9 +99,14 @@ namespace RenderToy
             return fenceManager.getCurrentFence();
         }
 
+        // Scratch memory of the current frame, valid until this slot is reused
+        // RHI_FRAMES_IN_FLIGHT frames later. Call local() from the allocating thread.
+        threaded_frame_arena& getFrameArena() { return frameArena.current(); }
+
     private:
         RHIDevice* device;
         RHIFrameFenceManager fenceManager;
+        buffered_frame_arena<RHI_FRAMES_IN_FLIGHT, threaded_frame_arena> frameArena;
 
         uint64_t frameNumber;
         std::chrono::time_point<std::chrono::high_resolution_clock> lastFrameTime;
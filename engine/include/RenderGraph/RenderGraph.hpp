@@ -1,10 +1,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 #include <memory>
-#include "slot_map.hpp"
+#include "dense_slot_map.hpp"
+#include "frame_arena.hpp"
+#include "interned_name.hpp"
+#include "pool_allocator.hpp"
 #include "RHI/RHIDevice.hpp"
 #include "RHI/RHITexture.hpp"
 #include "RHI/RHIBuffer.hpp"
@@ -17,7 +20,7 @@
 namespace RenderToy {
     /// @brief RenderGraph texture resource
     struct RGTexture {
-        std::string name;
+        interned_name name;
         RHITextureCreateDesc desc;
         RHITextureHandle rhiHandle = RHI_INVALID_TEXTURE_HANDLE;
         bool isImported = false; // External resource
@@ -29,7 +32,7 @@ namespace RenderToy {
 
     /// @brief RenderGraph buffer resource
     struct RGBuffer {
-        std::string name;
+        interned_name name;
         RHIBufferCreateDesc desc;
         RHIBufferHandle rhiHandle = RHI_INVALID_BUFFER_HANDLE;
         bool isImported = false; // External resource
@@ -79,13 +82,19 @@ namespace RenderToy {
         RHITextureHandle getRHITexture(RGTextureHandle handle) const;
 
         /// @brief Get RHI texture handle by name
-        RHITextureHandle getRHITexture(const std::string& name) const;
+        RHITextureHandle getRHITexture(std::string_view name) const;
+
+        /// @brief Get RHI texture handle by interned name (no string compare)
+        RHITextureHandle getRHITexture(interned_name name) const;
 
         /// @brief Get RHI buffer handle from RenderGraph handle
         RHIBufferHandle getRHIBuffer(RGBufferHandle handle) const;
 
         /// @brief Get RHI buffer handle by name
-        RHIBufferHandle getRHIBuffer(const std::string& name) const;
+        RHIBufferHandle getRHIBuffer(std::string_view name) const;
+
+        /// @brief Get RHI buffer handle by interned name (no string compare)
+        RHIBufferHandle getRHIBuffer(interned_name name) const;
 
         /// @brief Get device
         RHIDevice* getDevice() const { return m_device; }
@@ -93,10 +102,10 @@ namespace RenderToy {
     private:
         // ========== Internal Resource Management ==========
 
-        RGTextureHandle createTexture(const std::string& name, const RHITextureCreateDesc& desc);
-        RGBufferHandle createBuffer(const std::string& name, const RHIBufferCreateDesc& desc);
-        RGTextureHandle importTexture(const std::string& name, RHITextureHandle handle);
-        RGBufferHandle importBuffer(const std::string& name, RHIBufferHandle handle);
+        RGTextureHandle createTexture(interned_name name, const RHITextureCreateDesc& desc);
+        RGBufferHandle createBuffer(interned_name name, const RHIBufferCreateDesc& desc);
+        RGTextureHandle importTexture(interned_name name, RHITextureHandle handle);
+        RGBufferHandle importBuffer(interned_name name, RHIBufferHandle handle);
 
         void registerTextureRead(RGTextureHandle handle, uint32_t passIndex);
         void registerTextureWrite(RGTextureHandle handle, uint32_t passIndex);
@@ -125,22 +134,24 @@ namespace RenderToy {
         RHIDevice* m_device = nullptr;
 
         // Passes
-        std::vector<std::unique_ptr<RenderPass>> m_passes;
+        std::vector<pool_ptr<RenderPass>> m_passes;
         std::vector<uint32_t> m_sortedPassIndices; // Execution order after compile
 
         // Resources
-        slot_map<RGTexture> m_textures;
-        slot_map<RGBuffer> m_buffers;
-        std::vector<RGTextureHandle> m_allTextureHandles; // Track all texture handles for iteration
-        std::vector<RGBufferHandle> m_allBufferHandles;   // Track all buffer handles for iteration
+        dense_slot_map<RGTexture> m_textures; // Packed, iterable without handle lists
+        dense_slot_map<RGBuffer> m_buffers;
 
-        // Name lookup
-        std::unordered_map<std::string, RGTextureHandle> m_textureNameMap;
-        std::unordered_map<std::string, RGBufferHandle> m_bufferNameMap;
+        // Name lookup (interned keys, string_view lookups hash once)
+        name_map<RGTextureHandle> m_textureNameMap;
+        name_map<RGBufferHandle> m_bufferNameMap;
 
         // Dependency graph (adjacency list)
         std::vector<std::vector<uint32_t>> m_passEdges; // m_passEdges[i] = passes that depend on pass i
 
+        // Scratch read/write lists for buildDependencyGraph(), rewound per pass;
+        // kept across compiles so only the first one touches the heap
+        frame_arena m_scratch;
+
         // State
         bool m_isCompiled = false;
 
@@ -167,7 +178,7 @@ namespace RenderToy {
         };
 
         // Create the pass
-        auto pass = std::make_unique<RenderPass>(name, wrappedSetup, executeFunc);
+        auto pass = make_pooled<RenderPass>(name, wrappedSetup, executeFunc);
         RenderPass* passPtr = pass.get();
         m_passes.push_back(std::move(pass));
 
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <string>
+#include <string_view>
+#include "interned_name.hpp"
 #include "RHI/RHIBuffer.hpp"
 #include "RHI/RHITexture.hpp"
 #include "RenderGraph/RGHandle.hpp"
@@ -24,7 +25,12 @@ namespace RenderToy
         /// @brief Get the actual RHI texture handle by name
         /// @param name Resource name
         /// @return Corresponding RHI texture handle
-        RHITextureHandle getTexture(const std::string& name) const;
+        RHITextureHandle getTexture(std::string_view name) const;
+
+        /// @brief Get the actual RHI texture handle by interned name
+        /// @param name Resource name, interned once by the caller
+        /// @return Corresponding RHI texture handle
+        RHITextureHandle getTexture(interned_name name) const;
 
         /// @brief Get the actual RHI buffer handle for a render graph buffer
         /// @param handle RenderGraph buffer handle
@@ -34,7 +40,12 @@ namespace RenderToy
         /// @brief Get the actual RHI buffer handle by name
         /// @param name Resource name
         /// @return Corresponding RHI buffer handle
-        RHIBufferHandle getBuffer(const std::string& name) const;
+        RHIBufferHandle getBuffer(std::string_view name) const;
+
+        /// @brief Get the actual RHI buffer handle by interned name
+        /// @param name Resource name, interned once by the caller
+        /// @return Corresponding RHI buffer handle
+        RHIBufferHandle getBuffer(interned_name name) const;
 
     private:
         RenderGraph* m_graph = nullptr;
@@ -2,6 +2,7 @@
 
 #include <any>
 #include <functional>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include "RHI/RHICommandList.hpp"
@@ -63,16 +64,21 @@ namespace RenderToy
         void addDependency(ResourceDependency dep);
 
         /// @brief Get all texture reads
-        std::vector<RGTextureHandle> getTextureReads() const;
+        /// @details Allocated from resource; pass a frame_arena resource for scratch lists
+        std::pmr::vector<RGTextureHandle> getTextureReads(
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
 
         /// @brief Get all texture writes
-        std::vector<RGTextureHandle> getTextureWrites() const;
+        std::pmr::vector<RGTextureHandle> getTextureWrites(
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
 
         /// @brief Get all buffer reads
-        std::vector<RGBufferHandle> getBufferReads() const;
+        std::pmr::vector<RGBufferHandle> getBufferReads(
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
 
         /// @brief Get all buffer writes
-        std::vector<RGBufferHandle> getBufferWrites() const;
+        std::pmr::vector<RGBufferHandle> getBufferWrites(
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
 
     private:
         std::string m_name;
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <string>
+#include "interned_name.hpp"
 #include "Resource/ResourceTraits.hpp"
 #include "Resource/RenderingResources.hpp"
 #include "Resource/SubmeshTraits.hpp"
@@ -19,14 +20,14 @@ namespace RenderToy
     };
 
     struct TextureKey {
-        std::string canonicalPath;
+        interned_name canonicalPath;
 
         auto operator<=>(const TextureKey&) const = default;
     };
 
     struct TextureKeyHash {
         inline size_t operator()(const TextureKey& k) const noexcept {
-            return std::hash<std::string>{}(k.canonicalPath);
+            return size_t(k.canonicalPath.hash());
         }
     };
 
@@ -39,7 +40,7 @@ namespace RenderToy
         inline static Key makeKey(const Request& request) {
             auto canonical = std::filesystem::weakly_canonical(request.filePath);
             return Key{
-                .canonicalPath = canonical.string()
+                .canonicalPath = interned_name(canonical.string())
             };
         }
 
@@ -60,7 +61,7 @@ namespace RenderToy
     };
 
     struct MaterialKey {
-        std::string canonicalPath;
+        interned_name canonicalPath;
         uint32_t materialIndex;
 
         auto operator<=>(const MaterialKey&) const = default;
@@ -68,9 +69,7 @@ namespace RenderToy
 
     struct MaterialKeyHash {
         inline size_t operator()(const MaterialKey& k) const noexcept {
-            size_t h1 = std::hash<std::string>{}(k.canonicalPath);
-            size_t h2 = std::hash<uint32_t>{}(k.materialIndex);
-            return h1 ^ (h2 << 1);
+            return size_t(hash_combine(k.canonicalPath.hash(), k.materialIndex));
         }
     };
 
@@ -83,7 +82,7 @@ namespace RenderToy
         inline static Key makeKey(const Request& request) {
             auto canonical = std::filesystem::weakly_canonical(request.filePath);
             return Key{
-                .canonicalPath = canonical.string(),
+                .canonicalPath = interned_name(canonical.string()),
                 .materialIndex = request.materialIndex
             };
         }
@@ -106,17 +105,15 @@ namespace RenderToy
     };
 
     struct ShaderKey {
-        std::string vertexShaderCanonical;
-        std::string fragmentShaderCanonical;
+        interned_name vertexShaderCanonical;
+        interned_name fragmentShaderCanonical;
 
         auto operator<=>(const ShaderKey&) const = default;
     };
 
     struct ShaderKeyHash {
         inline size_t operator()(const ShaderKey& k) const noexcept {
-            size_t h1 = std::hash<std::string>{}(k.vertexShaderCanonical);
-            size_t h2 = std::hash<std::string>{}(k.fragmentShaderCanonical);
-            return h1 ^ (h2 << 1);
+            return size_t(hash_combine(k.vertexShaderCanonical.hash(), k.fragmentShaderCanonical.hash()));
         }
     };
 
@@ -130,8 +127,8 @@ namespace RenderToy
             auto vsCanonical = std::filesystem::weakly_canonical(request.vertexShaderPath);
             auto fsCanonical = std::filesystem::weakly_canonical(request.fragmentShaderPath);
             return Key{
-                .vertexShaderCanonical = vsCanonical.string(),
-                .fragmentShaderCanonical = fsCanonical.string()
+                .vertexShaderCanonical = interned_name(vsCanonical.string()),
+                .fragmentShaderCanonical = interned_name(fsCanonical.string())
             };
         }
 
@@ -151,14 +148,14 @@ namespace RenderToy
     };
 
     struct MeshKey {
-        std::string canonicalPath;
+        interned_name canonicalPath;
 
         auto operator<=>(const MeshKey&) const = default;
     };
 
     struct MeshKeyHash {
         inline size_t operator()(const MeshKey& k) const noexcept {
-            return std::hash<std::string>{}(k.canonicalPath);
+            return size_t(k.canonicalPath.hash());
         }
     };
 
@@ -171,7 +168,7 @@ namespace RenderToy
         inline static Key makeKey(const Request& request) {
             auto canonical = std::filesystem::weakly_canonical(request.filePath);
             return Key{
-                .canonicalPath = canonical.string()
+                .canonicalPath = interned_name(canonical.string())
             };
         }
 
@@ -192,14 +189,14 @@ namespace RenderToy
     };
 
     struct MaterialSetKey {
-        std::string canonicalPath;
+        interned_name canonicalPath;
 
         auto operator<=>(const MaterialSetKey&) const = default;
     };
 
     struct MaterialSetKeyHash {
         inline size_t operator()(const MaterialSetKey& k) const noexcept {
-            return std::hash<std::string>{}(k.canonicalPath);
+            return size_t(k.canonicalPath.hash());
         }
     };
 
@@ -212,7 +209,7 @@ namespace RenderToy
         inline static Key makeKey(const Request& request) {
             auto canonical = std::filesystem::weakly_canonical(request.filePath);
             return Key{
-                .canonicalPath = canonical.string()
+                .canonicalPath = interned_name(canonical.string())
             };
         }
 
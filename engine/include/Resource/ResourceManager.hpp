@@ -1,5 +1,6 @@
 #pragma once
 
+#include "flat_hash_map.hpp"
 #include "slot_map.hpp"
 #include "Primitives.hpp"
 #include "Resource/ResourceTraits.hpp"
@@ -18,9 +19,10 @@ namespace RenderToy
 
     private:
         slot_map<T> pool;
-        std::unordered_map<Key, Handle,    KeyHash> keyToHandle;
+        // flat tables: no per-entry node, load/unload churn never allocates
+        flat_hash_map<Key, Handle, KeyHash> keyToHandle;
         // map for unload
-        std::unordered_map<Handle, Key, HandleHash> handleToKey;
+        flat_hash_map<Handle, Key, HandleHash> handleToKey;
 
     public:
         Handle getOrLoad(const Request& request){
@@ -60,6 +62,17 @@ namespace RenderToy
             return handle;
         }
 
+        /**
+         * Pre-size the pool and lookup tables for a bulk load
+         *
+         * @param count Number of resources expected to be added
+         */
+        void reserve(size_t count){
+            pool.reserve(pool.size() + count);
+            keyToHandle.reserve(keyToHandle.size() + count);
+            handleToKey.reserve(handleToKey.size() + count);
+        }
+
         T*       get(Handle handle)      { return &pool[handle]; }
         const T* get(Handle handle) const{ return &pool[handle]; }
 
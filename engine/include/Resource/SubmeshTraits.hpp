@@ -4,6 +4,7 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include "interned_name.hpp"
 #include "Log/Log.hpp"
 #include "Resource/ResourceTraits.hpp"
 #include "Resource/Submesh.hpp"
@@ -20,7 +21,7 @@ namespace RenderToy
     };
 
     struct SubmeshKey{
-        std::string canonicalPath;
+        interned_name canonicalPath;
         uint32_t submeshIndex;
 
         auto operator<=>(const SubmeshKey&) const = default;
@@ -28,9 +29,7 @@ namespace RenderToy
 
     struct SubmeshKeyHash{
         inline size_t operator()(const SubmeshKey& k) const noexcept{
-            size_t h1 = std::hash<std::string>{}(k.canonicalPath);
-            size_t h2 = std::hash<uint32_t>{}(k.submeshIndex);
-            return h1 ^ (h2 << 1);
+            return size_t(hash_combine(k.canonicalPath.hash(), k.submeshIndex));
         }
     };
 
@@ -43,7 +42,7 @@ namespace RenderToy
         inline static Key makeKey(const Request& request){
             auto canonical = std::filesystem::weakly_canonical(request.path);
             return Key{
-                .canonicalPath = canonical.string(),
+                .canonicalPath = interned_name(canonical.string()),
                 .submeshIndex = request.submeshIndex
             };
         }
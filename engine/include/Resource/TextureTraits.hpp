@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include "interned_name.hpp"
 #include "Log/Log.hpp"
 #include "Resource/ResourceTraits.hpp"
 #include "Resource/Texture.hpp"
@@ -26,7 +27,7 @@ namespace RenderToy
     };
 
     struct TextureKey{
-        std::string canonicalPath;
+        interned_name canonicalPath;
         TextureFormat format;
         SamplingMode sampling;
         bool srgb;
@@ -36,14 +37,11 @@ namespace RenderToy
 
     struct TextureKeyHash{
         inline size_t operator()(const TextureKey& k) const noexcept{
-            size_t hash = std::hash<std::string>{}(k.canonicalPath);
-            hash ^= (std::hash<int>{}(static_cast<int>(k.format))
-                + 0x9e3779b9 + (hash << 6) + (hash >> 2));
-            hash ^= (std::hash<int>{}(static_cast<int>(k.sampling))
-                + 0x9e3779b9 + (hash << 6) + (hash >> 2));
-            hash ^= (std::hash<bool>{}(k.srgb)
-                + 0x9e3779b9 + (hash << 6) + (hash >> 2));
-            return hash;
+            uint64_t hash = k.canonicalPath.hash();
+            hash = hash_combine(hash, uint64_t(k.format));
+            hash = hash_combine(hash, uint64_t(k.sampling));
+            hash = hash_combine(hash, uint64_t(k.srgb));
+            return size_t(hash);
         }
     };
 
@@ -57,7 +55,7 @@ namespace RenderToy
             auto canonical = std::filesystem::weakly_canonical(request.path);
 
             return Key{
-                .canonicalPath = canonical.string(),
+                .canonicalPath = interned_name(canonical.string()),
                 .format = request.format,
                 .sampling = request.sampling,
                 .srgb = request.srgb
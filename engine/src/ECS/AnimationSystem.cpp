@@ -14,4 +14,7 @@ namespace RenderToy
     ISystem::SystemChain AnimationSystem::execBefore() const{
         return { typeid(TransformSystem) };
     }
+    ComponentAccess AnimationSystem::getAccess() const{
+        return writes<Transform>();
+    }
 }
\ No newline at end of file
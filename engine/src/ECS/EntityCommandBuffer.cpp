@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include "ECS/EntityCommandBuffer.hpp"
+#include "ECS/EntityRegistry.hpp"
+
+namespace RenderToy
+{
+    namespace
+    {
+        std::atomic<uint64_t> bufferSerial = 1;
+
+        struct PendingCommand{
+            EntityID id;
+            uint8_t op;
+            ArchetypeBit bit;
+            const std::byte* bytes;
+        };
+
+        struct Move{
+            Archetype* src;
+            Archetype* dst;
+            Index srcIndex;
+            EntityInfo* info;
+            // appended components in `added`
+            size_t firstAdded;
+            size_t addedCount;
+        };
+        struct Appended{
+            ArchetypeBit component;
+            const std::byte* bytes;
+        };
+        struct Removal{
+            Archetype* archetype;
+            Index index;
+        };
+
+        // one memcpy per run of components contiguous in both layouts
+        struct CopyRun{
+            size_t srcOffset;
+            size_t dstOffset;
+            size_t size;
+        };
+        std::vector<CopyRun> copyRunsOf(const Archetype& src, const Archetype& dst){
+            std::vector<CopyRun> runs{{0, 0, sizeof(EntityID)}};
+            for(auto rest = src.bit() & dst.bit(); rest != 0; rest &= rest - 1){
+                auto component = rest & (~rest + 1);
+                size_t srcOffset = src.offset(component);
+                size_t dstOffset = dst.offset(component);
+                auto size = component_size(component);
+
+                auto& last = runs.back();
+                if(last.srcOffset + last.size == srcOffset && last.dstOffset + last.size == dstOffset)
+                    last.size += size;
+                else
+                    runs.push_back({srcOffset, dstOffset, size});
+            }
+            return runs;
+        }
+
+        void write(const Archetype& archetype, void* chunk, const Appended& added){
+            std::memcpy(ptrAdd(chunk, archetype.offset(added.component)), added.bytes, component_size(added.component));
+        }
+    }
+
+    struct EntityCommandBuffer::Scratch{
+        std::vector<PendingCommand> creates;
+        std::vector<PendingCommand> changes;
+        std::vector<Move> moves;
+        std::vector<Appended> added;
+        std::vector<Removal> removals;
+        std::vector<EntityID> destroyed;
+
+        void clear(){
+            creates.clear();
+            changes.clear();
+            moves.clear();
+            added.clear();
+            removals.clear();
+            destroyed.clear();
+        }
+    };
+
+    EntityCommandBuffer::EntityCommandBuffer()
+    :scratch(std::make_unique<Scratch>()),
+    serial(bufferSerial.fetch_add(1, std::memory_order_relaxed)){}
+    EntityCommandBuffer::~EntityCommandBuffer() = default;
+
+    auto EntityCommandBuffer::local()->Stream&{
+        struct Cache{
+            uint64_t serial = 0;
+            Stream* stream = nullptr;
+        };
+        thread_local Cache cache;
+        if(cache.serial == serial)
+            return *cache.stream;
+
+        std::lock_guard lock(streamsMutex);
+        auto owner = std::this_thread::get_id();
+        auto it = std::ranges::find(streams, owner, [](const auto& stream){ return stream->owner; });
+        if(it == streams.end()){
+            streams.push_back(std::make_unique<Stream>());
+            streams.back()->owner = owner;
+            it = streams.end() - 1;
+        }
+
+        cache = {serial, it->get()};
+        return **it;
+    }
+
+    size_t EntityCommandBuffer::size() const{
+        size_t size = 0;
+        for(const auto& stream: streams)
+            size += stream->commands.size();
+        return size;
+    }
+
+    void EntityCommandBuffer::clear(){
+        // streams stay registered, so threads keep their cached stream
+        for(auto& stream: streams){
+            stream->commands.clear();
+            stream->bytes.clear();
+        }
+    }
+
+    void EntityCommandBuffer::playback(EntityRegistry& registry){
+        auto& entityIndex = registry.entityIndex;
+        auto tick = registry.archetypes.changeTick();
+
+        scratch->clear();
+        auto& [creates, changes, moves, added, removals, destroyed] = *scratch;
+
+        // 1. gather, and bring each entity's commands together
+        for(const auto& stream: streams){
+            for(const auto& command: stream->commands){
+                PendingCommand pending{
+                    command.id, uint8_t(command.op), command.bit,
+                    stream->bytes.data() + command.payload
+                };
+                if(command.op == Op::CREATE)
+                    creates.push_back(pending);
+                else
+                    changes.push_back(pending);
+            }
+        }
+        // usually recorded in id order already
+        if(!std::ranges::is_sorted(changes, {}, &PendingCommand::id))
+            std::ranges::stable_sort(changes, {}, &PendingCommand::id);
+
+        // 2. fold every entity's commands into one move, in-place write or destroy
+        for(auto first = changes.begin(); first != changes.end();){
+            auto id = first->id;
+            auto last = std::find_if(first, changes.end(), [id](const auto& c){ return c.id != id; });
+
+            auto info = entityIndex.find(id);
+            if(info == nullptr){
+                LOG_WARN(LOG_CORE, "Entity {} not exist. recorded commands are skipped", id);
+                first = last;
+                continue;
+            }
+
+            auto archetype = info->archetype;
+            auto firstAdded = added.size();
+            bool destroy = false;
+            for(auto it = first; it != last && !destroy; ++it){
+                switch(Op(it->op)){
+                case Op::DESTROY:
+                    destroy = true;
+                    break;
+                case Op::APPEND:
+                    // same as appendComponent: an existing component is kept
+                    if(!archetype->has(it->bit)){
+                        archetype = registry.archetypes.addEdge(*archetype, it->bit).target;
+                        added.push_back({it->bit, it->bytes});
+                    }
+                    break;
+                case Op::REMOVE:
+                    if(archetype->has(it->bit)){
+                        archetype = registry.archetypes.removeEdge(*archetype, it->bit).target;
+                        auto from = std::remove_if(added.begin() + firstAdded, added.end(),
+                            [component = it->bit](const Appended& a){ return a.component == component; });
+                        added.erase(from, added.end());
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+            first = last;
+
+            if(destroy){
+                added.resize(firstAdded);
+                removals.push_back({info->archetype, info->chunkIndex});
+                destroyed.push_back(id);
+            }
+            else if(archetype != info->archetype){
+                moves.push_back({info->archetype, archetype, info->chunkIndex, info, firstAdded, added.size() - firstAdded});
+            }
+            else if(added.size() > firstAdded){
+                // removed and appended again: overwrite in place
+                auto chunk = archetype->chunk(info->chunkIndex);
+                for(auto i = firstAdded; i < added.size(); ++i){
+                    write(*archetype, chunk, added[i]);
+                    archetype->markAdded(added[i].component, info->chunkIndex, tick);
+                }
+                added.resize(firstAdded);
+            }
+        }
+
+        // 3. moves, one copy layout and one resize per (src, dst) group.
+        // the source chunks stay in place until every group is copied.
+        // ordered by bit, not address, so playback is deterministic
+        auto moveOrder = [](const Move& lhs, const Move& rhs){
+            return std::tuple(lhs.src->bit(), lhs.dst->bit(), lhs.srcIndex)
+                < std::tuple(rhs.src->bit(), rhs.dst->bit(), rhs.srcIndex);
+        };
+        if(!std::ranges::is_sorted(moves, moveOrder))
+            std::ranges::sort(moves, moveOrder);
+        for(auto first = moves.begin(); first != moves.end();){
+            auto src = first->src;
+            auto dst = first->dst;
+            auto last = std::find_if(first, moves.end(), [src, dst](const Move& m){
+                return m.src != src || m.dst != dst;
+            });
+
+            auto runs = copyRunsOf(*src, *dst);
+            auto& srcVec = src->chunks;
+            auto& dstVec = dst->chunks;
+            auto base = dst->allocate(last - first, tick);
+
+            for(auto it = first; it != last; ++it){
+                auto dstIndex = base + (it - first);
+                auto srcChunk = srcVec[it->srcIndex];
+                auto dstChunk = dstVec[dstIndex];
+                for(const auto& run: runs)
+                    std::memcpy(ptrAdd(dstChunk, run.dstOffset), ptrAdd(srcChunk, run.srcOffset), run.size);
+                dst->copyTicks(*src, it->srcIndex, dstIndex);
+                for(auto i = it->firstAdded; i < it->firstAdded + it->addedCount; ++i){
+                    write(*dst, dstChunk, added[i]);
+                    dst->markAdded(added[i].component, dstIndex, tick);
+                }
+
+                it->info->archetype = dst;
+                it->info->chunkIndex = dstIndex;
+                removals.push_back({src, it->srcIndex});
+            }
+            first = last;
+        }
+
+        // 4. free the old chunks, highest index first per archetype: the
+        // chunk swapped into a hole is then never one still to be removed
+        auto removalOrder = [](const Removal& lhs, const Removal& rhs){
+            auto lhsBit = lhs.archetype->bit();
+            auto rhsBit = rhs.archetype->bit();
+            return lhsBit != rhsBit ? lhsBit < rhsBit : lhs.index > rhs.index;
+        };
+        // a single move group pushes its removals in ascending index order
+        if(!std::ranges::is_sorted(removals, removalOrder)){
+            std::ranges::reverse(removals);
+            if(!std::ranges::is_sorted(removals, removalOrder))
+                std::ranges::sort(removals, removalOrder);
+        }
+        for(const auto& removal: removals){
+            removal.archetype->swapRemove(removal.index);
+            registry.relinkSwapped(removal.archetype->chunks, removal.index);
+        }
+        for(auto id: destroyed)
+            entityIndex.destroy(id);
+
+        // 5. creates, one resize per archetype
+        if(!std::ranges::is_sorted(creates, {}, &PendingCommand::bit))
+            std::ranges::stable_sort(creates, {}, &PendingCommand::bit);
+        for(auto first = creates.begin(); first != creates.end();){
+            auto bit = first->bit;
+            auto last = std::find_if(first, creates.end(), [bit](const auto& c){ return c.bit != bit; });
+
+            auto& archetype = registry.archetypes.get(bit);
+            auto& vec = archetype.chunks;
+            auto base = archetype.allocate(last - first, tick);
+            auto chunkSize = archetype.chunkSize();
+
+            for(auto it = first; it != last; ++it){
+                auto index = base + (it - first);
+                auto chunk = vec[index];
+                std::memcpy(chunk, it->bytes, chunkSize);
+
+                auto id = entityIndex.create(EntityInfo{.archetype = &archetype, .chunkIndex = index});
+                std::memcpy(chunk, &id, sizeof(id));
+                // every component starts with its EntityID
+                for(auto rest = bit; rest != 0; rest &= rest - 1)
+                    std::memcpy(ptrAdd(chunk, archetype.offset(rest & (~rest + 1))), &id, sizeof(id));
+            }
+            first = last;
+        }
+
+        clear();
+    }
+}
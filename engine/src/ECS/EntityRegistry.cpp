@@ -1,88 +1,54 @@
-#include <algorithm>
 #include "ECS/EntityRegistry.hpp"
 
 namespace RenderToy
 {
     void EntityRegistry::destroyEntity(EntityID id){
-        auto entity_it = entityTable.find(id);
-        if(entity_it == entityTable.end()){
+        auto info_ptr = entityIndex.find(id);
+        if(info_ptr == nullptr){
             LOG_WARN(LOG_CORE, "Entity {} not exist.", id);
             return;
         }
 
-        const auto& info = entity_it->second;
-        auto arch_it = archetypeMap.find(info.bit);
-        if(arch_it == archetypeMap.end()){
-            LOG_FATAL(LOG_CORE, "Archetype of Entity {}: {}, but ArchetypeVector not exist", id, info.bit);
-            return;
-        }
-
-        auto& vec = arch_it->second;
-        vec.swap_remove(info.chunkIndex);
+        const auto& info = *info_ptr;
+        info.archetype->swapRemove(info.chunkIndex);
+        relinkSwapped(info.archetype->chunks, info.chunkIndex);
 
-        entityTable.erase(id);
+        entityIndex.destroy(id);
     }
 
     auto EntityRegistry::query(EntityID id)->Entity{
-        auto entity_it = entityTable.find(id);
-        if(entity_it == entityTable.end()){
+        auto info_ptr = entityIndex.find(id);
+        if(info_ptr == nullptr){
             LOG_WARN(LOG_CORE, "Entity {} not exist.", id);
             return {};
         }
-        const auto& info = entity_it->second;
-
-        auto arch_it = archetypeMap.find(info.bit);
-        if(arch_it == archetypeMap.end()){
-            LOG_FATAL(LOG_CORE, "Archetype of Entity {}: {}, but ArchetypeVector not exist", id, info.bit);
-            return {};
-        }
-        auto& vec = arch_it->second;
+        const auto& info = *info_ptr;
 
         return Entity{
-            .bit=info.bit,
-            .chunk=vec[info.chunkIndex]
+            .bit=info.archetype->bit(),
+            .chunk=info.archetype->chunk(info.chunkIndex)
         };
     }
 
-    auto EntityRegistry::getVector(ArchetypeBit bit)->dynamic_vector&{
-        auto it = archetypeMap.find(bit);
-        if(it != archetypeMap.end())
-            return it->second;
-
-        auto[new_it, _] = archetypeMap.try_emplace(bit, size_of(bit));
-        return new_it->second;
+    void EntityRegistry::relocate(EntityInfo& info, Archetype& target, Index index){
+        info.archetype->swapRemove(info.chunkIndex);
+        relinkSwapped(info.archetype->chunks, info.chunkIndex);
+        info.archetype = &target;
+        info.chunkIndex = index;
     }
 
-    void EntityRegistry::updateEntityInfo(EntityInfo& updated, dynamic_vector& swapped,
-        ArchetypeBit updated_bit, Index updated_index
-    ){
-        if(swapped.size() > 0){
-            auto it = findEntityFromProperty(updated.bit, swapped.size());
-
-            if(it == entityTable.end()){
-                throw std::runtime_error("Entity Table integrity Broken!");
-            }
-
-            auto& swapped_entity = it->second;
-            swapped_entity.chunkIndex = updated.chunkIndex;
-        }
-        updated.bit = updated_bit;
-        updated.chunkIndex = updated_index;
-    }
+    void EntityRegistry::relinkSwapped(Archetype::ChunkVector& vec, Index hole){
+        // removed chunk was the last one, nothing moved
+        if(hole >= vec.size())
+            return;
 
-    auto EntityRegistry::findEntityFromProperty(
-        ArchetypeBit bit, Index chunkIndex
-    )->EntityRegistry::EntityTable::iterator{
-        // TODO. might be replace to entity tag component
-        auto it = std::ranges::find_if(entityTable,
-            [bit, chunkIndex](const auto& pair){
-                const EntityInfo& info = pair.second;
-                return info.bit == bit && info.chunkIndex == chunkIndex;
-            }
-        );
-        if(it == entityTable.end()){
-            LOG_FATAL(LOG_CORE, "Entity with archetype {}, index {} not in entity table!", bit, chunkIndex);
+        // every chunk starts with its EntityID
+        auto swapped_id = *static_cast<EntityID*>(vec[hole]);
+        auto swapped_entity = entityIndex.find(swapped_id);
+        if(swapped_entity == nullptr){
+            LOG_FATAL(LOG_CORE, "Entity {} moved to index {} not in entity table!", swapped_id, hole);
+            throw std::runtime_error("Entity Table integrity Broken!");
         }
-        return it;
+        swapped_entity->chunkIndex = hole;
     }
-}
\ No newline at end of file
+}
@@ -10,4 +10,7 @@ namespace RenderToy
     ISystem::SystemChain PhysicsSystem::execBefore() const{
         return { typeid(AnimationSystem) };
     }
+    ComponentAccess PhysicsSystem::getAccess() const{
+        return reads<SphereCollider, FixedBoxCollider, BoxCollider>().writes<Transform, Rigidbody>();
+    }
 }
\ No newline at end of file
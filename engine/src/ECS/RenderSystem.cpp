@@ -10,4 +10,7 @@ namespace RenderToy
     ISystem::SystemChain RenderSystem::execAfter() const{
         return { typeid(TransformSystem) };
     }
+    ComponentAccess RenderSystem::getAccess() const{
+        return reads<Transform, Camera, Color, RenderObject>();
+    }
 }
\ No newline at end of file
@@ -1,11 +1,48 @@
 #include "ECS/TransformSystem.hpp"
+#include "math_batch.hpp"
 #include "ECS/AnimationSystem.hpp"
 #include "ECS/RenderSystem.hpp"
+#include "ECS/World.hpp"
 
 namespace RenderToy
 {
+    void TransformSystem::onInit(World* world){
+        this->world = world;
+        if(world)
+            transforms = world->getRegistry().makeQuery<const Transform>();
+    }
+
     void TransformSystem::onUpdate(DeltaTime deltaTime){
-        
+        entities.clear();
+        positions.clear();
+        rotations.clear();
+        scales.clear();
+        if(world == nullptr)
+            return;
+
+        for(auto [id, bit, transform]: transforms){
+            if(!transform.isActive)
+                continue;
+            entities.push_back(id);
+            positions.push_back(transform.position);
+            rotations.push_back(transform.rotation);
+            scales.push_back(transform.scale);
+        }
+
+        worldMatrices.resize(entities.size());
+        normalize_batch(rotations, rotations);
+        quat_to_mat_batch(rotations, worldMatrices);
+
+        // R * S scales the columns, T fills the last one
+        for(Index i=0; i<worldMatrices.size(); ++i){
+            auto& m = worldMatrices[i];
+            for(Index row=0; row<3; ++row){
+                m[row].x *= scales[i].x;
+                m[row].y *= scales[i].y;
+                m[row].z *= scales[i].z;
+                m[row].w = positions[i][row];
+            }
+        }
     }
 
     ISystem::SystemChain TransformSystem::execAfter() const{
@@ -14,4 +51,7 @@ namespace RenderToy
     ISystem::SystemChain TransformSystem::execBefore() const{
         return { typeid(RenderSystem) };
     }
+    ComponentAccess TransformSystem::getAccess() const{
+        return reads<Transform>();
+    }
 }
\ No newline at end of file
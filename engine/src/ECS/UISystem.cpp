@@ -10,4 +10,9 @@ namespace RenderToy
     ISystem::SystemChain UISystem::execAfter() const{
         return { typeid(RenderSystem) };
     }
+    ComponentAccess UISystem::getAccess() const{
+        // no components, but UI state lives outside the registry and
+        // belongs to the main thread
+        return ComponentAccess{}.onMainThread();
+    }
 }
\ No newline at end of file
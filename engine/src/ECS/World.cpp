@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <queue>
+#include <stdexcept>
 #include <unordered_map>
 #include <vector>
 #include "ECS/World.hpp"
@@ -14,9 +16,32 @@ namespace RenderToy
             needsSort = false;
         }
 
-        for(auto& system: sortedSystems)
-            if(system->isEnabled())
-                system->onUpdate(deltaTime);
+        std::vector<ISystem*> enabled;
+        for(const auto& wave: systemWaves){
+            enabled.clear();
+            for(auto system: wave)
+                if(system->isEnabled())
+                    enabled.push_back(system);
+
+            // a wave of one runs right here, when it may
+            if(enabled.size() == 1
+            && (!enabled[0]->getAccess().mainThread || jobs->is_main_thread())){
+                enabled[0]->onUpdate(deltaTime);
+                continue;
+            }
+
+            // one system per job; wait() runs the main-thread ones when
+            // called there, otherwise the main thread's run_main_jobs() does
+            job_counter counter;
+            for(auto system: enabled){
+                auto run = [system, deltaTime]{ system->onUpdate(deltaTime); };
+                if(system->getAccess().mainThread)
+                    jobs->submit_main(run, &counter);
+                else
+                    jobs->submit(run, &counter);
+            }
+            jobs->wait(counter);
+        }
     }
 
     void World::sortSystems(){
@@ -26,19 +51,15 @@ namespace RenderToy
         std::unordered_map<ISystem*, int> inDegree;
 
         // initialize dependency graph
-        for(auto& [_, system]: systems){
-            auto ptr = system.get();
-
+        for(auto ptr: addedSystems){
             inDegree[ptr] = 0;
             graph[ptr] = {};
         }
 
         // add dependency edge
-        for(auto& [_, system]: systems){
-            auto ptr = system.get();
-
+        for(auto ptr: addedSystems){
             // backward dependency
-            for(auto depType: system->execAfter()){
+            for(auto depType: ptr->execAfter()){
                 auto it = systems.find(depType);
                 if(it == systems.end())
                     continue;
@@ -52,7 +73,7 @@ namespace RenderToy
             }
 
             // forward dependency
-            for(auto depType: system->execBefore()){
+            for(auto depType: ptr->execBefore()){
                 auto it = systems.find(depType);
                 if(it == systems.end())
                     continue;
@@ -69,9 +90,9 @@ namespace RenderToy
         std::queue<ISystem*> queue;
         sortedSystems.clear();
 
-        for(auto& [ptr, degree]: inDegree){
+        for(auto ptr: addedSystems){
             // no deps, so execute first.
-            if(degree == 0)
+            if(inDegree[ptr] == 0)
                 queue.push(ptr);
         }
 
@@ -95,5 +116,28 @@ namespace RenderToy
                 "Circular system dependency detected!"
             );
         }
+
+        // group into waves: a system goes one wave after the latest
+        // earlier system it is ordered after or conflicts with
+        std::vector<ComponentAccess> accesses;
+        std::vector<size_t> waveOf(sortedSystems.size(), 0);
+        for(auto system: sortedSystems)
+            accesses.push_back(system->getAccess());
+
+        for(Index later=0; later<sortedSystems.size(); ++later){
+            for(Index earlier=0; earlier<later; ++earlier){
+                const auto& successors = graph[sortedSystems[earlier]];
+                auto ordered = std::ranges::find(successors, sortedSystems[later]) != successors.end();
+                if(ordered || accesses[earlier].conflictsWith(accesses[later]))
+                    waveOf[later] = std::max(waveOf[later], waveOf[earlier] + 1);
+            }
+        }
+
+        systemWaves.clear();
+        for(Index i=0; i<sortedSystems.size(); ++i){
+            if(waveOf[i] >= systemWaves.size())
+                systemWaves.resize(waveOf[i] + 1);
+            systemWaves[waveOf[i]].push_back(sortedSystems[i]);
+        }
     }
 }
\ No newline at end of file
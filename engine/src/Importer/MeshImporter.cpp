@@ -1,9 +1,11 @@
 #include "Importer/MeshImporter.hpp"
 #include <cmath>
 #include <numbers>
+#include <span>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include "math_batch.hpp"
 
 using namespace RenderToy;
 
@@ -223,9 +225,6 @@ namespace RenderToy
             std::numeric_limits<float>::lowest(),
             std::numeric_limits<float>::lowest()
         };
-        MeshData meshData;
-        Vec3 globalMin{std::numeric_limits<float>::max()};
-        Vec3 globalMax{std::numeric_limits<float>::lowest()};
 
         // Process all meshes in the scene
         for(unsigned int meshIdx = 0; meshIdx < scene->mNumMeshes; ++meshIdx){
@@ -254,7 +253,15 @@ namespace RenderToy
                 submesh.materialSlotName = "default";
             }
 
+            // Update global AABB, straight from assimp's packed positions
+            static_assert(sizeof(aiVector3D) == sizeof(Vec3), "aiVector3D must be 3 packed floats");
+            bounds_batch(
+                std::span(reinterpret_cast<const Vec3*>(aiMesh->mVertices), aiMesh->mNumVertices),
+                globalMin, globalMax
+            );
+
             // Extract vertices
+            submesh.vertices.reserve(aiMesh->mNumVertices);
             for(unsigned int i = 0; i < aiMesh->mNumVertices; ++i){
                 Vertex vertex;
 
@@ -263,14 +270,6 @@ namespace RenderToy
                 vertex.position.y = aiMesh->mVertices[i].y;
                 vertex.position.z = aiMesh->mVertices[i].z;
 
-                // Update global AABB
-                globalMin.x = std::min(globalMin.x, vertex.position.x);
-                globalMin.y = std::min(globalMin.y, vertex.position.y);
-                globalMin.z = std::min(globalMin.z, vertex.position.z);
-                globalMax.x = std::max(globalMax.x, vertex.position.x);
-                globalMax.y = std::max(globalMax.y, vertex.position.y);
-                globalMax.z = std::max(globalMax.z, vertex.position.z);
-
                 // Normal
                 if(aiMesh->HasNormals()){
                     vertex.normal.x = aiMesh->mNormals[i].x;
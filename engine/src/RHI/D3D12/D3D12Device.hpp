@@ -4,7 +4,7 @@
 #include "RHI/RHICommandList.hpp"
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include "flat_hash_map.hpp"
 
 // Forward declarations for D3D12
 struct ID3D12Device;
@@ -118,13 +118,13 @@ namespace RenderToy
         std::string deviceName;
 
         // Resource storage
-        // Using simple maps for now - will optimize with slot_map later
-        std::unordered_map<uint64_t, struct D3D12Swapchain*> swapchains;
-        std::unordered_map<uint64_t, struct D3D12Fence*> fences;
-        std::unordered_map<uint64_t, struct D3D12Buffer*> buffers;
-        std::unordered_map<uint64_t, struct D3D12Texture*> textures;
-        std::unordered_map<uint64_t, struct D3D12Shader*> shaders;
-        std::unordered_map<uint64_t, struct D3D12PipelineState*> pipelineStates;
+        // Flat maps keyed by handle index - will optimize with slot_map later
+        flat_hash_map<uint64_t, struct D3D12Swapchain*> swapchains;
+        flat_hash_map<uint64_t, struct D3D12Fence*> fences;
+        flat_hash_map<uint64_t, struct D3D12Buffer*> buffers;
+        flat_hash_map<uint64_t, struct D3D12Texture*> textures;
+        flat_hash_map<uint64_t, struct D3D12Shader*> shaders;
+        flat_hash_map<uint64_t, struct D3D12PipelineState*> pipelineStates;
         uint64_t nextSwapchainId = 1;
         uint64_t nextFenceId = 1;
         uint64_t nextBufferId = 1;
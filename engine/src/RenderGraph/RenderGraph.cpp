@@ -19,15 +19,13 @@ RenderGraph::RenderGraph(RHIDevice* device)
 
 RenderGraph::~RenderGraph() {
     // Destroy all transient resources
-    for (RGTextureHandle handle : m_allTextureHandles) {
-        const RGTexture& texture = m_textures[handle];
+    for (const RGTexture& texture : m_textures) {
         if (!texture.isImported && texture.rhiHandle != RHI_INVALID_TEXTURE_HANDLE) {
             m_device->destroyTexture(texture.rhiHandle);
         }
     }
 
-    for (RGBufferHandle handle : m_allBufferHandles) {
-        const RGBuffer& buffer = m_buffers[handle];
+    for (const RGBuffer& buffer : m_buffers) {
         if (!buffer.isImported && buffer.rhiHandle != RHI_INVALID_BUFFER_HANDLE) {
             m_device->destroyBuffer(buffer.rhiHandle);
         }
@@ -36,7 +34,7 @@ RenderGraph::~RenderGraph() {
 
 // ========== Resource Management ==========
 
-RGTextureHandle RenderGraph::createTexture(const std::string& name, const RHITextureCreateDesc& desc) {
+RGTextureHandle RenderGraph::createTexture(interned_name name, const RHITextureCreateDesc& desc) {
     RGTexture texture;
     texture.name = name;
     texture.desc = desc;
@@ -44,12 +42,11 @@ RGTextureHandle RenderGraph::createTexture(const std::string& name, const RHITex
 
     RGTextureHandle handle = m_textures.push(std::move(texture));
     m_textureNameMap[name] = handle;
-    m_allTextureHandles.push_back(handle);
 
     return handle;
 }
 
-RGBufferHandle RenderGraph::createBuffer(const std::string& name, const RHIBufferCreateDesc& desc) {
+RGBufferHandle RenderGraph::createBuffer(interned_name name, const RHIBufferCreateDesc& desc) {
     RGBuffer buffer;
     buffer.name = name;
     buffer.desc = desc;
@@ -57,12 +54,11 @@ RGBufferHandle RenderGraph::createBuffer(const std::string& name, const RHIBuffe
 
     RGBufferHandle handle = m_buffers.push(std::move(buffer));
     m_bufferNameMap[name] = handle;
-    m_allBufferHandles.push_back(handle);
 
     return handle;
 }
 
-RGTextureHandle RenderGraph::importTexture(const std::string& name, RHITextureHandle handle) {
+RGTextureHandle RenderGraph::importTexture(interned_name name, RHITextureHandle handle) {
     RGTexture texture;
     texture.name = name;
     texture.rhiHandle = handle;
@@ -70,12 +66,11 @@ RGTextureHandle RenderGraph::importTexture(const std::string& name, RHITextureHa
 
     RGTextureHandle rgHandle = m_textures.push(std::move(texture));
     m_textureNameMap[name] = rgHandle;
-    m_allTextureHandles.push_back(rgHandle);
 
     return rgHandle;
 }
 
-RGBufferHandle RenderGraph::importBuffer(const std::string& name, RHIBufferHandle handle) {
+RGBufferHandle RenderGraph::importBuffer(interned_name name, RHIBufferHandle handle) {
     RGBuffer buffer;
     buffer.name = name;
     buffer.rhiHandle = handle;
@@ -83,7 +78,6 @@ RGBufferHandle RenderGraph::importBuffer(const std::string& name, RHIBufferHandl
 
     RGBufferHandle rgHandle = m_buffers.push(std::move(buffer));
     m_bufferNameMap[name] = rgHandle;
-    m_allBufferHandles.push_back(rgHandle);
 
     return rgHandle;
 }
@@ -113,11 +107,20 @@ void RenderGraph::registerBufferWrite(RGBufferHandle handle, uint32_t passIndex)
 }
 
 RHITextureHandle RenderGraph::getRHITexture(RGTextureHandle handle) const {
-    const RGTexture& texture = m_textures[handle];
+    // Hot path during execute: handles come from this graph, validated in debug only
+    const RGTexture& texture = m_textures.get_unchecked(handle);
     return texture.rhiHandle;
 }
 
-RHITextureHandle RenderGraph::getRHITexture(const std::string& name) const {
+RHITextureHandle RenderGraph::getRHITexture(std::string_view name) const {
+    auto it = m_textureNameMap.find(name);
+    if (it != m_textureNameMap.end()) {
+        return getRHITexture(it->second);
+    }
+    return RHI_INVALID_TEXTURE_HANDLE;
+}
+
+RHITextureHandle RenderGraph::getRHITexture(interned_name name) const {
     auto it = m_textureNameMap.find(name);
     if (it != m_textureNameMap.end()) {
         return getRHITexture(it->second);
@@ -126,11 +129,19 @@ RHITextureHandle RenderGraph::getRHITexture(const std::string& name) const {
 }
 
 RHIBufferHandle RenderGraph::getRHIBuffer(RGBufferHandle handle) const {
-    const RGBuffer& buffer = m_buffers[handle];
+    const RGBuffer& buffer = m_buffers.get_unchecked(handle);
     return buffer.rhiHandle;
 }
 
-RHIBufferHandle RenderGraph::getRHIBuffer(const std::string& name) const {
+RHIBufferHandle RenderGraph::getRHIBuffer(std::string_view name) const {
+    auto it = m_bufferNameMap.find(name);
+    if (it != m_bufferNameMap.end()) {
+        return getRHIBuffer(it->second);
+    }
+    return RHI_INVALID_BUFFER_HANDLE;
+}
+
+RHIBufferHandle RenderGraph::getRHIBuffer(interned_name name) const {
     auto it = m_bufferNameMap.find(name);
     if (it != m_bufferNameMap.end()) {
         return getRHIBuffer(it->second);
@@ -204,18 +215,20 @@ void RenderGraph::buildDependencyGraph() {
     // - A writes to a resource that B reads
     // - A writes to a resource that B writes (WAW dependency)
 
+    // Read/write lists live in m_scratch, rewound per pass, so the O(n^2) scan stays off the heap
     for (size_t i = 0; i < passCount; ++i) {
+        m_scratch.reset();
         const RenderPass* passA = m_passes[i].get();
-        auto textureWrites = passA->getTextureWrites();
-        auto bufferWrites = passA->getBufferWrites();
+        auto textureWrites = passA->getTextureWrites(m_scratch.resource());
+        auto bufferWrites = passA->getBufferWrites(m_scratch.resource());
 
         // Check all later passes
         for (size_t j = i + 1; j < passCount; ++j) {
             const RenderPass* passB = m_passes[j].get();
-            auto textureReads = passB->getTextureReads();
-            auto textureWritesB = passB->getTextureWrites();
-            auto bufferReads = passB->getBufferReads();
-            auto bufferWritesB = passB->getBufferWrites();
+            auto textureReads = passB->getTextureReads(m_scratch.resource());
+            auto textureWritesB = passB->getTextureWrites(m_scratch.resource());
+            auto bufferReads = passB->getBufferReads(m_scratch.resource());
+            auto bufferWritesB = passB->getBufferWrites(m_scratch.resource());
 
             bool hasDependency = false;
 
@@ -304,16 +317,14 @@ void RenderGraph::cullUnusedPasses() {
 void RenderGraph::allocateResources() {
     // Allocate physical RHI resources for all transient resources
 
-    for (RGTextureHandle handle : m_allTextureHandles) {
-        RGTexture& texture = m_textures[handle];
+    for (RGTexture& texture : m_textures) {
         if (!texture.isImported) {
             // Create the actual RHI texture
             texture.rhiHandle = m_device->createTexture(texture.desc);
         }
     }
 
-    for (RGBufferHandle handle : m_allBufferHandles) {
-        RGBuffer& buffer = m_buffers[handle];
+    for (RGBuffer& buffer : m_buffers) {
         if (!buffer.isImported) {
             // Create the actual RHI buffer
             buffer.rhiHandle = m_device->createBuffer(buffer.desc);
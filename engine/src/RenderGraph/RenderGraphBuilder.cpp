@@ -14,28 +14,28 @@ RGTextureHandle RenderGraphBuilder::createTexture(const std::string& name, const
     if (!m_graph) {
         return RG_INVALID_TEXTURE;
     }
-    return m_graph->createTexture(name, desc);
+    return m_graph->createTexture(interned_name(name), desc);
 }
 
 RGBufferHandle RenderGraphBuilder::createBuffer(const std::string& name, const RHIBufferCreateDesc& desc) {
     if (!m_graph) {
         return RG_INVALID_BUFFER;
     }
-    return m_graph->createBuffer(name, desc);
+    return m_graph->createBuffer(interned_name(name), desc);
 }
 
 RGTextureHandle RenderGraphBuilder::importTexture(const std::string& name, RHITextureHandle handle) {
     if (!m_graph) {
         return RG_INVALID_TEXTURE;
     }
-    return m_graph->importTexture(name, handle);
+    return m_graph->importTexture(interned_name(name), handle);
 }
 
 RGBufferHandle RenderGraphBuilder::importBuffer(const std::string& name, RHIBufferHandle handle) {
     if (!m_graph) {
         return RG_INVALID_BUFFER;
     }
-    return m_graph->importBuffer(name, handle);
+    return m_graph->importBuffer(interned_name(name), handle);
 }
 
 void RenderGraphBuilder::readTexture(RGTextureHandle handle) {
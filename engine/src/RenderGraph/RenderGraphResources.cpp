@@ -12,7 +12,11 @@ RHITextureHandle RenderGraphResources::getTexture(RGTextureHandle handle) const
     return m_graph->getRHITexture(handle);
 }
 
-RHITextureHandle RenderGraphResources::getTexture(const std::string& name) const {
+RHITextureHandle RenderGraphResources::getTexture(std::string_view name) const {
+    return m_graph->getRHITexture(name);
+}
+
+RHITextureHandle RenderGraphResources::getTexture(interned_name name) const {
     return m_graph->getRHITexture(name);
 }
 
@@ -20,7 +24,11 @@ RHIBufferHandle RenderGraphResources::getBuffer(RGBufferHandle handle) const {
     return m_graph->getRHIBuffer(handle);
 }
 
-RHIBufferHandle RenderGraphResources::getBuffer(const std::string& name) const {
+RHIBufferHandle RenderGraphResources::getBuffer(std::string_view name) const {
+    return m_graph->getRHIBuffer(name);
+}
+
+RHIBufferHandle RenderGraphResources::getBuffer(interned_name name) const {
     return m_graph->getRHIBuffer(name);
 }
 
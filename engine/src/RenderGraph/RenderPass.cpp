@@ -14,8 +14,8 @@ void RenderPass::addDependency(ResourceDependency dep) {
     m_dependencies.push_back(dep);
 }
 
-std::vector<RGTextureHandle> RenderPass::getTextureReads() const {
-    std::vector<RGTextureHandle> reads;
+std::pmr::vector<RGTextureHandle> RenderPass::getTextureReads(std::pmr::memory_resource* resource) const {
+    std::pmr::vector<RGTextureHandle> reads(resource);
     for (const auto& dep : m_dependencies) {
         if (dep.isTexture() && (dep.accessMode == ResourceAccessMode::Read ||
                                  dep.accessMode == ResourceAccessMode::ReadWrite)) {
@@ -25,8 +25,8 @@ std::vector<RGTextureHandle> RenderPass::getTextureReads() const {
     return reads;
 }
 
-std::vector<RGTextureHandle> RenderPass::getTextureWrites() const {
-    std::vector<RGTextureHandle> writes;
+std::pmr::vector<RGTextureHandle> RenderPass::getTextureWrites(std::pmr::memory_resource* resource) const {
+    std::pmr::vector<RGTextureHandle> writes(resource);
     for (const auto& dep : m_dependencies) {
         if (dep.isTexture() && (dep.accessMode == ResourceAccessMode::Write ||
                                  dep.accessMode == ResourceAccessMode::ReadWrite)) {
@@ -36,8 +36,8 @@ std::vector<RGTextureHandle> RenderPass::getTextureWrites() const {
     return writes;
 }
 
-std::vector<RGBufferHandle> RenderPass::getBufferReads() const {
-    std::vector<RGBufferHandle> reads;
+std::pmr::vector<RGBufferHandle> RenderPass::getBufferReads(std::pmr::memory_resource* resource) const {
+    std::pmr::vector<RGBufferHandle> reads(resource);
     for (const auto& dep : m_dependencies) {
         if (dep.isBuffer() && (dep.accessMode == ResourceAccessMode::Read ||
                                 dep.accessMode == ResourceAccessMode::ReadWrite)) {
@@ -47,8 +47,8 @@ std::vector<RGBufferHandle> RenderPass::getBufferReads() const {
     return reads;
 }
 
-std::vector<RGBufferHandle> RenderPass::getBufferWrites() const {
-    std::vector<RGBufferHandle> writes;
+std::pmr::vector<RGBufferHandle> RenderPass::getBufferWrites(std::pmr::memory_resource* resource) const {
+    std::pmr::vector<RGBufferHandle> writes(resource);
     for (const auto& dep : m_dependencies) {
         if (dep.isBuffer() && (dep.accessMode == ResourceAccessMode::Write ||
                                 dep.accessMode == ResourceAccessMode::ReadWrite)) {
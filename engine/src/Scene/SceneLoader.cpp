@@ -3,6 +3,7 @@
 #include "ECS/Component.hpp"
 #include "Content/MeshFormat.hpp"
 #include "Importer/MeshImporter.hpp"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
@@ -27,6 +28,13 @@ namespace RenderToy
     {
         LOG_INFO(LOG_SCENE, "Loading scene with {} entities", scene.entities.size());
 
+        // one mesh + material set per render object, reserve once up front
+        auto renderObjectCount = std::ranges::count_if(scene.entities,
+            [](const auto& desc){ return desc.hasRenderObject(); });
+        meshMgr_.reserve(renderObjectCount);
+        materialSetMgr_.reserve(renderObjectCount);
+        loadedEntities_.reserve(loadedEntities_.size() + scene.entities.size());
+
         for(const auto& entityDesc : scene.entities){
             EntityID id = createEntity(entityDesc);
             loadedEntities_.push_back(id);
@@ -207,7 +215,7 @@ namespace RenderToy
 
             // Create key for material
             MaterialKey materialKey{
-                .canonicalPath = std::filesystem::weakly_canonical(filePath).string(),
+                .canonicalPath = interned_name(std::filesystem::weakly_canonical(filePath).string()),
                 .materialIndex = i
             };
 
@@ -220,7 +228,7 @@ namespace RenderToy
 
         // Create key for mesh
         MeshKey meshKey{
-            .canonicalPath = std::filesystem::weakly_canonical(filePath).string()
+            .canonicalPath = interned_name(std::filesystem::weakly_canonical(filePath).string())
         };
 
         auto meshHandle = meshMgr_.insert(meshKey, std::move(mesh));
@@ -230,7 +238,7 @@ namespace RenderToy
 
         // Create key for material set
         MaterialSetKey materialSetKey{
-            .canonicalPath = std::filesystem::weakly_canonical(filePath).string()
+            .canonicalPath = interned_name(std::filesystem::weakly_canonical(filePath).string())
         };
 
         auto materialSetHandle = materialSetMgr_.insert(materialSetKey, std::move(materialSet));
@@ -1,4 +1,5 @@
 #include <print>
+#include "job_system.hpp"
 #include "Engine.hpp"
 #include "IGame.hpp"
 #include "ECS/AnimationSystem.hpp"
@@ -280,6 +281,9 @@ namespace RenderToy
 
         timer.reset();
 
+        // the pool World runs systems on; this thread pumps its main-thread jobs
+        auto& jobs = job_system::shared();
+
         bool isRunning = true;
         while(isRunning && !window.getShouldClose()){
             window.pumpEvents([&](const WindowEvent& event){
@@ -290,6 +294,7 @@ namespace RenderToy
                     swapchain->resize(event.width, event.height);
                 }
             });
+            jobs.run_main_jobs();
 
             timer.newFrame();
 
@@ -0,0 +1,59 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "ECS/ArchetypeColumns.hpp"
+#include "ECS/EntityRegistry.hpp"
+#include "ECSTestHelpers.hpp"
+
+using namespace RenderToy;
+using namespace RenderToy::test;
+
+TEST(ArchetypeColumns, ColumnLayoutFollowsBitOrder){
+    constexpr auto bit = TRANSFORM_BIT | COLOR_BIT | RIGIDBODY_BIT;
+    static_assert(column_count_of(bit) == 4);
+    static_assert(column_of<Transform>(bit) == 1);
+    static_assert(column_of<Color>(bit) == 2);
+    static_assert(column_of<Rigidbody>(bit) == 3);
+    static_assert(column_of<Camera>(bit) == Index(-1));
+
+    auto sizes = column_sizes_of(bit);
+    ASSERT_EQ(sizes.size(), 4u);
+    EXPECT_EQ(sizes[0], sizeof(EntityID));
+    EXPECT_EQ(sizes[2], sizeof(Color));
+
+    size_t total = 0;
+    for(auto size: sizes)
+        total += size;
+    EXPECT_EQ(total, size_of(bit));
+}
+
+TEST(ArchetypeColumns, EmplaceAnyOrderAndSwapRemove){
+    ArchetypeColumns columns(TRANSFORM_BIT | COLOR_BIT);
+    for(EntityID id=0; id<3; ++id)
+        columns.emplace(id, makeColor(float(id)), makeTransform(float(id)*10.0f));
+
+    ASSERT_EQ(columns.size(), 3u);
+    EXPECT_EQ(columns.column<Transform>()[2].position[0], 20.0f);
+    EXPECT_EQ(columns.column<Color>()[1].color[0], 1.0f);
+
+    columns.swap_remove(0);
+    ASSERT_EQ(columns.size(), 2u);
+    EXPECT_EQ(columns.entities()[0], 2u);
+    EXPECT_EQ(columns.column<Transform>()[0].position[0], 20.0f);
+    EXPECT_EQ(columns.column<Color>()[0].color[0], 2.0f);
+}
+
+TEST(ArchetypeColumns, RoundTripsAoSChunk){
+    constexpr auto bit = TRANSFORM_BIT | COLOR_BIT;
+    dynamic_vector chunks(size_of(bit));
+    chunks.emplace(EntityID(7), makeTransform(3.0f), makeColor(0.5f));
+
+    ArchetypeColumns columns(bit);
+    columns.emplace_chunk(chunks[0]);
+    EXPECT_EQ(columns.entities()[0], 7u);
+    EXPECT_EQ(columns.column<Transform>()[0].position[0], 3.0f);
+    EXPECT_EQ(columns.column<Color>()[0].color[0], 0.5f);
+
+    std::vector<uint8_t> chunk(size_of(bit));
+    columns.copy_chunk(0, chunk.data());
+    EXPECT_EQ(std::memcmp(chunk.data(), chunks[0], size_of(bit)), 0);
+}
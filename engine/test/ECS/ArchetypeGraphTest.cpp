@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "ECS/ArchetypeGraph.hpp"
+#include "ECS/EntityRegistry.hpp"
+#include "ECSTestHelpers.hpp"
+
+using namespace RenderToy;
+using namespace RenderToy::test;
+
+TEST(ArchetypeGraph, LayoutMatchesOffsetOf){
+    constexpr auto bit = TRANSFORM_BIT | COLOR_BIT | RIGIDBODY_BIT;
+    Archetype archetype(bit);
+
+    EXPECT_EQ(archetype.bit(), bit);
+    EXPECT_EQ(archetype.chunkSize(), size_of(bit));
+    EXPECT_EQ(archetype.offset<Transform>(), offset_of<Transform>(bit));
+    EXPECT_EQ(archetype.offset<Color>(), offset_of<Color>(bit));
+    EXPECT_EQ(archetype.offset<Rigidbody>(), offset_of<Rigidbody>(bit));
+    EXPECT_TRUE(archetype.has<Color>());
+    EXPECT_FALSE(archetype.has<Camera>());
+    EXPECT_EQ(archetype.offset<Camera>(), Archetype::NONE);
+}
+
+TEST(ArchetypeGraph, EdgesAreCachedBothWays){
+    ArchetypeGraph graph;
+    auto& transform = graph.get(TRANSFORM_BIT);
+    EXPECT_EQ(&graph.get(TRANSFORM_BIT), &transform);
+
+    const auto& add = graph.addEdge(transform, COLOR_BIT);
+    ASSERT_NE(add.target, nullptr);
+    EXPECT_EQ(add.target->bit(), TRANSFORM_BIT | COLOR_BIT);
+    EXPECT_EQ(&graph.addEdge(transform, COLOR_BIT), &add);
+    EXPECT_EQ(graph.size(), 2u);
+
+    // linking one direction links the other
+    const auto& remove = graph.removeEdge(*add.target, COLOR_BIT);
+    EXPECT_EQ(remove.target, &transform);
+    EXPECT_EQ(graph.size(), 2u);
+
+    EXPECT_EQ(graph.find(COLOR_BIT), nullptr);
+    auto color = graph.removeEdge(*add.target, TRANSFORM_BIT).target;
+    EXPECT_EQ(color, graph.find(COLOR_BIT));
+    EXPECT_EQ(color->bit(), COLOR_BIT);
+}
+
+TEST(ArchetypeGraph, MoveAlongEdgeKeepsData){
+    ArchetypeGraph graph;
+    // Color lands between Transform and Rigidbody, so both copy runs are used
+    auto& from = graph.get(TRANSFORM_BIT | RIGIDBODY_BIT);
+    auto index = from.allocate(1);
+    *static_cast<EntityID*>(from.chunk(index)) = 7;
+    from.get<Transform>(index) = makeTransform(1.0f);
+    from.get<Rigidbody>(index).mass = 3.0f;
+
+    const auto& add = graph.addEdge(from, COLOR_BIT);
+    auto added = from.moveTo(add, index, 1);
+    auto& to = *add.target;
+    *static_cast<Color*>(ptrAdd(to.chunk(added), add.componentOffset)) = makeColor(0.5f);
+
+    EXPECT_EQ(*static_cast<EntityID*>(to.chunk(added)), 7u);
+    EXPECT_EQ(to.get<Transform>(added).position.x, 1.0f);
+    EXPECT_EQ(to.get<Color>(added).color.x, 0.5f);
+    EXPECT_EQ(to.get<Rigidbody>(added).mass, 3.0f);
+
+    const auto& remove = graph.removeEdge(to, COLOR_BIT);
+    EXPECT_EQ(remove.target, &from);
+    auto back = to.moveTo(remove, added, 1);
+    EXPECT_EQ(back, 1u);
+    EXPECT_EQ(*static_cast<EntityID*>(from.chunk(back)), 7u);
+    EXPECT_EQ(from.get<Transform>(back).position.x, 1.0f);
+    EXPECT_EQ(from.get<Rigidbody>(back).mass, 3.0f);
+}
+
+TEST(ArchetypeGraph, RegistryEntitiesPointAtTheirArchetype){
+    EntityRegistry registry;
+    auto a = registry.createEntity(makeTransform(1.0f));
+    auto b = registry.createEntity(makeTransform(2.0f));
+
+    registry.appendComponent(a, makeColor(0.25f));
+    EXPECT_EQ(registry.query(a).bit, TRANSFORM_BIT | COLOR_BIT);
+    EXPECT_EQ(std::get<0>(registry.query<Transform>(b)).position.x, 2.0f);
+
+    registry.removeComponent<Color>(a);
+    registry.appendComponent(a, makeColor(0.75f));
+    auto [tc, cc] = registry.query<Transform, Color>(a);
+    EXPECT_EQ(tc.position.x, 1.0f);
+    EXPECT_EQ(cc.color.x, 0.75f);
+    EXPECT_EQ(cc.entity, a);
+}
+
+TEST(ArchetypeGraph, ChunkBlockStaysCacheLineAligned){
+    Archetype archetype(TRANSFORM_BIT | RIGIDBODY_BIT);
+    // small block, then one past the huge page threshold
+    for(auto rows: {size_t(16), (size_t(4) << 20) / archetype.chunkSize()}){
+        archetype.chunks.resize(rows);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(archetype.chunk(0)) % CACHE_LINE_SIZE, 0u);
+    }
+}
@@ -38,14 +38,14 @@ TEST(ComponentTypeRegistry, registerMultipleComponent){
     auto t_bit = t1_bit | t2_bit;
     auto chunkSize = typeRegistry.size_of(t_bit);
     auto t1_offset = typeRegistry.offset_of<TestComponent1>(t_bit);
-    auto t2_offset = typeRegistry.offset_of<TestComponent1>(t_bit);
+    auto t2_offset = typeRegistry.offset_of<TestComponent2>(t_bit);
 
     EXPECT_TRUE(t1_bit==ArchetypeBit(0b01)<<NUM_ARCHETYPES || t2_bit==ArchetypeBit(0b01)<<NUM_ARCHETYPES);
     EXPECT_TRUE(t1_bit==ArchetypeBit(0b10)<<NUM_ARCHETYPES || t2_bit==ArchetypeBit(0b10)<<NUM_ARCHETYPES);
     EXPECT_EQ(t_bit, ArchetypeBit(0b11)<<NUM_ARCHETYPES);
     EXPECT_EQ(chunkSize, sizeof(EntityID) + sizeof(TestComponent1) + sizeof(TestComponent2));
     EXPECT_TRUE(t1_offset==sizeof(EntityID) || t2_offset==sizeof(EntityID));
-    EXPECT_TRUE(t1_offset==sizeof(TestComponent2) || t2_offset==sizeof(TestComponent1));
+    EXPECT_TRUE(t1_offset==sizeof(EntityID) + sizeof(TestComponent2) || t2_offset==sizeof(EntityID) + sizeof(TestComponent1));
 }
 
 TEST(ComponentTypeRegistry, checkBuiltInComponent){
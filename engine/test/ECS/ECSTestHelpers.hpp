@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "ECS/EntityRegistry.hpp"
+
+// component factories and checks shared by the ECS tests
+namespace RenderToy::test
+{
+    inline Transform makeTransform(float x){
+        return Transform{
+            .entity = NULL_ENTITY,
+            .isActive = true,
+            .position = {x, 0.0f, 0.0f},
+            .rotation = unitQuat(),
+            .scale = ones()
+        };
+    }
+    inline Color makeColor(float r){
+        return Color{
+            .entity = NULL_ENTITY,
+            .isActive = true,
+            .color = {r, 0.0f, 0.0f, 1.0f}
+        };
+    }
+    inline Element makeElement(ElementType type){
+        return Element{.entity = NULL_ENTITY, .isActive = true, .type = type};
+    }
+
+    // every id still resolves to the chunk that stores it
+    inline void expectConsistent(EntityRegistry& registry, const std::vector<EntityID>& ids){
+        for(auto id: ids){
+            auto entity = registry.query(id);
+            ASSERT_NE(entity.chunk, nullptr);
+            EXPECT_EQ(*static_cast<EntityID*>(entity.chunk), id);
+        }
+    }
+}
@@ -0,0 +1,157 @@
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ECS/EntityCommandBuffer.hpp"
+#include "ECS/EntityRegistry.hpp"
+#include "ECSTestHelpers.hpp"
+
+using namespace RenderToy;
+using namespace RenderToy::test;
+
+namespace{
+    std::vector<EntityID> createColored(EntityRegistry& registry, int count){
+        std::vector<EntityID> ids;
+        for(int i=0; i<count; ++i)
+            ids.push_back(registry.createEntity(makeColor(float(i)), makeTransform(float(i))));
+        return ids;
+    }
+}
+
+TEST(EntityCommandBuffer, DeferredUntilPlayback){
+    EntityRegistry registry;
+    auto ids = createColored(registry, 4);
+
+    EntityCommandBuffer commands;
+    for(auto [id, bit, cc]: registry.query<Color>())
+        commands.appendComponent(id, makeElement(ElementType::FIRE));
+    EXPECT_EQ(commands.size(), 4u);
+    EXPECT_EQ(registry.query<Element>().size(), 0u);
+
+    commands.playback(registry);
+    EXPECT_TRUE(commands.empty());
+    EXPECT_EQ(registry.query<Element>().size(), 4u);
+    expectConsistent(registry, ids);
+    for(size_t i=0; i<ids.size(); ++i){
+        auto [cc, tc, ec] = registry.query<Color, Transform, Element>(ids[i]);
+        EXPECT_EQ(cc.color.x, float(i));
+        EXPECT_EQ(tc.position.x, float(i));
+        EXPECT_EQ(ec.type, ElementType::FIRE);
+        EXPECT_EQ(ec.entity, ids[i]);
+    }
+}
+
+TEST(EntityCommandBuffer, ToggleTagsKeepsData){
+    EntityRegistry registry;
+    auto ids = createColored(registry, 1000);
+
+    EntityCommandBuffer commands;
+    for(size_t i=0; i<ids.size(); i+=2)
+        commands.appendComponent(ids[i], Grounded{.entity = NULL_ENTITY, .isActive = true});
+    commands.playback(registry);
+    EXPECT_EQ(registry.query<Grounded>().size(), 500u);
+
+    // move the other way, and some entities across two groups at once
+    for(size_t i=0; i<ids.size(); i+=4)
+        commands.removeComponent<Grounded>(ids[i]);
+    for(size_t i=1; i<ids.size(); i+=4)
+        commands.appendComponent(ids[i], Grounded{.entity = NULL_ENTITY, .isActive = true});
+    for(size_t i=0; i<ids.size(); i+=10)
+        commands.removeComponent<Transform>(ids[i]);
+    commands.playback(registry);
+
+    expectConsistent(registry, ids);
+    EXPECT_EQ(registry.query<Grounded>().size(), 500u);
+    EXPECT_EQ(registry.query<Transform>().size(), 900u);
+    for(size_t i=0; i<ids.size(); ++i){
+        auto [cc, grounded] = registry.query_safe<Color>(ids[i]);
+        EXPECT_EQ(cc.color.x, float(i));
+        EXPECT_EQ(registry.query_safe<Grounded>(ids[i]).second, i % 4 == 1 || i % 4 == 2);
+    }
+}
+
+TEST(EntityCommandBuffer, CreateAndDestroy){
+    EntityRegistry registry;
+    auto ids = createColored(registry, 10);
+
+    EntityCommandBuffer commands;
+    for(size_t i=0; i<ids.size(); i+=3)
+        commands.destroyEntity(ids[i]);
+    for(int i=0; i<5; ++i)
+        commands.createEntity(makeElement(ElementType::ICE), makeColor(100.0f + i));
+    commands.playback(registry);
+
+    EXPECT_EQ(registry.query<Color>().size(), 10u - 4u + 5u);
+    for(size_t i=0; i<ids.size(); ++i){
+        if(i % 3 == 0)
+            EXPECT_EQ(registry.query(ids[i]).chunk, nullptr);
+        else
+            EXPECT_EQ(std::get<0>(registry.query<Color>(ids[i])).color.x, float(i));
+    }
+
+    size_t created = 0;
+    for(auto [id, bit, cc, ec]: registry.query<Color, Element>()){
+        EXPECT_NE(id, NULL_ENTITY);
+        EXPECT_EQ(cc.entity, id);
+        EXPECT_EQ(ec.entity, id);
+        EXPECT_EQ(ec.type, ElementType::ICE);
+        EXPECT_GE(cc.color.x, 100.0f);
+        ++created;
+    }
+    EXPECT_EQ(created, 5u);
+}
+
+TEST(EntityCommandBuffer, CommandsFoldPerEntity){
+    EntityRegistry registry;
+    auto ids = createColored(registry, 3);
+
+    EntityCommandBuffer commands;
+    // appended then removed: no move at all
+    commands.appendComponent(ids[0], makeElement(ElementType::FIRE));
+    commands.removeComponent<Element>(ids[0]);
+    // removed then appended again: the new value wins
+    commands.removeComponent<Color>(ids[1]);
+    commands.appendComponent(ids[1], makeColor(42.0f));
+    // destroyed: later commands are dropped
+    commands.destroyEntity(ids[2]);
+    commands.appendComponent(ids[2], makeElement(ElementType::WIND));
+    // stale ids are skipped
+    commands.destroyEntity(make_entity(999, 1));
+    commands.playback(registry);
+
+    EXPECT_EQ(registry.query<Element>().size(), 0u);
+    EXPECT_EQ(std::get<0>(registry.query<Color>(ids[0])).color.x, 0.0f);
+    EXPECT_EQ(std::get<0>(registry.query<Color>(ids[1])).color.x, 42.0f);
+    EXPECT_EQ(std::get<0>(registry.query<Color>(ids[1])).entity, ids[1]);
+    EXPECT_EQ(registry.query(ids[2]).chunk, nullptr);
+    expectConsistent(registry, {ids[0], ids[1]});
+}
+
+TEST(EntityCommandBuffer, RecordFromManyThreads){
+    constexpr size_t THREADS = 4;
+    EntityRegistry registry;
+    auto ids = createColored(registry, 4000);
+
+    EntityCommandBuffer commands;
+    std::vector<std::thread> threads;
+    for(size_t t=0; t<THREADS; ++t){
+        threads.emplace_back([&, t]{
+            for(size_t i=t; i<ids.size(); i+=THREADS)
+                commands.appendComponent(ids[i], Collided{.entity = NULL_ENTITY, .isActive = true});
+            if(t == 0)
+                commands.createEntity(makeColor(-1.0f));
+        });
+    }
+    for(auto& thread: threads)
+        thread.join();
+    EXPECT_EQ(commands.size(), ids.size() + 1);
+
+    commands.playback(registry);
+    EXPECT_EQ(registry.query<Collided>().size(), ids.size());
+    EXPECT_EQ(registry.query<Color>().size(), ids.size() + 1);
+    expectConsistent(registry, ids);
+
+    // streams survive playback: record and play again
+    commands.removeComponent<Collided>(ids[0]);
+    commands.playback(registry);
+    EXPECT_EQ(registry.query<Collided>().size(), ids.size() - 1);
+}
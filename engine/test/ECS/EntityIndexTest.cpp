@@ -0,0 +1,108 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include "ECS/EntityIndex.hpp"
+#include "ECS/EntityRegistry.hpp"
+
+using namespace RenderToy;
+
+static_assert(entity_index(make_entity(42, 3)) == 42);
+static_assert(entity_generation(make_entity(42, 3)) == 3);
+static_assert(make_entity(0, 1) != NULL_ENTITY);
+static_assert(entity_generation(make_entity(MAX_ENTITY_COUNT - 1, EntityIndex::MAX_GENERATION)) == EntityIndex::MAX_GENERATION);
+
+TEST(EntityIndex, CreateFindDestroy){
+    EntityIndex index;
+    Archetype color(COLOR_BIT);
+    EXPECT_FALSE(index.contains(NULL_ENTITY));
+
+    auto a = index.create({.archetype = nullptr, .chunkIndex = 10});
+    auto b = index.create({.archetype = &color, .chunkIndex = 20});
+    EXPECT_NE(a, b);
+    EXPECT_NE(a, NULL_ENTITY);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.at(a).chunkIndex, 10u);
+    EXPECT_EQ(index.find(b)->archetype, &color);
+
+    index.destroy(a);
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_EQ(index.find(a), nullptr);
+    EXPECT_THROW(index.at(a), std::out_of_range);
+    EXPECT_EQ(index.at(b).chunkIndex, 20u);
+
+    // destroying a stale id is a no-op
+    index.destroy(a);
+    EXPECT_EQ(index.size(), 1u);
+}
+
+TEST(EntityIndex, RecycledSlotRejectsStaleID){
+    EntityIndex index;
+    auto stale = index.create({.archetype = nullptr, .chunkIndex = 0});
+    index.destroy(stale);
+
+    auto fresh = index.create({.archetype = nullptr, .chunkIndex = 7});
+    EXPECT_EQ(entity_index(fresh), entity_index(stale));
+    EXPECT_NE(entity_generation(fresh), entity_generation(stale));
+    EXPECT_FALSE(index.contains(stale));
+    EXPECT_EQ(index.at(fresh).chunkIndex, 7u);
+}
+
+TEST(EntityIndex, RecyclesOldestFreedFirst){
+    EntityIndex index;
+    std::vector<EntityID> ids;
+    for(Index i=0; i<4; ++i)
+        ids.push_back(index.create({.archetype = nullptr, .chunkIndex = i}));
+    index.destroy(ids[2]);
+    index.destroy(ids[0]);
+
+    EXPECT_EQ(entity_index(index.create({})), entity_index(ids[2]));
+    EXPECT_EQ(entity_index(index.create({})), entity_index(ids[0]));
+    EXPECT_EQ(entity_index(index.create({})), 4u);
+}
+
+TEST(EntityIndex, SaturatedSlotRetires){
+    EntityIndex index(3);
+    auto first = index.create({});
+    std::vector<EntityID> issued{first};
+    for(int i=0; i<2; ++i){
+        index.destroy(issued.back());
+        issued.push_back(index.create({}));
+        EXPECT_EQ(entity_index(issued.back()), entity_index(first));
+    }
+    EXPECT_EQ(entity_generation(issued.back()), 3u);
+
+    // generation 3 is the last: the slot is never handed out again
+    index.destroy(issued.back());
+    auto next = index.create({});
+    EXPECT_NE(entity_index(next), entity_index(first));
+    for(auto id: issued)
+        EXPECT_FALSE(index.contains(id));
+}
+
+TEST(EntityIndex, InfoStableAcrossGrowth){
+    EntityIndex index;
+    Archetype transform(TRANSFORM_BIT);
+    auto id = index.create({.archetype = &transform, .chunkIndex = 1});
+    auto& info = index.at(id);
+    for(Index i=0; i<100'000; ++i)
+        index.create({.archetype = nullptr, .chunkIndex = i});
+    EXPECT_EQ(&info, &index.at(id));
+    EXPECT_EQ(info.archetype, &transform);
+}
+
+TEST(EntityRegistry, DestroyedIDIsStale){
+    EntityRegistry registry;
+    auto color = Color{
+        .entity = NULL_ENTITY,
+        .isActive = true,
+        .color = {1.0f, 0.0f, 0.0f, 1.0f}
+    };
+    auto stale = registry.createEntity(color);
+    registry.destroyEntity(stale);
+
+    auto fresh = registry.createEntity(color);
+    EXPECT_EQ(entity_index(fresh), entity_index(stale));
+    EXPECT_EQ(registry.query(stale).chunk, nullptr);
+    EXPECT_NE(registry.query(fresh).chunk, nullptr);
+    EXPECT_THROW(registry.query<Color>(stale), std::out_of_range);
+    EXPECT_EQ(std::get<0>(registry.query<Color>(fresh)).entity, fresh);
+}
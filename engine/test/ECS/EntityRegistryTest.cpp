@@ -1,7 +1,10 @@
+#include <vector>
 #include <gtest/gtest.h>
 #include "ECS/EntityRegistry.hpp"
+#include "ECSTestHelpers.hpp"
 
 using namespace RenderToy;
+using namespace RenderToy::test;
 
 TEST(ArchetypeView, TrivialSize){
     EntityRegistry registry;
@@ -307,3 +310,45 @@ TEST(ArchetypeView, RemoveComponent){
     }
     EXPECT_EQ(count, 3);
 }
+
+TEST(EntityRegistry, DestroyRelinksSwappedEntity){
+    EntityRegistry registry;
+    std::vector<EntityID> ids;
+    for(int i=0; i<8; ++i)
+        ids.push_back(registry.createEntity(makeColor(float(i))));
+
+    // front of the archetype: the last chunk is moved into its slot
+    registry.destroyEntity(ids[0]);
+    ids.erase(ids.begin());
+    expectConsistent(registry, ids);
+    EXPECT_EQ(std::get<0>(registry.query<Color>(ids.back())).color.x, 7.0f);
+
+    // the last chunk itself: nothing moves
+    registry.destroyEntity(ids.back());
+    ids.pop_back();
+    expectConsistent(registry, ids);
+    EXPECT_EQ(registry.query<Color>().size(), ids.size());
+}
+
+TEST(EntityRegistry, StructuralChangesKeepLocations){
+    EntityRegistry registry;
+    std::vector<EntityID> ids;
+    for(int i=0; i<64; ++i)
+        ids.push_back(registry.createEntity(makeColor(float(i))));
+
+    for(size_t i=0; i<ids.size(); i+=2)
+        registry.appendComponent(ids[i], Element{
+            .entity = ids[i],
+            .isActive = true,
+            .type = ElementType::ICE
+        });
+    expectConsistent(registry, ids);
+
+    for(size_t i=0; i<ids.size(); i+=4)
+        registry.removeComponent<Element>(ids[i]);
+    expectConsistent(registry, ids);
+
+    for(size_t i=0; i<ids.size(); ++i)
+        EXPECT_EQ(std::get<0>(registry.query<Color>(ids[i])).color.x, float(i));
+    EXPECT_EQ(registry.query<Element>().size(), 16u);
+}
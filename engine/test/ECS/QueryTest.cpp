@@ -0,0 +1,331 @@
+#include <mutex>
+#include <set>
+#include <utility>
+#include <gtest/gtest.h>
+#include "job_system.hpp"
+#include "ECS/EntityRegistry.hpp"
+#include "ECS/Query.hpp"
+#include "ECSTestHelpers.hpp"
+
+using namespace RenderToy;
+using namespace RenderToy::test;
+
+TEST(Query, DefaultIsEmpty){
+    Query<Transform> query;
+    EXPECT_EQ(query.size(), 0u);
+    EXPECT_TRUE(query.begin() == query.end());
+}
+
+TEST(Query, PicksUpArchetypesCreatedLater){
+    EntityRegistry registry;
+    auto query = registry.makeQuery<Transform, Color>();
+    registry.createEntity(makeColor(0.0f));
+    EXPECT_EQ(query.size(), 0u);
+
+    registry.createEntity(makeTransform(1.0f), makeColor(0.5f));
+    registry.createEntity(makeTransform(2.0f));
+    auto tagged = registry.createEntity(makeTransform(3.0f), makeColor(0.25f));
+    registry.appendComponent(tagged, Grounded{.entity = 0, .isActive = true});
+
+    EXPECT_EQ(query.size(), 2u);
+    ASSERT_EQ(query.archetypes().size(), 2u);
+    for(const auto& match: query.archetypes())
+        EXPECT_TRUE(isSubset(TRANSFORM_BIT | COLOR_BIT, match.archetype->bit()));
+
+    float sum = 0.0f;
+    for(auto [id, bit, tc, cc]: query){
+        EXPECT_EQ(tc.entity, id);
+        EXPECT_EQ(cc.entity, id);
+        EXPECT_TRUE(isSubset(TRANSFORM_BIT | COLOR_BIT, bit));
+        sum += tc.position.x;
+    }
+    EXPECT_EQ(sum, 4.0f);
+}
+
+TEST(Query, OffsetsFollowQueryOrder){
+    EntityRegistry registry;
+    registry.createEntity(makeTransform(1.0f), makeColor(0.5f));
+
+    auto query = registry.makeQuery<Color, Transform>();
+    ASSERT_EQ(query.archetypes().size(), 1u);
+    const auto& match = query.archetypes()[0];
+    auto bit = TRANSFORM_BIT | COLOR_BIT;
+    EXPECT_EQ(match.offsets[0], offset_of<Color>(bit));
+    EXPECT_EQ(match.offsets[1], offset_of<Transform>(bit));
+
+    for(auto [id, bit, cc, tc]: query){
+        EXPECT_EQ(cc.color.x, 0.5f);
+        EXPECT_EQ(tc.position.x, 1.0f);
+    }
+}
+
+TEST(Query, RegistryQueryIsCached){
+    EntityRegistry registry;
+    registry.createEntity(makeTransform(1.0f));
+    EXPECT_EQ(registry.query<Transform>().size(), 1u);
+
+    // a new archetype after the first call still shows up
+    registry.createEntity(makeTransform(2.0f), makeColor(0.5f));
+    EXPECT_EQ(registry.query<Transform>().size(), 2u);
+
+    const auto view = registry.query<Transform>();
+    size_t count = 0;
+    for(auto [id, bit, tc]: view){
+        static_assert(std::is_same_v<decltype(tc), const Transform&>);
+        ++count;
+    }
+    EXPECT_EQ(count, 2u);
+}
+
+TEST(Query, ChunksAreStridedColumns){
+    EntityRegistry registry;
+    for(int i=0; i<10; ++i)
+        registry.createEntity(makeTransform(float(i)), makeColor(float(i) * 0.5f));
+    for(int i=0; i<5; ++i)
+        registry.createEntity(makeTransform(100.0f));
+    registry.createEntity(makeColor(-1.0f));
+
+    auto query = registry.makeQuery<Transform>();
+    size_t rows = 0;
+    for(const auto& chunk: query.view().chunks()){
+        auto transforms = chunk.column<Transform>();
+        ASSERT_EQ(transforms.size(), chunk.size());
+        EXPECT_EQ(transforms.stride(), size_of(chunk.bit));
+        for(Index i=0; i<chunk.size(); ++i)
+            EXPECT_EQ(transforms[i].entity, chunk.entities[i]);
+        rows += chunk.size();
+    }
+    EXPECT_EQ(rows, 15u);
+
+    // writes through a column land in the registry
+    registry.query<Transform, Color>().forEachChunk([](auto entities, auto transforms, auto colors){
+        for(Index i=0; i<entities.size(); ++i)
+            transforms[i].position.y = colors[i].color.x;
+    });
+    for(auto [id, bit, tc, cc]: registry.query<Transform, Color>())
+        EXPECT_EQ(tc.position.y, cc.color.x);
+
+    const auto view = registry.query<Transform>();
+    float sum = 0.0f;
+    view.forEachChunk([&](auto, auto transforms){
+        static_assert(std::is_same_v<decltype(transforms), strided_span<const Transform>>);
+        for(const auto& transform: transforms)
+            sum += transform.position.x;
+    });
+    EXPECT_EQ(sum, 45.0f + 500.0f);
+}
+
+TEST(Query, ParallelForEachVisitsEveryEntityOnce){
+    EntityRegistry registry;
+    for(int i=0; i<1000; ++i){
+        auto id = registry.createEntity(makeTransform(float(i)));
+        if(i % 3 == 0)
+            registry.appendComponent(id, makeColor(0.0f));
+    }
+
+    job_system jobs(3);
+    registry.query<Transform>().parallelForEach([](EntityID, Transform& transform){
+        transform.position.y += 1.0f;
+    }, 64, jobs);
+
+    for(auto [id, bit, tc]: registry.query<Transform>())
+        EXPECT_EQ(tc.position.y, 1.0f);
+}
+
+TEST(Query, ParallelRangesIgnoreThreadCount){
+    EntityRegistry registry;
+    for(int i=0; i<700; ++i){
+        auto id = registry.createEntity(makeTransform(float(i)));
+        if(i % 2)
+            registry.appendComponent(id, makeColor(0.0f));
+    }
+
+    auto rangesOf = [&](job_system& jobs){
+        std::mutex mutex;
+        std::set<std::pair<EntityID, size_t>> ranges;
+        registry.query<Transform>().parallelForEachChunk([&](auto entities, auto transforms){
+            EXPECT_EQ(entities.size(), transforms.size());
+            std::lock_guard lock(mutex);
+            ranges.emplace(entities.front(), entities.size());
+        }, 100, jobs);
+        return ranges;
+    };
+    job_system serial(0);
+    job_system parallel(4);
+    auto expected = rangesOf(serial);
+    // two archetypes of 350 rows: 4 ranges each
+    EXPECT_EQ(expected.size(), 8u);
+    EXPECT_EQ(rangesOf(parallel), expected);
+}
+
+namespace{
+    template<typename Q>
+    std::set<EntityID> entitiesOf(Q& query){
+        std::set<EntityID> ids;
+        for(auto row: query)
+            ids.insert(std::get<0>(row));
+        return ids;
+    }
+}
+
+TEST(Query, ChangedReportsWritesSinceLastView){
+    EntityRegistry registry;
+    std::vector<EntityID> ids;
+    for(int i=0; i<1000; ++i)
+        ids.push_back(registry.createEntity(makeTransform(float(i))));
+
+    auto changed = registry.makeQuery<const Transform, Changed<Transform>>();
+    // everything is new to a fresh query, then nothing is
+    EXPECT_EQ(changed.size(), 1000u);
+    EXPECT_EQ(entitiesOf(changed).size(), 1000u);
+    EXPECT_EQ(changed.size(), 0u);
+    EXPECT_TRUE(entitiesOf(changed).empty());
+
+    // reading doesn't mark, writing does
+    auto [read] = registry.query<const Transform>(ids[10]);
+    EXPECT_EQ(read.position.x, 10.0f);
+    std::get<0>(registry.query<Transform>(ids[3])).position.y = 1.0f;
+    std::get<0>(registry.query<Transform>(ids[700])).position.y = 1.0f;
+    EXPECT_EQ(changed.size(), 2u);
+    EXPECT_EQ(entitiesOf(changed), (std::set<EntityID>{ids[3], ids[700]}));
+    EXPECT_TRUE(entitiesOf(changed).empty());
+}
+
+TEST(Query, OwnWritesAreNotReported){
+    EntityRegistry registry;
+    for(int i=0; i<10; ++i)
+        registry.createEntity(makeTransform(float(i)));
+
+    auto writer = registry.makeQuery<Transform, Changed<Transform>>();
+    auto watcher = registry.makeQuery<const Transform, Changed<Transform>>();
+    EXPECT_EQ(entitiesOf(watcher).size(), 10u);
+
+    // the writer sees the creates once, and not its own writes after
+    for(auto [id, bit, transform]: writer)
+        transform.position.y += 1.0f;
+    EXPECT_EQ(writer.size(), 0u);
+    // other queries do see them
+    EXPECT_EQ(entitiesOf(watcher).size(), 10u);
+
+    // a const view hands out no mutable rows, so it marks nothing
+    auto reader = registry.makeQuery<Transform>();
+    const auto view = reader.view();
+    for(auto [id, bit, transform]: view){
+        EXPECT_EQ(bit, TRANSFORM_BIT);
+        EXPECT_EQ(transform.entity, id);
+    }
+    EXPECT_EQ(watcher.size(), 0u);
+}
+
+TEST(Query, ChangedSkipsUntouchedBlocks){
+    EntityRegistry registry;
+    std::vector<EntityID> ids;
+    for(int i=0; i<1000; ++i)
+        ids.push_back(registry.createEntity(makeTransform(float(i))));
+    auto changed = registry.makeQuery<const Transform, Changed<Transform>>();
+    changed.view();
+
+    std::get<0>(registry.query<Transform>(ids[700])).position.y = 1.0f;
+    std::vector<std::pair<EntityID, size_t>> chunks;
+    changed.forEachChunk([&](auto entities, auto transforms){
+        EXPECT_EQ(entities.size(), transforms.size());
+        chunks.emplace_back(entities.front(), entities.size());
+    });
+    // the block of rows [512, 768) holding it, and nothing else
+    ASSERT_EQ(chunks.size(), 1u);
+    EXPECT_EQ(chunks[0].first, ids[512]);
+    EXPECT_EQ(chunks[0].second, Archetype::TICK_BLOCK);
+
+    // writing through chunks marks the rows handed out
+    auto bodies = registry.makeQuery<Transform>();
+    bodies.view().forEachChunk([](auto, auto transforms){
+        transforms[0].position.z = 1.0f;
+    });
+    EXPECT_EQ(changed.size(), 1000u);
+}
+
+TEST(Query, EntityLoopsMarkABlockAtATime){
+    EntityRegistry registry;
+    for(int i=0; i<1000; ++i)
+        registry.createEntity(makeTransform(float(i)));
+    auto changed = registry.makeQuery<const Transform, Changed<Transform>>();
+    changed.view();
+
+    // read-only loops mark nothing
+    for(auto [id, bit, transform]: registry.query<const Transform>())
+        EXPECT_EQ(transform.entity, id);
+    EXPECT_EQ(changed.size(), 0u);
+
+    // mutable ones the whole block they enter, written or not
+    auto bodies = registry.makeQuery<Transform>();
+    for(auto [id, bit, transform]: bodies){
+        transform.position.z = 1.0f;
+        break;
+    }
+    EXPECT_EQ(changed.size(), Archetype::TICK_BLOCK);
+}
+
+TEST(Query, FiltersCombine){
+    EntityRegistry registry;
+    std::vector<EntityID> ids;
+    for(int i=0; i<4; ++i)
+        ids.push_back(registry.createEntity(makeTransform(float(i)), makeColor(0.0f)));
+    auto both = registry.makeQuery<const Transform, Changed<Transform>, Changed<Color>>();
+    EXPECT_EQ(both.size(), 4u);
+    both.view();
+
+    // only rows where every filter passes
+    std::get<0>(registry.query<Transform>(ids[0])).position.y = 1.0f;
+    std::get<0>(registry.query<Color>(ids[1])).color.x = 1.0f;
+    registry.query<Transform, Color>(ids[2]);
+    EXPECT_EQ(entitiesOf(both), (std::set<EntityID>{ids[2]}));
+}
+
+TEST(Query, AddedFollowsComponentsNotArchetypes){
+    EntityRegistry registry;
+    auto plain = registry.createEntity(makeTransform(0.0f));
+    auto colored = registry.createEntity(makeTransform(1.0f), makeColor(0.5f));
+
+    auto added = registry.makeQuery<const Color, Added<Color>>();
+    EXPECT_EQ(entitiesOf(added), (std::set<EntityID>{colored}));
+
+    // moving to another archetype keeps Color's ticks
+    registry.appendComponent(colored, Grounded{.entity = 0, .isActive = true});
+    EXPECT_TRUE(entitiesOf(added).empty());
+
+    registry.appendComponent(plain, makeColor(0.25f));
+    EXPECT_EQ(entitiesOf(added), (std::set<EntityID>{plain}));
+
+    // a swap-remove moves the last row's ticks along with it
+    auto later = registry.createEntity(makeTransform(2.0f), makeColor(0.0f));
+    registry.createEntity(makeTransform(3.0f), makeColor(0.0f));
+    added.view();
+    auto last = registry.createEntity(makeTransform(4.0f), makeColor(0.0f));
+    registry.destroyEntity(later);
+    EXPECT_EQ(entitiesOf(added), (std::set<EntityID>{last}));
+}
+
+TEST(Query, ParallelForEachFiltersRows){
+    EntityRegistry registry;
+    std::vector<EntityID> ids;
+    for(int i=0; i<2000; ++i)
+        ids.push_back(registry.createEntity(makeTransform(float(i))));
+    auto changed = registry.makeQuery<Transform, Changed<Transform>>();
+    changed.view();
+
+    std::set<EntityID> expected;
+    for(Index i=0; i<ids.size(); i+=97){
+        std::get<0>(registry.query<Transform>(ids[i])).position.y = 1.0f;
+        expected.insert(ids[i]);
+    }
+
+    job_system jobs(3);
+    std::mutex mutex;
+    std::set<EntityID> visited;
+    changed.parallelForEach([&](EntityID id, Transform& transform){
+        EXPECT_EQ(transform.position.y, 1.0f);
+        std::lock_guard lock(mutex);
+        visited.insert(id);
+    }, 64, jobs);
+    EXPECT_EQ(visited, expected);
+}
@@ -0,0 +1,69 @@
+#include <cmath>
+#include <limits>
+#include <gtest/gtest.h>
+#include "ECS/TransformSystem.hpp"
+#include "ECS/World.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    bool nearEq(const Mat4& a, const Mat4& b, float eps = 1e-5f){
+        for(int row=0; row<4; ++row)
+            for(int col=0; col<4; ++col)
+                if(std::abs(a[row][col] - b[row][col]) >= eps)
+                    return false;
+        return true;
+    }
+
+    auto makeTransform(Vec3 position, Vec4 rotation, Vec3 scale, bool isActive = true){
+        return Transform{
+            .entity = std::numeric_limits<EntityID>::max(),
+            .isActive = isActive,
+            .position = position,
+            .rotation = rotation,
+            .scale = scale
+        };
+    }
+}
+
+TEST(TransformSystem, BuildsWorldMatrices){
+    World world;
+    auto system = world.addSystem<TransformSystem>();
+
+    // more than one 4-lane block, plus a remainder
+    constexpr size_t COUNT = 7;
+    for(size_t i=0; i<COUNT; ++i){
+        world.getRegistry().createEntity(makeTransform(
+            Vec3{float(i), 2.0f, -1.0f},
+            axisAngle(normalize(Vec3{1.0f, float(i), 0.5f}), 0.3f*float(i)),
+            Vec3{1.0f + float(i), 2.0f, 0.5f}
+        ));
+    }
+    world.update(DeltaTime{});
+
+    auto entities = system->getEntities();
+    auto matrices = system->getWorldMatrices();
+    ASSERT_EQ(entities.size(), COUNT);
+    ASSERT_EQ(matrices.size(), COUNT);
+
+    for(size_t i=0; i<COUNT; ++i){
+        auto [transform] = world.getRegistry().query<Transform>(entities[i]);
+        auto expected = translateMat(transform.position)
+            * rotateMat(transform.rotation)
+            * scaleMat(transform.scale);
+        EXPECT_TRUE(nearEq(matrices[i], expected)) << i;
+    }
+}
+
+TEST(TransformSystem, SkipsInactive){
+    World world;
+    auto system = world.addSystem<TransformSystem>();
+
+    world.getRegistry().createEntity(makeTransform(zeros(), unitQuat(), ones()));
+    world.getRegistry().createEntity(makeTransform(ones(), unitQuat(), ones(), false));
+    world.update(DeltaTime{});
+
+    ASSERT_EQ(system->getWorldMatrices().size(), 1u);
+    EXPECT_TRUE(nearEq(system->getWorldMatrices()[0], unitMat()));
+}
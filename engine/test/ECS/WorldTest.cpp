@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "job_system.hpp"
+#include "ECS/AnimationSystem.hpp"
+#include "ECS/PhysicsSystem.hpp"
+#include "ECS/RenderSystem.hpp"
+#include "ECS/TransformSystem.hpp"
+#include "ECS/UISystem.hpp"
+#include "ECS/World.hpp"
+
+using namespace RenderToy;
+
+namespace
+{
+    // one system type per N, with the access the test gives it
+    template<int N>
+    class TestSystem: public ISystem{
+    public:
+        ComponentAccess access;
+        std::atomic<int> updates = 0;
+
+        explicit TestSystem(ComponentAccess access = ComponentAccess::all()):access(access){}
+
+        const char* getName() const override{ return "TestSystem"; }
+        void onUpdate(DeltaTime) override{ updates.fetch_add(1); }
+        ComponentAccess getAccess() const override{ return access; }
+    };
+
+    size_t waveOf(const World& world, const ISystem* system){
+        auto waves = world.getSystemWaves();
+        for(size_t i=0; i<waves.size(); ++i)
+            if(std::ranges::find(waves[i], system) != waves[i].end())
+                return i;
+        return size_t(-1);
+    }
+}
+
+TEST(World, AccessConflicts){
+    auto readT = ComponentAccess{}.reads<Transform>();
+    auto writeT = ComponentAccess{}.writes<Transform>();
+    auto writeR = ComponentAccess{}.reads<Transform>().writes<Rigidbody>();
+
+    EXPECT_FALSE(readT.conflictsWith(readT));
+    EXPECT_TRUE(readT.conflictsWith(writeT));
+    EXPECT_TRUE(writeT.conflictsWith(readT));
+    EXPECT_TRUE(writeT.conflictsWith(writeT));
+    EXPECT_FALSE(readT.conflictsWith(writeR));
+    EXPECT_TRUE(writeT.conflictsWith(writeR));
+    EXPECT_TRUE(ComponentAccess::all().conflictsWith(ComponentAccess{}));
+    EXPECT_FALSE(ComponentAccess{}.conflictsWith(writeT));
+    EXPECT_FALSE(ComponentAccess{}.onMainThread().conflictsWith(writeT));
+}
+
+TEST(World, ConflictingSystemsGetSeparateWaves){
+    job_system jobs(0);
+    World world(jobs);
+    auto a = world.addSystem<TestSystem<0>>(ComponentAccess{}.reads<Transform>());
+    auto b = world.addSystem<TestSystem<1>>(ComponentAccess{}.reads<Transform, Color>());
+    auto c = world.addSystem<TestSystem<2>>(ComponentAccess{}.writes<Transform>());
+    auto d = world.addSystem<TestSystem<3>>(ComponentAccess{}.writes<Rigidbody>());
+    auto e = world.addSystem<TestSystem<4>>(ComponentAccess{}.reads<Transform>());
+    world.update(DeltaTime{});
+
+    // the readers share a wave with the Rigidbody writer; the Transform
+    // writer waits for them, and the reader added after it waits for it
+    EXPECT_EQ(waveOf(world, a), 0u);
+    EXPECT_EQ(waveOf(world, b), 0u);
+    EXPECT_EQ(waveOf(world, d), 0u);
+    EXPECT_EQ(waveOf(world, c), 1u);
+    EXPECT_EQ(waveOf(world, e), 2u);
+    for(auto updates: {a->updates.load(), b->updates.load(), c->updates.load(), d->updates.load(), e->updates.load()})
+        EXPECT_EQ(updates, 1);
+}
+
+TEST(World, UndeclaredAccessRunsAlone){
+    job_system jobs(0);
+    World world(jobs);
+    auto reader = world.addSystem<TestSystem<0>>(ComponentAccess{}.reads<Transform>());
+    auto unknown = world.addSystem<TestSystem<1>>();
+    auto other = world.addSystem<TestSystem<2>>(ComponentAccess{}.reads<Color>());
+    world.update(DeltaTime{});
+
+    ASSERT_EQ(world.getSystemWaves().size(), 3u);
+    EXPECT_EQ(waveOf(world, reader), 0u);
+    EXPECT_EQ(waveOf(world, unknown), 1u);
+    EXPECT_EQ(waveOf(world, other), 2u);
+}
+
+TEST(World, ExplicitOrderIsKept){
+    job_system jobs(0);
+    World world(jobs);
+    auto ui = world.addSystem<UISystem>();
+    auto render = world.addSystem<RenderSystem>();
+    auto transform = world.addSystem<TransformSystem>();
+    auto animation = world.addSystem<AnimationSystem>();
+    auto physics = world.addSystem<PhysicsSystem>();
+    // touches nothing the engine chain writes: joins its first wave
+    auto game = world.addSystem<TestSystem<0>>(ComponentAccess{}.reads<Color>().writes<LifeSpan>());
+    world.update(DeltaTime{});
+
+    EXPECT_EQ(waveOf(world, physics), 0u);
+    EXPECT_EQ(waveOf(world, game), 0u);
+    EXPECT_EQ(waveOf(world, animation), 1u);
+    EXPECT_EQ(waveOf(world, transform), 2u);
+    EXPECT_EQ(waveOf(world, render), 3u);
+    EXPECT_EQ(waveOf(world, ui), 4u);
+}
+
+TEST(World, SystemsOfAWaveRunConcurrently){
+    // each system waits until the other one started: only passes if the
+    // wave really runs them at the same time
+    struct Rendezvous{
+        std::atomic<int> arrived = 0;
+        std::atomic<int> met = 0;
+    } rendezvous;
+
+    class MeetingSystem: public ISystem{
+    public:
+        Rendezvous* rendezvous;
+        explicit MeetingSystem(Rendezvous* rendezvous):rendezvous(rendezvous){}
+        const char* getName() const override{ return "MeetingSystem"; }
+        ComponentAccess getAccess() const override{ return reads<Transform>(); }
+        void onUpdate(DeltaTime) override{
+            rendezvous->arrived.fetch_add(1);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while(rendezvous->arrived.load() < 2 && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+            if(rendezvous->arrived.load() >= 2)
+                rendezvous->met.fetch_add(1);
+        }
+    };
+    class OtherMeetingSystem: public MeetingSystem{
+        using MeetingSystem::MeetingSystem;
+    };
+
+    job_system jobs(2);
+    World world(jobs);
+    world.addSystem<MeetingSystem>(&rendezvous);
+    world.addSystem<OtherMeetingSystem>(&rendezvous);
+    world.update(DeltaTime{});
+
+    ASSERT_EQ(world.getSystemWaves().size(), 1u);
+    EXPECT_EQ(rendezvous.met.load(), 2);
+}
+
+TEST(World, MainThreadSystemsRunOnTheMainThread){
+    class ThreadRecordingSystem: public ISystem{
+    public:
+        ComponentAccess access;
+        std::vector<std::thread::id> threads;
+        explicit ThreadRecordingSystem(ComponentAccess access):access(access){}
+        const char* getName() const override{ return "ThreadRecordingSystem"; }
+        ComponentAccess getAccess() const override{ return access; }
+        void onUpdate(DeltaTime) override{ threads.push_back(std::this_thread::get_id()); }
+    };
+    class OtherRecordingSystem: public ThreadRecordingSystem{
+        using ThreadRecordingSystem::ThreadRecordingSystem;
+    };
+
+    job_system jobs(3);
+    World world(jobs);
+    auto ui = world.addSystem<ThreadRecordingSystem>(ComponentAccess{}.onMainThread());
+    auto other = world.addSystem<OtherRecordingSystem>(ComponentAccess{}.reads<Transform>());
+    for(int i=0; i<50; ++i)
+        world.update(DeltaTime{});
+
+    // they share a wave, but only the declared one is pinned
+    ASSERT_EQ(world.getSystemWaves().size(), 1u);
+    ASSERT_EQ(ui->threads.size(), 50u);
+    EXPECT_EQ(other->threads.size(), 50u);
+    for(auto thread: ui->threads)
+        EXPECT_EQ(thread, std::this_thread::get_id());
+}